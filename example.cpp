@@ -2,6 +2,7 @@
 #include <random>
 #include <vector>
 
+#include "rmi/index.hpp"
 #include "rmi/models.hpp"
 #include "rmi/rmi.hpp"
 
@@ -36,5 +37,12 @@ int main()
     std::cout << "Key " << key << " is located at position "
               << std::distance(keys.begin(), pos) << '.' << std::endl;
 
+    // Alternatively, bind an RMI to its keys and query ranges via iterators.
+    using rmi_type = rmi::RmiLAbs<key_type, layer1_type, layer2_type>;
+    rmi::Index<key_type, rmi_type> index(keys, layer2_size);
+    auto [first, last] = index.range(key, key + (1UL << 32));
+    std::cout << "There are " << std::distance(first, last) << " keys in ["
+              << key << ',' << key + (1UL << 32) << ")." << std::endl;
+
    return 0;
 }
@@ -0,0 +1,296 @@
+#include <cmath>
+#include <random>
+
+#include "argparse/argparse.hpp"
+
+#include "rmi/util/fn.hpp"
+
+
+/**
+ * Scales the values @p v linearly such that they cover the whole domain of @p Key and converts them to keys.
+ * @tparam Key key type
+ * @param v vector of values
+ * @return vector of keys
+ */
+template<typename Key>
+std::vector<Key> scale(const std::vector<double> &v)
+{
+    auto [min, max] = std::minmax_element(v.begin(), v.end());
+    double lo = *min;
+    double range = *max - *min;
+    double domain = std::nextafter(std::ldexp(1.0, sizeof(Key) * 8), 0.0); // largest double below 2^(bits of Key)
+
+    std::vector<Key> keys;
+    keys.reserve(v.size());
+    for (auto x : v) {
+        double y = range == 0.0 ? 0.0 : (x - lo) / range * domain;
+        keys.push_back(static_cast<Key>(std::clamp(y, 0.0, domain)));
+    }
+    return keys;
+}
+
+
+/**
+ * Keys drawn uniformly from the whole domain of @p Key.
+ */
+template<typename Key>
+struct Uniform {
+    std::vector<Key> operator()(const std::size_t n_keys, std::mt19937_64 &gen) const {
+        std::uniform_int_distribution<Key> distrib;
+        std::vector<Key> keys(n_keys);
+        std::generate(keys.begin(), keys.end(), [&] { return distrib(gen); });
+        return keys;
+    }
+};
+
+
+/**
+ * Keys drawn from a normal distribution with mean 0 and standard deviation 1.
+ */
+template<typename Key>
+struct Normal {
+    std::vector<Key> operator()(const std::size_t n_keys, std::mt19937_64 &gen) const {
+        std::normal_distribution<double> distrib(0.0, 1.0);
+        std::vector<double> v(n_keys);
+        std::generate(v.begin(), v.end(), [&] { return distrib(gen); });
+        return scale<Key>(v);
+    }
+};
+
+
+/**
+ * Keys drawn from a lognormal distribution with mu 0 and sigma 2.
+ */
+template<typename Key>
+struct Lognormal {
+    std::vector<Key> operator()(const std::size_t n_keys, std::mt19937_64 &gen) const {
+        std::lognormal_distribution<double> distrib(0.0, 2.0);
+        std::vector<double> v(n_keys);
+        std::generate(v.begin(), v.end(), [&] { return distrib(gen); });
+        return scale<Key>(v);
+    }
+};
+
+
+/**
+ * Keys drawn from 1,000 narrow clusters placed uniformly at random whose sizes follow a Zipf distribution with
+ * exponent 1.
+ */
+template<typename Key>
+struct ZipfClustered {
+    std::vector<Key> operator()(const std::size_t n_keys, std::mt19937_64 &gen) const {
+        const std::size_t n_clusters = 1000;
+        const double width = 1e-5;
+
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        std::vector<double> centers(n_clusters);
+        std::vector<double> weights(n_clusters);
+        for (std::size_t i = 0; i != n_clusters; ++i) {
+            centers[i] = unit(gen);
+            weights[i] = 1.0 / (i + 1);
+        }
+        std::discrete_distribution<std::size_t> cluster(weights.begin(), weights.end());
+
+        std::vector<double> v(n_keys);
+        std::generate(v.begin(), v.end(), [&] { return centers[cluster(gen)] + width * unit(gen); });
+        return scale<Key>(v);
+    }
+};
+
+
+/**
+ * Keys drawn from a piecewise linear CDF with 16 pieces of random width and random density.
+ */
+template<typename Key>
+struct PiecewiseLinear {
+    std::vector<Key> operator()(const std::size_t n_keys, std::mt19937_64 &gen) const {
+        const std::size_t n_pieces = 16;
+
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        std::exponential_distribution<double> density(1.0);
+        std::vector<double> breakpoints(n_pieces + 1);
+        std::generate(breakpoints.begin(), breakpoints.end(), [&] { return unit(gen); });
+        breakpoints.front() = 0.0;
+        breakpoints.back() = 1.0;
+        std::sort(breakpoints.begin(), breakpoints.end());
+        std::vector<double> weights(n_pieces);
+        std::generate(weights.begin(), weights.end(), [&] { return density(gen); });
+        std::piecewise_constant_distribution<double> distrib(breakpoints.begin(), breakpoints.end(), weights.begin());
+
+        std::vector<double> v(n_keys);
+        std::generate(v.begin(), v.end(), [&] { return distrib(gen); });
+        return scale<Key>(v);
+    }
+};
+
+
+/**
+ * Keys concentrated on 1,000 equidistant steps such that the CDF resembles a staircase.
+ */
+template<typename Key>
+struct Step {
+    std::vector<Key> operator()(const std::size_t n_keys, std::mt19937_64 &gen) const {
+        const std::size_t n_steps = 1000;
+        const double width = 1e-2; // relative to the distance between two steps
+
+        std::uniform_int_distribution<std::size_t> step(0, n_steps - 1);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+        std::vector<double> v(n_keys);
+        std::generate(v.begin(), v.end(), [&] { return (step(gen) + width * unit(gen)) / n_steps; });
+        return scale<Key>(v);
+    }
+};
+
+
+/**
+ * Timestamp-like keys with exponentially distributed inter-arrival times whose rate follows a daily cycle. 64-bit keys
+ * are microseconds, 32-bit keys seconds since the epoch, starting mid 2017. Gaps are rounded up to at least one unit
+ * such that keys are distinct, i.e. duplicates are only introduced by `--duplicates`.
+ */
+template<typename Key>
+struct Timestamp {
+    std::vector<Key> operator()(const std::size_t n_keys, std::mt19937_64 &gen) const {
+        const bool is_micros = sizeof(Key) > sizeof(uint32_t);
+        const double start = is_micros ? 1.5e15 : 1.5e9;
+        const double day = is_micros ? 86400e6 : 86400;
+        const double mean_gap = is_micros ? 1e3 : 1.0;
+
+        std::exponential_distribution<double> gap(1.0);
+        const double max = static_cast<double>(std::numeric_limits<Key>::max());
+
+        std::vector<Key> keys;
+        keys.reserve(n_keys);
+        double t = start;
+        for (std::size_t i = 0; i != n_keys; ++i) {
+            double rate = 1.0 + 0.8 * std::sin(2 * M_PI * (t - start) / day);
+            t += std::max(1.0, gap(gen) * mean_gap / rate);
+            keys.push_back(static_cast<Key>(std::min(t, max)));
+        }
+        return keys;
+    }
+};
+
+
+/**
+ * Generates a sorted dataset of @p n_keys keys following @p Distribution and writes it to @p filename in the format
+ * read by load_data().
+ * @tparam Key key type
+ * @tparam Distribution distribution the keys are drawn from
+ * @param n_keys number of keys
+ * @param duplicates ratio of keys that are replaced by a duplicate of their predecessor
+ * @param seed seed of the random number generator
+ * @param filename name of the dataset file
+ */
+template<typename Key, template<typename> typename Distribution>
+void generate(const std::size_t n_keys, const double duplicates, const uint64_t seed, const std::string filename)
+{
+    std::mt19937_64 gen(seed);
+
+    // Draw keys.
+    auto keys = Distribution<Key>()(n_keys, gen);
+    std::sort(keys.begin(), keys.end());
+
+    // Introduce duplicates.
+    std::bernoulli_distribution is_duplicate(duplicates);
+    for (std::size_t i = 1; i < keys.size(); ++i)
+        if (is_duplicate(gen)) keys[i] = keys[i - 1];
+
+    save_data(keys, filename);
+}
+
+
+/**
+ * @brief generator function pointer
+ */
+typedef void (*gen_fn_ptr)(const std::size_t, const double, const uint64_t, const std::string);
+
+#define ENTRIES(D, T) \
+    { std::make_pair(#D, "uint32"), &generate<uint32_t, T> }, \
+    { std::make_pair(#D, "uint64"), &generate<uint64_t, T> },
+
+static std::map<std::pair<std::string, std::string>, gen_fn_ptr> gen_map {
+    ENTRIES(uniform,          Uniform)
+    ENTRIES(normal,           Normal)
+    ENTRIES(lognormal,        Lognormal)
+    ENTRIES(zipf_clustered,   ZipfClustered)
+    ENTRIES(piecewise_linear, PiecewiseLinear)
+    ENTRIES(step,             Step)
+    ENTRIES(timestamp,        Timestamp)
+}; ///< Map that assigns a generator function pointer to distributions and key types.
+#undef ENTRIES
+
+
+/**
+ * Generates a synthetic dataset with distribution, size, and key type provided via command line arguments.
+ * @param argc arguments counter
+ * @param argv arguments vector
+ */
+int main(int argc, char *argv[])
+{
+    // Initialize argument parser.
+    argparse::ArgumentParser program(argv[0], "0.1");
+
+    // Define arguments.
+    program.add_argument("filename")
+        .help("path to the binary file the keys are written to");
+
+    program.add_argument("distribution")
+        .help("key distribution, either uniform, normal, lognormal, zipf_clustered, piecewise_linear, step, or timestamp.");
+
+    program.add_argument("n_keys")
+        .help("number of keys.")
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("-k", "--key_type")
+        .help("key type, either uint32 or uint64")
+        .default_value(std::string("uint64"));
+
+    program.add_argument("-d", "--duplicates")
+        .help("ratio of keys that duplicate their predecessor")
+        .default_value(0.0)
+        .action([](const std::string &s) { return std::stod(s); });
+
+    program.add_argument("--seed")
+        .help("seed of the random number generator")
+        .default_value(uint64_t(42))
+        .action([](const std::string &s) { return uint64_t(std::stoull(s)); });
+
+    // Parse arguments.
+    try {
+        program.parse_args(argc, argv);
+    }
+    catch (const std::runtime_error &err) {
+        std::cout << err.what() << '\n' << program;
+        exit(EXIT_FAILURE);
+    }
+
+    // Read arguments.
+    const auto filename = program.get<std::string>("filename");
+    const auto distribution = program.get<std::string>("distribution");
+    const auto n_keys = program.get<std::size_t>("n_keys");
+    const auto key_type = program.get<std::string>("-k");
+    const auto duplicates = program.get<double>("-d");
+    const auto seed = program.get<uint64_t>("--seed");
+    if (n_keys == 0) {
+        std::cerr << "Error: the number of keys must be positive." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    if (not (duplicates >= 0.0 and duplicates <= 1.0)) {
+        std::cerr << "Error: the ratio of duplicates must be in [0, 1]." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // Lookup generator.
+    auto config = std::make_pair(distribution, key_type);
+    if (gen_map.find(config) == gen_map.end()) {
+        std::cerr << "Error: " << distribution << ',' << key_type << " is not a valid dataset configuration." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    gen_fn_ptr gen_fn = gen_map[config];
+
+    // Generate dataset.
+    (*gen_fn)(n_keys, duplicates, seed, filename);
+
+    exit(EXIT_SUCCESS);
+}
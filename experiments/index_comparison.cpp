@@ -7,6 +7,8 @@
 #include "rmi/rmi.hpp"
 #include "rmi/util/fn.hpp"
 #include "rmi/util/search.hpp"
+#include "rmi/util/stats.hpp"
+#include "rmi/util/workload.hpp"
 
 #include "core/alex.h"
 #include "core/alex_base.h"
@@ -64,6 +66,8 @@
 #include "rmi_ref/wiki_ts_200M_uint64_8.h"
 #include "rmi_ref/wiki_ts_200M_uint64_9.h"
 
+#include "rmi_gen/rmi_gen.hpp"
+
 
 using key_type = uint64_t;
 using namespace std::chrono;
@@ -82,11 +86,13 @@ std::size_t s_glob; ///< global size_t variable
  * @param samples used for measuring the lookup time
  * @param n_reps number of repetitions
  * @param dataset_name name of the dataset
+ * @param workload name of the workload the samples were drawn from
  */
 void benchmark_rmi(const std::vector<key_type> &keys,
                    const std::vector<key_type> &samples,
                    const std::size_t n_reps,
-                   const std::string dataset_name)
+                   const std::string dataset_name,
+                   const std::string workload)
 {
     // Set hyperparameters.
     using layer1_type = rmi::LinearSpline;
@@ -104,17 +110,16 @@ void benchmark_rmi(const std::vector<key_type> &keys,
 
         // Evaluate RMI error.
         auto n_keys = keys.size();
-        std::vector<double> log2_errors;
-        log2_errors.reserve(n_keys);
+        StatsAccumulator<double> log2_errors;
 
         for (std::size_t i = 0; i != n_keys; ++i) {
             auto key = keys.at(i);
             auto pred = test_rmi.search(key).pos;
             auto err = pred > i ? pred - i : i - pred;
-            log2_errors.push_back(std::log2(err+1));
+            log2_errors.add(std::log2(err+1));
         }
 
-        auto mean_log2e = mean(log2_errors);
+        auto mean_log2e = log2_errors.mean();
 
 #define RUN(RMI_TYPE, SEARCH_FN, N_MODELS) \
         { \
@@ -165,6 +170,7 @@ void benchmark_rmi(const std::vector<key_type> &keys,
                           /* Experiment */ \
                           << rep << ',' \
                           << samples.size() << ',' \
+                          << workload << ',' \
                           /* Results */ \
                           << build_time << ',' \
                           << eval_time << ',' \
@@ -201,11 +207,13 @@ void benchmark_rmi(const std::vector<key_type> &keys,
  * @param samples used for measuring the lookup time
  * @param n_reps number of repetitions
  * @param dataset_name name of the dataset
+ * @param workload name of the workload the samples were drawn from
  */
 void benchmark_alex(const std::vector<key_type> &keys,
                     const std::vector<key_type> &samples,
                     const std::size_t n_reps,
-                    const std::string dataset_name)
+                    const std::string dataset_name,
+                    const std::string workload)
 {
     // Set hyperparameters.
     std::size_t min_sparcity = 0;
@@ -271,6 +279,7 @@ void benchmark_alex(const std::vector<key_type> &keys,
                       // Experiment
                       << rep << ','
                       << samples.size() << ','
+                      << workload << ','
                       // Results
                       << build_time << ','
                       << eval_time << ','
@@ -294,11 +303,13 @@ void benchmark_alex(const std::vector<key_type> &keys,
  * @param samples used for measuring the lookup time
  * @param n_reps number of repetitions
  * @param dataset_name name of the dataset
+ * @param workload name of the workload the samples were drawn from
  */
 void benchmark_pgm(const std::vector<key_type> &keys,
                    const std::vector<key_type> &samples,
                    const std::size_t n_reps,
-                   const std::string dataset_name)
+                   const std::string dataset_name,
+                   const std::string workload)
 {
 #define PGM(EPSILON, EPSILON_RECURSIVE) \
     { \
@@ -351,6 +362,7 @@ void benchmark_pgm(const std::vector<key_type> &keys,
                       /* Experiment */ \
                       << rep << ',' \
                       << samples.size() << ',' \
+                      << workload << ',' \
                       /* Results */ \
                       << build_time << ',' \
                       << eval_time << ',' \
@@ -391,11 +403,13 @@ void benchmark_pgm(const std::vector<key_type> &keys,
  * @param samples used for measuring the lookup time
  * @param n_reps number of repetitions
  * @param dataset_name name of the dataset
+ * @param workload name of the workload the samples were drawn from
  */
 void benchmark_rs(const std::vector<key_type> &keys,
                   const std::vector<key_type> &samples,
                   const std::size_t n_reps,
-                  const std::string dataset_name)
+                  const std::string dataset_name,
+                  const std::string workload)
 {
     // Set hyperparameters.
     std::vector<std::size_t> radix_bits = { 8, 10, 12, 14, 16, 20, 22, 24, 26, 28 };
@@ -452,6 +466,7 @@ void benchmark_rs(const std::vector<key_type> &keys,
                           // Experiment
                           << rep << ','
                           << samples.size() << ','
+                          << workload << ','
                           // Results
                           << build_time << ','
                           << eval_time << ','
@@ -476,11 +491,13 @@ void benchmark_rs(const std::vector<key_type> &keys,
  * @param samples used for measuring the lookup time
  * @param n_reps number of repetitions
  * @param dataset_name name of the dataset
+ * @param workload name of the workload the samples were drawn from
  */
 void benchmark_cht(const std::vector<key_type> &keys,
                    const std::vector<key_type> &samples,
                    const std::size_t n_reps,
-                   const std::string dataset_name)
+                   const std::string dataset_name,
+                   const std::string workload)
 {
     // Set hyperparameters.
     std::vector<std::pair<std::size_t, std::size_t>> configs = {
@@ -545,6 +562,7 @@ void benchmark_cht(const std::vector<key_type> &keys,
                       // Experiment
                       << rep << ','
                       << samples.size() << ','
+                      << workload << ','
                       // Results
                       << build_time << ','
                       << eval_time << ','
@@ -568,11 +586,13 @@ void benchmark_cht(const std::vector<key_type> &keys,
  * @param samples used for measuring the lookup time
  * @param n_reps number of repetitions
  * @param dataset_name name of the dataset
+ * @param workload name of the workload the samples were drawn from
  */
 void benchmark_art(const std::vector<key_type> &keys,
                    const std::vector<key_type> &samples,
                    const std::size_t n_reps,
-                   const std::string dataset_name)
+                   const std::string dataset_name,
+                   const std::string workload)
 {
     // Set hyperparameters.
     std::size_t min_sparcity = 0;
@@ -633,6 +653,7 @@ void benchmark_art(const std::vector<key_type> &keys,
                       // Experiment
                       << rep << ','
                       << samples.size() << ','
+                      << workload << ','
                       // Results
                       << build_time << ','
                       << eval_time << ','
@@ -656,11 +677,13 @@ void benchmark_art(const std::vector<key_type> &keys,
  * @param samples used for measuring the lookup time
  * @param n_reps number of repetitions
  * @param dataset_name name of the dataset
+ * @param workload name of the workload the samples were drawn from
  */
 void benchmark_tlx(const std::vector<key_type> &keys,
                    const std::vector<key_type> &samples,
                    const std::size_t n_reps,
-                   const std::string dataset_name)
+                   const std::string dataset_name,
+                   const std::string workload)
 {
     // Set hyperparameters.
     std::size_t min_sparcity = 0;
@@ -738,6 +761,7 @@ void benchmark_tlx(const std::vector<key_type> &keys,
                       // Experiment
                       << rep << ','
                       << samples.size() << ','
+                      << workload << ','
                       // Results
                       << build_time << ','
                       << eval_time << ','
@@ -761,11 +785,13 @@ void benchmark_tlx(const std::vector<key_type> &keys,
  * @param samples used for measuring the lookup time
  * @param n_reps number of repetitions
  * @param dataset_name name of the dataset
+ * @param workload name of the workload the samples were drawn from
  */
 void benchmark_ref(const std::vector<key_type> &keys,
                    const std::vector<key_type> &samples,
                    const std::size_t n_reps,
-                   const std::string dataset_name)
+                   const std::string dataset_name,
+                   const std::string workload)
 {
 #define RMI_DATA_PATH "third_party/RMI/include/rmi_ref/rmi_data"
 #define RUN(NAMESPACE) \
@@ -822,6 +848,7 @@ void benchmark_ref(const std::vector<key_type> &keys,
                   /* Experiment */ \
                   << rep << ',' \
                   << samples.size() << ',' \
+                  << workload << ',' \
                   /* Results */ \
                   << build_time << ',' \
                   << eval_time << ',' \
@@ -885,6 +912,91 @@ void benchmark_ref(const std::vector<key_type> &keys,
 }
 
 
+/*======================================================================================================================
+ * Generated Recursive Model Index
+ *====================================================================================================================*/
+
+/**
+ * Performs @p n_reps of lookups on @p samples using the recursive model indexes compiled in from the headers generated
+ * by `scripts/rmi_gen/prepare_rmi_gen.sh` for the given dataset. Writes results including build time, evaluation time,
+ * and lookup time to `std::cout`.
+ * @param keys on which the index is built
+ * @param samples used for measuring the lookup time
+ * @param n_reps number of repetitions
+ * @param dataset_name name of the dataset
+ * @param workload name of the workload the samples were drawn from
+ */
+void benchmark_gen([[maybe_unused]] const std::vector<key_type> &keys, // unused if no RMIs were generated
+                   [[maybe_unused]] const std::vector<key_type> &samples,
+                   [[maybe_unused]] const std::size_t n_reps,
+                   [[maybe_unused]] const std::string dataset_name,
+                   [[maybe_unused]] const std::string workload)
+{
+    bool found = false;
+#define RUN(DATASET, NAMESPACE) \
+    if (dataset_name == #DATASET and NAMESPACE::N_KEYS == keys.size()) { \
+    found = true; \
+    /* Perform n_reps runs. */ \
+    for (std::size_t rep = 0; rep != n_reps; ++rep) { \
+        \
+        /* Build time. */ \
+        std::size_t build_time = NAMESPACE::BUILD_TIME_NS; \
+        \
+        /* Eval time. */ \
+        std::size_t eval_accu = 0; \
+        auto start = steady_clock::now(); \
+        for (std::size_t i = 0; i != samples.size(); ++i) { \
+            auto key = samples.at(i); \
+            auto range = NAMESPACE::search(key); \
+            eval_accu += range.pos + range.lo + range.hi; \
+        } \
+        auto stop = steady_clock::now(); \
+        auto eval_time = duration_cast<nanoseconds>(stop - start).count(); \
+        s_glob = eval_accu; \
+        \
+        /* Lookup time. */ \
+        std::size_t lookup_accu = 0; \
+        start = steady_clock::now(); \
+        for (std::size_t i = 0; i != samples.size(); ++i) { \
+            auto key = samples.at(i); \
+            auto range = NAMESPACE::search(key); \
+            auto pos = std::lower_bound(keys.begin() + range.lo, keys.begin() + range.hi, key); \
+            lookup_accu += std::distance(keys.begin(), pos); \
+        } \
+        stop = steady_clock::now(); \
+        auto lookup_time = duration_cast<nanoseconds>(stop - start).count(); \
+        s_glob = lookup_accu; \
+        \
+        /* Report results. */ \
+                  /* Dataset */ \
+        std::cout << dataset_name << ',' \
+                  << keys.size() << ',' \
+                  /* Index */ \
+                  << "RMI-gen" << ',' \
+                  << #NAMESPACE << ',' \
+                  << NAMESPACE::RMI_SIZE << ',' \
+                  /* Experiment */ \
+                  << rep << ',' \
+                  << samples.size() << ',' \
+                  << workload << ',' \
+                  /* Results */ \
+                  << build_time << ',' \
+                  << eval_time << ',' \
+                  << lookup_time << ',' \
+                  /* Checksums */ \
+                  << eval_accu << ',' \
+                  << lookup_accu << std::endl; \
+    } /* rep */ \
+    }
+
+    RMI_GEN_FOR_EACH(RUN)
+#undef RUN
+
+    if (not found)
+        std::cerr << "Generated RMI not available for given dataset. Skipping." << std::endl;
+}
+
+
 /*======================================================================================================================
  * Binary search
  *====================================================================================================================*/
@@ -895,11 +1007,13 @@ void benchmark_ref(const std::vector<key_type> &keys,
  * @param samples used for measuring the lookup time
  * @param n_reps number of repetitions
  * @param dataset_name name of the dataset
+ * @param workload name of the workload the samples were drawn from
  */
 void benchmark_bin(const std::vector<key_type> &keys,
                    const std::vector<key_type> &samples,
                    const std::size_t n_reps,
-                   const std::string dataset_name)
+                   const std::string dataset_name,
+                   const std::string workload)
 {
     // Perform n_reps runs.
     for (std::size_t rep = 0; rep != n_reps; ++rep) {
@@ -937,6 +1051,7 @@ void benchmark_bin(const std::vector<key_type> &keys,
                   // Experiment
                   << rep << ','
                   << samples.size() << ','
+                  << workload << ','
                   // Results
                   << build_time << ','
                   << eval_time << ','
@@ -971,6 +1086,10 @@ int main(int argc, char *argv[])
         .default_value(std::size_t(1'000'000))
         .action([](const std::string &s) { return std::stoul(s); });
 
+    program.add_argument("-w", "--workload")
+        .help("lookup workload, either uniform, zipf, hotset, absent, out_of_range, sorted, or clustered")
+        .default_value(std::string("uniform"));
+
     program.add_argument("--header")
         .help("output csv header")
         .default_value(false)
@@ -1016,6 +1135,11 @@ int main(int argc, char *argv[])
         .default_value(false)
         .implicit_value(true);
 
+    program.add_argument("--gen")
+        .help("run benchmark on Recursive Model Index compiled in from generated headers")
+        .default_value(false)
+        .implicit_value(true);
+
     program.add_argument("--bin")
         .help("run benchmark on binary search")
         .default_value(false)
@@ -1035,18 +1159,14 @@ int main(int argc, char *argv[])
     const auto dataset_name = split(filename, '/').back();
     const auto n_reps = program.get<std::size_t>("-n");
     const auto n_samples = program.get<std::size_t>("-s");
+    const auto workload = program.get<std::string>("-w");
 
     // Load keys.
     auto keys = load_data<key_type>(filename);
 
     // Sample keys.
     uint64_t seed = 42;
-    std::mt19937 gen(seed);
-    std::uniform_int_distribution<> distrib(0, keys.size() - 1);
-    std::vector<key_type> samples;
-    samples.reserve(n_samples);
-    for (std::size_t i = 0; i != n_samples; ++i)
-        samples.push_back(keys[distrib(gen)]);
+    auto samples = generate_workload(keys, workload, n_samples, seed);
 
     // Output header.
     if (program["--header"]  == true)
@@ -1057,6 +1177,7 @@ int main(int argc, char *argv[])
                   << "size_in_bytes,"
                   << "rep,"
                   << "n_samples,"
+                  << "workload,"
                   << "build_time,"
                   << "eval_time,"
                   << "lookup_time,"
@@ -1065,15 +1186,16 @@ int main(int argc, char *argv[])
                   << std::endl;
 
     // Run benchmarks.
-    if (program["--rmi"]  == true) benchmark_rmi(keys, samples, n_reps, dataset_name);
-    if (program["--alex"] == true) benchmark_alex(keys, samples, n_reps, dataset_name);
-    if (program["--pgm"]  == true) benchmark_pgm(keys, samples, n_reps, dataset_name);
-    if (program["--rs"]   == true) benchmark_rs(keys, samples, n_reps, dataset_name);
-    if (program["--cht"]  == true) benchmark_cht(keys, samples, n_reps, dataset_name);
-    if (program["--art"]  == true) benchmark_art(keys, samples, n_reps, dataset_name);
-    if (program["--tlx"]  == true) benchmark_tlx(keys, samples, n_reps, dataset_name);
-    if (program["--ref"]  == true) benchmark_ref(keys, samples, n_reps, dataset_name);
-    if (program["--bin"]  == true) benchmark_bin(keys, samples, n_reps, dataset_name);
+    if (program["--rmi"]  == true) benchmark_rmi(keys, samples, n_reps, dataset_name, workload);
+    if (program["--alex"] == true) benchmark_alex(keys, samples, n_reps, dataset_name, workload);
+    if (program["--pgm"]  == true) benchmark_pgm(keys, samples, n_reps, dataset_name, workload);
+    if (program["--rs"]   == true) benchmark_rs(keys, samples, n_reps, dataset_name, workload);
+    if (program["--cht"]  == true) benchmark_cht(keys, samples, n_reps, dataset_name, workload);
+    if (program["--art"]  == true) benchmark_art(keys, samples, n_reps, dataset_name, workload);
+    if (program["--tlx"]  == true) benchmark_tlx(keys, samples, n_reps, dataset_name, workload);
+    if (program["--ref"]  == true) benchmark_ref(keys, samples, n_reps, dataset_name, workload);
+    if (program["--gen"]  == true) benchmark_gen(keys, samples, n_reps, dataset_name, workload);
+    if (program["--bin"]  == true) benchmark_bin(keys, samples, n_reps, dataset_name, workload);
 
     exit(EXIT_SUCCESS);
 }
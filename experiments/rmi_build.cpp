@@ -21,6 +21,7 @@ std::size_t s_glob; ///< global size_t variable
  * @param layer1 model type of the first layer
  * @param layer2 model type of the second layer
  * @param bounds_type used by the RMI
+ * @param compress whether runs of empty segments share a single layer2 model
  */
 template<typename Key, typename Rmi>
 void experiment(const std::vector<key_type> &keys,
@@ -29,7 +30,8 @@ void experiment(const std::vector<key_type> &keys,
                 const std::string dataset_name,
                 const std::string layer1,
                 const std::string layer2,
-                const std::string bound_type)
+                const std::string bound_type,
+                const bool compress)
 {
     using rmi_type = Rmi;
 
@@ -38,7 +40,7 @@ void experiment(const std::vector<key_type> &keys,
 
         // Build RMI.
         auto start = steady_clock::now();
-        rmi_type rmi(keys, n_models);
+        rmi_type rmi(keys, n_models, compress);
         auto stop = steady_clock::now();
         auto build_time = duration_cast<nanoseconds>(stop - start).count();
 
@@ -53,7 +55,7 @@ void experiment(const std::vector<key_type> &keys,
         std::cout << dataset_name << ','
                   << keys.size() << ','
                   // Index
-                  << "ours" << ','
+                  << (compress ? "ours_compressed" : "ours") << ','
                   << layer1 << ','
                   << layer2 << ','
                   << n_models << ','
@@ -78,7 +80,8 @@ typedef void (*exp_fn_ptr)(const std::vector<key_type>&,
                            const std::string,
                            const std::string,
                            const std::string,
-                           const std::string);
+                           const std::string,
+                           const bool);
 
 /**
  * RMI configuration that holds the string representation of model types of layer 1 and layer 2 and the error bound
@@ -117,6 +120,18 @@ static std::map<Config, exp_fn_ptr, ConfigCompare> exp_map {
     ENTRIES(cubic_spline,      linear_spline,     rmi::CubicSpline,      rmi::LinearSpline)
     ENTRIES(radix,             linear_regression, rmi::Radix<key_type>,  rmi::LinearRegression)
     ENTRIES(radix,             linear_spline,     rmi::Radix<key_type>,  rmi::LinearSpline)
+    ENTRIES(radix_table,       linear_regression, rmi::RadixTable<key_type>, rmi::LinearRegression)
+    ENTRIES(radix_table,       linear_spline,     rmi::RadixTable<key_type>, rmi::LinearSpline)
+    ENTRIES(linear_regression, pla,               rmi::LinearRegression, rmi::PiecewiseLinear<key_type>)
+    ENTRIES(linear_spline,     pla,               rmi::LinearSpline,     rmi::PiecewiseLinear<key_type>)
+    ENTRIES(cubic_spline,      pla,               rmi::CubicSpline,      rmi::PiecewiseLinear<key_type>)
+    ENTRIES(radix,             pla,               rmi::Radix<key_type>,  rmi::PiecewiseLinear<key_type>)
+    ENTRIES(radix_table,       pla,               rmi::RadixTable<key_type>, rmi::PiecewiseLinear<key_type>)
+    ENTRIES(linear_regression, auto,              rmi::LinearRegression, rmi::AutoLinear)
+    ENTRIES(linear_spline,     auto,              rmi::LinearSpline,     rmi::AutoLinear)
+    ENTRIES(cubic_spline,      auto,              rmi::CubicSpline,      rmi::AutoLinear)
+    ENTRIES(radix,             auto,              rmi::Radix<key_type>,  rmi::AutoLinear)
+    ENTRIES(radix_table,       auto,              rmi::RadixTable<key_type>, rmi::AutoLinear)
 }; ///< Map that assigns an experiment function pointer to RMI configurations.
 #undef ENTRIES
 
@@ -136,10 +151,10 @@ int main(int argc, char *argv[])
         .help("path to binary file containing uin64_t keys");
 
     program.add_argument("layer1")
-        .help("layer1 model type, either linear_regression, linear_spline, cubic_spline, or radix.");
+        .help("layer1 model type, either linear_regression, linear_spline, cubic_spline, radix, or radix_table.");
 
     program.add_argument("layer2")
-        .help("layer2 model type, either linear_regression, linear_spline, or cubic_spline.");
+        .help("layer2 model type, either linear_regression, linear_spline, cubic_spline, pla, or auto.");
 
     program.add_argument("n_models")
         .help("number of models on layer2, power of two is recommended.")
@@ -153,6 +168,11 @@ int main(int argc, char *argv[])
         .default_value(std::size_t(3))
         .action([](const std::string &s) { return std::stoul(s); });
 
+    program.add_argument("--compress")
+        .help("share a single layer2 model among each run of empty segments")
+        .default_value(false)
+        .implicit_value(true);
+
     program.add_argument("--header")
         .help("output csv header")
         .default_value(false)
@@ -175,6 +195,7 @@ int main(int argc, char *argv[])
     const auto n_models = program.get<std::size_t>("n_models");
     const auto bound_type = program.get<std::string>("bound_type");
     const auto n_reps = program.get<std::size_t>("-n");
+    const bool compress = program["--compress"] == true;
 
     // Load keys.
     auto keys = load_data<key_type>(filename);
@@ -203,7 +224,7 @@ int main(int argc, char *argv[])
                   << std::endl;
 
     // Run experiment.
-    (*exp_fn)(keys, n_models, n_reps, dataset_name, layer1, layer2, bound_type);
+    (*exp_fn)(keys, n_models, n_reps, dataset_name, layer1, layer2, bound_type, compress);
 
     exit(EXIT_SUCCESS);
 }
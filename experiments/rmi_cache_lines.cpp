@@ -0,0 +1,323 @@
+#include <algorithm>
+#include <iterator>
+
+#include "argparse/argparse.hpp"
+
+#include "rmi/models.hpp"
+#include "rmi/rmi.hpp"
+#include "rmi/util/fn.hpp"
+#include "rmi/util/search.hpp"
+#include "rmi/util/stats.hpp"
+#include "rmi/util/workload.hpp"
+
+using key_type = uint64_t;
+
+
+/**
+ * Random access iterator over keys that records the cache line of every key it dereferences.
+ */
+class LineTracer
+{
+    public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = key_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const key_type*;
+    using reference = const key_type&;
+
+    private:
+    const key_type *ptr_ = nullptr;           ///< The current key.
+    std::vector<uintptr_t> *lines_ = nullptr; ///< The cache lines of all dereferenced keys.
+
+    public:
+    LineTracer() = default;
+    LineTracer(const key_type *ptr, std::vector<uintptr_t> *lines) : ptr_(ptr), lines_(lines) { }
+
+    reference operator*() const {
+        lines_->push_back(reinterpret_cast<uintptr_t>(ptr_) / cache_line_size);
+        return *ptr_;
+    }
+    reference operator[](const difference_type n) const { return *(*this + n); }
+
+    LineTracer &operator++() { ++ptr_; return *this; }
+    LineTracer &operator--() { --ptr_; return *this; }
+    LineTracer operator++(int) { auto tmp = *this; ++ptr_; return tmp; }
+    LineTracer operator--(int) { auto tmp = *this; --ptr_; return tmp; }
+    LineTracer &operator+=(const difference_type n) { ptr_ += n; return *this; }
+    LineTracer &operator-=(const difference_type n) { ptr_ -= n; return *this; }
+    LineTracer operator+(const difference_type n) const { return LineTracer(ptr_ + n, lines_); }
+    LineTracer operator-(const difference_type n) const { return LineTracer(ptr_ - n, lines_); }
+    friend LineTracer operator+(const difference_type n, const LineTracer &it) { return it + n; }
+    difference_type operator-(const LineTracer &other) const { return ptr_ - other.ptr_; }
+
+    bool operator==(const LineTracer &other) const { return ptr_ == other.ptr_; }
+    bool operator!=(const LineTracer &other) const { return ptr_ != other.ptr_; }
+    bool operator<(const LineTracer &other) const { return ptr_ < other.ptr_; }
+    bool operator>(const LineTracer &other) const { return ptr_ > other.ptr_; }
+    bool operator<=(const LineTracer &other) const { return ptr_ <= other.ptr_; }
+    bool operator>=(const LineTracer &other) const { return ptr_ >= other.ptr_; }
+};
+
+
+/**
+ * Counts the cache lines of @p keys that @p search_fn touches when searching the intervals of @p rmi for @p samples and
+ * writes results to `std::cout`.
+ * @tparam Rmi RMI type
+ * @tparam Search search type
+ * @param keys on which @p rmi is built
+ * @param rmi the RMI
+ * @param samples lookup keys
+ * @param search_fn used for correcting prediction errors
+ * @param search name of @p search_fn
+ * @param config the leading columns of the output, i.e. dataset and RMI configuration
+ */
+template<typename Rmi, typename Search>
+void count_lines(const std::vector<key_type> &keys,
+                 const Rmi &rmi,
+                 const std::vector<key_type> &samples,
+                 const Search &search_fn,
+                 const std::string search,
+                 const std::string config)
+{
+    StatsAccumulator<int64_t> interval_sizes;
+    StatsAccumulator<int64_t> lines_spanned;
+    StatsAccumulator<int64_t> lines_touched;
+    std::size_t lookup_accu = 0;
+
+    // Looks up each sample and hands its search bounds, position, and the number of cache lines touched to fn.
+    auto for_each_lookup = [&](auto fn) {
+        std::vector<uintptr_t> lines;
+        for (auto key : samples) {
+            auto range = rmi.search(key);
+            lines.clear();
+            LineTracer begin(keys.data(), &lines);
+            auto pos = search_fn(begin + range.lo, begin + range.hi, begin + range.pos, key);
+            std::sort(lines.begin(), lines.end());
+            fn(range, pos - begin, std::distance(lines.begin(), std::unique(lines.begin(), lines.end())));
+        }
+    };
+
+    for_each_lookup([&](const rmi::Approx &range, std::size_t pos, int64_t n_touched) {
+        lookup_accu += pos;
+
+        // Record the interval size and the number of cache lines it overlaps and that were touched.
+        interval_sizes.add(range.hi - range.lo);
+        if (range.hi > range.lo)
+            lines_spanned.add(reinterpret_cast<uintptr_t>(keys.data() + range.hi - 1) / cache_line_size
+                              - reinterpret_cast<uintptr_t>(keys.data() + range.lo) / cache_line_size + 1);
+        else
+            lines_spanned.add(0);
+        lines_touched.add(n_touched);
+    });
+
+    // Select the median, looking up the samples again if it is not known yet.
+    auto median_touched = lines_touched.select(0.5);
+    while (not median_touched.done()) {
+        for_each_lookup([&](const rmi::Approx&, std::size_t, int64_t n_touched) { median_touched.add(n_touched); });
+        median_touched.narrow();
+    }
+
+    // Report results.
+    std::cout << config << ','
+              << search << ','
+              << samples.size() << ','
+              << interval_sizes.mean() << ','
+              << lines_spanned.mean() << ','
+              << lines_touched.mean() << ','
+              << median_touched.value() << ','
+              << lines_touched.max() << ','
+              // Checksums
+              << lookup_accu << std::endl;
+}
+
+
+/**
+ * Counts the cache lines touched per lookup by several search algorithms on a given @p Rmi and writes results to
+ * `std::cout`.
+ * @tparam Key key type
+ * @tparam Rmi RMI type
+ * @param keys on which the RMI is built
+ * @param n_models number of models in the second layer of the RMI
+ * @param samples lookup keys
+ * @param dataset_name name of the dataset
+ * @param layer1 model type of the first layer
+ * @param layer2 model type of the second layer
+ * @param bound_type used by the RMI
+ */
+template<typename Key, typename Rmi>
+void experiment(const std::vector<key_type> &keys,
+                const std::size_t n_models,
+                const std::vector<key_type> &samples,
+                const std::string dataset_name,
+                const std::string layer1,
+                const std::string layer2,
+                const std::string bound_type)
+{
+    using rmi_type = Rmi;
+
+    // Build RMI.
+    rmi_type rmi(keys, n_models);
+
+    std::string config = dataset_name + ',' + std::to_string(keys.size()) + ',' + layer1 + ',' + layer2 + ',' +
+                         std::to_string(n_models) + ',' + bound_type + ',' + std::to_string(rmi.size_in_bytes());
+
+    count_lines(keys, rmi, samples, BinarySearch(), "binary", config);
+    count_lines(keys, rmi, samples, ModelBiasedBinarySearch(), "model_biased_binary", config);
+    count_lines(keys, rmi, samples, ModelBiasedExponentialSearch(), "model_biased_exponential", config);
+    count_lines(keys, rmi, samples, CacheLineSearch<Key>(keys.data(), keys.size()), "cache_line", config);
+}
+
+
+/**
+ * @brief experiment function pointer
+ */
+typedef void (*exp_fn_ptr)(const std::vector<key_type>&,
+                           const std::size_t,
+                           const std::vector<key_type>&,
+                           const std::string,
+                           const std::string,
+                           const std::string,
+                           const std::string);
+
+/**
+ * RMI configuration that holds the string representation of model types of layer 1 and layer 2 and the error bound
+ * type.
+ */
+struct Config {
+    std::string layer1;
+    std::string layer2;
+    std::string bound_type;
+};
+
+/**
+ * Comparator class for @p Config objects.
+ */
+struct ConfigCompare {
+    bool operator() (const Config &lhs, const Config &rhs) const {
+        if (lhs.layer1 != rhs.layer1) return lhs.layer1 < rhs.layer1;
+        if (lhs.layer2 != rhs.layer2) return lhs.layer2 < rhs.layer2;
+        return lhs.bound_type < rhs.bound_type;
+    }
+};
+
+#define ENTRIES(L1, L2, T1, T2) \
+    { {#L1, #L2, "none"}, &experiment<key_type, rmi::Rmi<key_type, T1, T2>> }, \
+    { {#L1, #L2, "labs"}, &experiment<key_type, rmi::RmiLAbs<key_type, T1, T2>> }, \
+    { {#L1, #L2, "lind"}, &experiment<key_type, rmi::RmiLInd<key_type, T1, T2>> }, \
+    { {#L1, #L2, "gabs"}, &experiment<key_type, rmi::RmiGAbs<key_type, T1, T2>> }, \
+    { {#L1, #L2, "gind"}, &experiment<key_type, rmi::RmiGInd<key_type, T1, T2>> },
+
+static std::map<Config, exp_fn_ptr, ConfigCompare> exp_map {
+    ENTRIES(linear_regression, linear_regression, rmi::LinearRegression, rmi::LinearRegression)
+    ENTRIES(linear_regression, linear_spline,     rmi::LinearRegression, rmi::LinearSpline)
+    ENTRIES(linear_spline,     linear_regression, rmi::LinearSpline,     rmi::LinearRegression)
+    ENTRIES(linear_spline,     linear_spline,     rmi::LinearSpline,     rmi::LinearSpline)
+    ENTRIES(cubic_spline,      linear_regression, rmi::CubicSpline,      rmi::LinearRegression)
+    ENTRIES(cubic_spline,      linear_spline,     rmi::CubicSpline,      rmi::LinearSpline)
+    ENTRIES(radix,             linear_regression, rmi::Radix<key_type>,  rmi::LinearRegression)
+    ENTRIES(radix,             linear_spline,     rmi::Radix<key_type>,  rmi::LinearSpline)
+    ENTRIES(radix_table,       linear_regression, rmi::RadixTable<key_type>, rmi::LinearRegression)
+    ENTRIES(radix_table,       linear_spline,     rmi::RadixTable<key_type>, rmi::LinearSpline)
+}; ///< Map that assigns an experiment function pointer to RMI configurations.
+#undef ENTRIES
+
+
+/**
+ * Triggers counting the cache lines touched per lookup for an RMI configuration provided via command line arguments.
+ * @param argc arguments counter
+ * @param argv arguments vector
+ */
+int main(int argc, char *argv[])
+{
+    // Initialize argument parser.
+    argparse::ArgumentParser program(argv[0], "0.1");
+
+    // Define arguments.
+    program.add_argument("filename")
+        .help("path to binary file containing uin64_t keys");
+
+    program.add_argument("layer1")
+        .help("layer1 model type, either linear_regression, linear_spline, cubic_spline, radix, or radix_table.");
+
+    program.add_argument("layer2")
+        .help("layer2 model type, either linear_regression or linear_spline.");
+
+    program.add_argument("n_models")
+        .help("number of models on layer2, power of two is recommended.")
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("bound_type")
+        .help("type of error bounds used, either none, labs, lind, gabs, or gind.");
+
+    program.add_argument("-s", "--n_samples")
+        .help("number of sampled lookup keys")
+        .default_value(std::size_t(1'000'000))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("-w", "--workload")
+        .help("lookup workload, either uniform, zipf, hotset, absent, out_of_range, sorted, or clustered")
+        .default_value(std::string("uniform"));
+
+    program.add_argument("--header")
+        .help("output csv header")
+        .default_value(false)
+        .implicit_value(true);
+
+    // Parse arguments.
+    try {
+        program.parse_args(argc, argv);
+    }
+    catch (const std::runtime_error &err) {
+        std::cout << err.what() << '\n' << program;
+        exit(EXIT_FAILURE);
+    }
+
+    // Read arguments.
+    const auto filename = program.get<std::string>("filename");
+    const auto dataset_name = split(filename, '/').back();
+    const auto layer1 = program.get<std::string>("layer1");
+    const auto layer2 = program.get<std::string>("layer2");
+    const auto n_models = program.get<std::size_t>("n_models");
+    const auto bound_type = program.get<std::string>("bound_type");
+    const auto n_samples = program.get<std::size_t>("-s");
+    const auto workload = program.get<std::string>("-w");
+
+    // Load keys.
+    auto keys = load_data<key_type>(filename);
+
+    // Sample keys.
+    uint64_t seed = 42;
+    auto samples = generate_workload(keys, workload, n_samples, seed);
+
+    // Lookup experiment.
+    Config config{layer1, layer2, bound_type};
+    if (exp_map.find(config) == exp_map.end()) {
+        std::cerr << "Error: " << layer1 << ',' << layer2 << ',' << bound_type <<  " is not a valid RMI configuration." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    exp_fn_ptr exp_fn = exp_map[config];
+
+    // Output header.
+    if (program["--header"]  == true)
+        std::cout << "dataset,"
+                  << "n_keys,"
+                  << "layer1,"
+                  << "layer2,"
+                  << "n_models,"
+                  << "bounds,"
+                  << "size_in_bytes,"
+                  << "search,"
+                  << "n_samples,"
+                  << "mean_interval,"
+                  << "mean_lines_spanned,"
+                  << "mean_lines_touched,"
+                  << "median_lines_touched,"
+                  << "max_lines_touched,"
+                  << "lookup_accu"
+                  << std::endl;
+
+    // Run experiment.
+    (*exp_fn)(keys, n_models, samples, dataset_name, layer1, layer2, bound_type);
+
+    exit(EXIT_SUCCESS);
+}
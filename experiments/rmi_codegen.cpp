@@ -0,0 +1,181 @@
+#include <chrono>
+#include <fstream>
+
+#include "argparse/argparse.hpp"
+
+#include "rmi/codegen.hpp"
+#include "rmi/models.hpp"
+#include "rmi/rmi.hpp"
+#include "rmi/util/fn.hpp"
+
+
+using key_type = uint64_t;
+using namespace std::chrono;
+
+
+/**
+ * Builds a given @p Rmi on dataset @p keys and writes a header implementing its lookup to @p out. The build time is
+ * written as constant `BUILD_TIME_NS` as well.
+ * @tparam Key key type
+ * @tparam Rmi RMI type
+ * @param keys on which the RMI is built
+ * @param n_models number of models in the second layer of the RMI
+ * @param compress whether runs of empty segments share a single layer2 model
+ * @param name namespace of the generated code
+ * @param out output stream to write the header to
+ */
+template<typename Key, typename Rmi>
+void generate(const std::vector<key_type> &keys,
+              const std::size_t n_models,
+              const bool compress,
+              const std::string name,
+              std::ostream &out)
+{
+    using rmi_type = Rmi;
+
+    // Build RMI.
+    auto start = steady_clock::now();
+    rmi_type rmi(keys, n_models, compress);
+    auto stop = steady_clock::now();
+    auto build_time = duration_cast<nanoseconds>(stop - start).count();
+
+    // Write header.
+    rmi::emit(out, rmi, name);
+    out << "\nnamespace " << name << " { constexpr std::size_t BUILD_TIME_NS = " << build_time << "; }\n";
+}
+
+/**
+ * @brief generator function pointer
+ */
+typedef void (*gen_fn_ptr)(const std::vector<key_type>&,
+                           const std::size_t,
+                           const bool,
+                           const std::string,
+                           std::ostream&);
+
+/**
+ * RMI configuration that holds the string representation of model types of layer 1 and layer 2 and the error bound
+ * type.
+ */
+struct Config {
+    std::string layer1;
+    std::string layer2;
+    std::string bound_type;
+};
+
+/**
+ * Comparator class for @p Config objects.
+ */
+struct ConfigCompare {
+    bool operator() (const Config &lhs, const Config &rhs) const {
+        if (lhs.layer1 != rhs.layer1) return lhs.layer1 < rhs.layer1;
+        if (lhs.layer2 != rhs.layer2) return lhs.layer2 < rhs.layer2;
+        return lhs.bound_type < rhs.bound_type;
+    }
+};
+
+#define ENTRIES(L1, L2, T1, T2) \
+    { {#L1, #L2, "labs"}, &generate<key_type, rmi::RmiLAbs<key_type, T1, T2>> }, \
+    { {#L1, #L2, "none"}, &generate<key_type, rmi::Rmi<key_type, T1, T2>> },
+
+static std::map<Config, gen_fn_ptr, ConfigCompare> gen_map {
+    ENTRIES(linear_regression, linear_regression, rmi::LinearRegression, rmi::LinearRegression)
+    ENTRIES(linear_regression, linear_spline,     rmi::LinearRegression, rmi::LinearSpline)
+    ENTRIES(linear_spline,     linear_regression, rmi::LinearSpline,     rmi::LinearRegression)
+    ENTRIES(linear_spline,     linear_spline,     rmi::LinearSpline,     rmi::LinearSpline)
+    ENTRIES(cubic_spline,      linear_regression, rmi::CubicSpline,      rmi::LinearRegression)
+    ENTRIES(cubic_spline,      linear_spline,     rmi::CubicSpline,      rmi::LinearSpline)
+    ENTRIES(radix,             linear_regression, rmi::Radix<key_type>,  rmi::LinearRegression)
+    ENTRIES(radix,             linear_spline,     rmi::Radix<key_type>,  rmi::LinearSpline)
+    ENTRIES(linear_regression, auto,              rmi::LinearRegression, rmi::AutoLinear)
+    ENTRIES(linear_spline,     auto,              rmi::LinearSpline,     rmi::AutoLinear)
+    ENTRIES(cubic_spline,      auto,              rmi::CubicSpline,      rmi::AutoLinear)
+    ENTRIES(radix,             auto,              rmi::Radix<key_type>,  rmi::AutoLinear)
+}; ///< Map that assigns a generator function pointer to RMI configurations.
+#undef ENTRIES
+
+
+/**
+ * Trains an RMI configuration provided via command line arguments and writes a header that implements its lookup with
+ * all parameters compiled in.
+ * @param argc arguments counter
+ * @param argv arguments vector
+ */
+int main(int argc, char *argv[])
+{
+    // Initialize argument parser.
+    argparse::ArgumentParser program(argv[0], "0.1");
+
+    // Define arguments.
+    program.add_argument("filename")
+        .help("path to binary file containing uin64_t keys");
+
+    program.add_argument("layer1")
+        .help("layer1 model type, either linear_regression, linear_spline, cubic_spline, or radix.");
+
+    program.add_argument("layer2")
+        .help("layer2 model type, either linear_regression, linear_spline, or auto.");
+
+    program.add_argument("n_models")
+        .help("number of models on layer2, power of two is recommended.")
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("bound_type")
+        .help("type of error bounds used, either none or labs.");
+
+    program.add_argument("namespace")
+        .help("namespace of the generated code");
+
+    program.add_argument("-o", "--output")
+        .help("path of the generated header, written to stdout if omitted")
+        .default_value(std::string());
+
+    program.add_argument("--compress")
+        .help("share a single layer2 model among each run of empty segments")
+        .default_value(false)
+        .implicit_value(true);
+
+    // Parse arguments.
+    try {
+        program.parse_args(argc, argv);
+    }
+    catch (const std::runtime_error &err) {
+        std::cout << err.what() << '\n' << program;
+        exit(EXIT_FAILURE);
+    }
+
+    // Read arguments.
+    const auto filename = program.get<std::string>("filename");
+    const auto layer1 = program.get<std::string>("layer1");
+    const auto layer2 = program.get<std::string>("layer2");
+    const auto n_models = program.get<std::size_t>("n_models");
+    const auto bound_type = program.get<std::string>("bound_type");
+    const auto name = program.get<std::string>("namespace");
+    const auto output = program.get<std::string>("-o");
+    const bool compress = program["--compress"] == true;
+
+    // Load keys.
+    auto keys = load_data<key_type>(filename);
+
+    // Lookup generator.
+    Config config{layer1, layer2, bound_type};
+    if (gen_map.find(config) == gen_map.end()) {
+        std::cerr << "Error: " << layer1 << ',' << layer2 << ',' << bound_type <<  " is not a valid RMI configuration." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    gen_fn_ptr gen_fn = gen_map[config];
+
+    // Generate header.
+    if (output.empty()) {
+        (*gen_fn)(keys, n_models, compress, name, std::cout);
+    } else {
+        std::ofstream out(output);
+        if (not out) {
+            std::cerr << "Error: could not open " << output << '.' << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        (*gen_fn)(keys, n_models, compress, name, out);
+    }
+
+    exit(EXIT_SUCCESS);
+}
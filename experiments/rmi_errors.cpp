@@ -1,18 +1,27 @@
+#include <numeric>
+#include <thread>
+#include <utility>
+
 #include "argparse/argparse.hpp"
 
 #include "rmi/models.hpp"
 #include "rmi/rmi.hpp"
 #include "rmi/util/fn.hpp"
+#include "rmi/util/stats.hpp"
 
 using key_type = uint64_t;
 
 
+constexpr std::size_t batch_size = 4096; ///< number of keys searched at once
+
+
 /**
  * Computes several error metrics for a given @p Rmi on dataset @p keys and writes results to `std::cout`.
  * @tparam Key key type
  * @tparam Rmi RMI type
  * @param keys on which the RMI is built
  * @param n_models number of models in the second layer of the RMI
+ * @param n_threads number of threads used for computing errors
  * @param dataset_name name of the dataset
  * @param layer1 model type of the first layer
  * @param layer2 model type of the second layer
@@ -20,6 +29,7 @@ using key_type = uint64_t;
 template<typename Key, typename Rmi>
 void experiment(const std::vector<key_type> &keys,
                 const std::size_t n_models,
+                const std::size_t n_threads,
                 const std::string dataset_name,
                 const std::string layer1,
                 const std::string layer2)
@@ -31,23 +41,75 @@ void experiment(const std::vector<key_type> &keys,
 
     // Initialize variables.
     auto n_keys = keys.size();
-    std::vector<int64_t> absolute_errors;
-    absolute_errors.reserve(n_keys);
-
-    // Perform predictions.
-    auto prev_key = keys.at(0);
-    int64_t prev_pos = 0;
-    for (std::size_t i = 0; i != n_keys; ++i) {
-        auto key = keys.at(i);
-        auto pred = rmi.search(key);
-
-        // Record error.
-        int64_t pos = key == prev_key ? prev_pos : i;
-        auto absolute_error = std::abs(pos - static_cast<int64_t>(pred.pos));
-        absolute_errors.push_back(absolute_error);
-
-        prev_key = key;
-        prev_pos = pos;
+    auto n_batches = (n_keys + batch_size - 1) / batch_size;
+    std::vector<StatsAccumulator<int64_t>> thread_errors(n_threads);
+    std::vector<Moments> batch_moments(n_batches);
+    std::vector<double> batch_log2_errors(n_batches, 0.);
+
+    // Computes the absolute errors, each thread on a contiguous range of batches, and hands them to fn batch by batch.
+    // Batches do not depend on the number of threads.
+    auto for_each_batch = [&](auto fn) {
+        parallel_for(n_batches, n_threads, [&](std::size_t thread_id, std::size_t first_batch, std::size_t last_batch) {
+            if (first_batch == last_batch) return;
+            std::size_t begin = first_batch * batch_size;
+            std::size_t end = std::min(n_keys, last_batch * batch_size);
+            std::vector<rmi::Approx> preds(batch_size);
+            std::vector<int64_t> errors(batch_size);
+
+            // The position of a key is the position of its first occurrence, which may lie in a previous range.
+            auto prev_key = keys[begin];
+            int64_t prev_pos = std::distance(keys.begin(),
+                                             std::lower_bound(keys.begin(), keys.begin() + begin, prev_key));
+
+            for (std::size_t batch = begin; batch < end; batch += batch_size) {
+                std::size_t batch_end = std::min(end, batch + batch_size);
+                rmi.search(keys.begin() + batch, keys.begin() + batch_end, preds.begin());
+
+                for (std::size_t i = batch; i != batch_end; ++i) {
+                    auto key = keys[i];
+                    auto pred = preds[i - batch];
+
+                    // Compute error.
+                    int64_t pos = key == prev_key ? prev_pos : i;
+                    errors[i - batch] = std::abs(pos - static_cast<int64_t>(pred.pos));
+
+                    prev_key = key;
+                    prev_pos = pos;
+                }
+                fn(thread_id, batch / batch_size, errors.cbegin(), errors.cbegin() + (batch_end - batch));
+            }
+        });
+    };
+
+    // Record errors.
+    for_each_batch([&](std::size_t thread_id, std::size_t batch_id, auto first, auto last) {
+        auto &absolute_errors = thread_errors[thread_id];
+        auto &moments = batch_moments[batch_id];
+        double log2_errors = 0.;
+        for (auto it = first; it != last; ++it) {
+            absolute_errors.add(*it);
+            moments.add(*it);
+            log2_errors += std::log2(*it + 1);
+        }
+        batch_log2_errors[batch_id] = log2_errors;
+    });
+
+    // Merge results. Moments are merged in batch order to be independent of the number of threads.
+    StatsAccumulator<int64_t> absolute_errors;
+    for (auto &errors : thread_errors) absolute_errors.merge(std::move(errors));
+    Moments moments;
+    for (auto &m : batch_moments) moments.merge(m);
+    double log2_errors = std::accumulate(batch_log2_errors.begin(), batch_log2_errors.end(), 0.); // in batch order
+
+    // Select the median, searching the keys again if it is not known yet.
+    auto median = absolute_errors.select(0.5);
+    while (not median.done()) {
+        std::vector<decltype(median)> thread_medians(n_threads, median);
+        for_each_batch([&](std::size_t thread_id, std::size_t, auto first, auto last) {
+            for (auto it = first; it != last; ++it) thread_medians[thread_id].add(*it);
+        });
+        for (auto &m : thread_medians) median.merge(m);
+        median.narrow();
     }
 
     // Report results.
@@ -59,11 +121,13 @@ void experiment(const std::vector<key_type> &keys,
               << layer2 << ','
               << n_models << ','
                  // Absolute error
-              << mean(absolute_errors) << ','
-              << median(absolute_errors) << ','
-              << stdev(absolute_errors) << ','
-              << min(absolute_errors) << ','
-              << max(absolute_errors) << std::endl;
+              << absolute_errors.mean() << ','
+              << median.value() << ','
+              << moments.stdev() << ','
+              << absolute_errors.min() << ','
+              << absolute_errors.max() << ','
+                 // Log2 error
+              << log2_errors / n_keys << std::endl;
 }
 
 
@@ -71,6 +135,7 @@ void experiment(const std::vector<key_type> &keys,
  * @brief experiment function pointer
  */
 typedef void (*exp_fn_ptr)(const std::vector<key_type>&,
+                           const std::size_t,
                            const std::size_t,
                            const std::string,
                            const std::string,
@@ -88,6 +153,30 @@ static std::map<std::pair<std::string, std::string>, exp_fn_ptr> exp_map {
     ENTRY(cubic_spline,      linear_spline,     rmi::CubicSpline,      rmi::LinearSpline),
     ENTRY(radix,             linear_regression, rmi::Radix<key_type>,  rmi::LinearRegression),
     ENTRY(radix,             linear_spline,     rmi::Radix<key_type>,  rmi::LinearSpline),
+    ENTRY(radix_table,       linear_regression, rmi::RadixTable<key_type>, rmi::LinearRegression),
+    ENTRY(radix_table,       linear_spline,     rmi::RadixTable<key_type>, rmi::LinearSpline),
+    ENTRY(piecewise_cdf,     linear_regression, rmi::PiecewiseCdf<>,   rmi::LinearRegression),
+    ENTRY(piecewise_cdf,     linear_spline,     rmi::PiecewiseCdf<>,   rmi::LinearSpline),
+    ENTRY(normal,            linear_regression, rmi::NormalCdf,        rmi::LinearRegression),
+    ENTRY(normal,            linear_spline,     rmi::NormalCdf,        rmi::LinearSpline),
+    ENTRY(lognormal,         linear_regression, rmi::LogNormalCdf,     rmi::LinearRegression),
+    ENTRY(lognormal,         linear_spline,     rmi::LogNormalCdf,     rmi::LinearSpline),
+    ENTRY(linear_regression, pla,               rmi::LinearRegression, rmi::PiecewiseLinear<key_type>),
+    ENTRY(linear_spline,     pla,               rmi::LinearSpline,     rmi::PiecewiseLinear<key_type>),
+    ENTRY(cubic_spline,      pla,               rmi::CubicSpline,      rmi::PiecewiseLinear<key_type>),
+    ENTRY(radix,             pla,               rmi::Radix<key_type>,  rmi::PiecewiseLinear<key_type>),
+    ENTRY(radix_table,       pla,               rmi::RadixTable<key_type>, rmi::PiecewiseLinear<key_type>),
+    ENTRY(piecewise_cdf,     pla,               rmi::PiecewiseCdf<>,   rmi::PiecewiseLinear<key_type>),
+    ENTRY(normal,            pla,               rmi::NormalCdf,        rmi::PiecewiseLinear<key_type>),
+    ENTRY(lognormal,         pla,               rmi::LogNormalCdf,     rmi::PiecewiseLinear<key_type>),
+    ENTRY(linear_regression, auto,              rmi::LinearRegression, rmi::AutoLinear),
+    ENTRY(linear_spline,     auto,              rmi::LinearSpline,     rmi::AutoLinear),
+    ENTRY(cubic_spline,      auto,              rmi::CubicSpline,      rmi::AutoLinear),
+    ENTRY(radix,             auto,              rmi::Radix<key_type>,  rmi::AutoLinear),
+    ENTRY(radix_table,       auto,              rmi::RadixTable<key_type>, rmi::AutoLinear),
+    ENTRY(piecewise_cdf,     auto,              rmi::PiecewiseCdf<>,   rmi::AutoLinear),
+    ENTRY(normal,            auto,              rmi::NormalCdf,        rmi::AutoLinear),
+    ENTRY(lognormal,         auto,              rmi::LogNormalCdf,     rmi::AutoLinear),
 }; ///< Map that assigns an experiment function pointer to RMI configurations.
 #undef ENTRY
 
@@ -107,15 +196,21 @@ int main(int argc, char *argv[])
         .help("path to binary file containing uin64_t keys");
 
     program.add_argument("layer1")
-        .help("layer1 model type, either linear_regression, linear_spline, cubic_spline, or radix.");
+        .help("layer1 model type, either linear_regression, linear_spline, cubic_spline, radix, radix_table, "
+              "piecewise_cdf, normal, or lognormal.");
 
     program.add_argument("layer2")
-        .help("layer2 model type, either linear_regression, linear_spline, or cubic_spline.");
+        .help("layer2 model type, either linear_regression, linear_spline, cubic_spline, pla, or auto.");
 
     program.add_argument("n_models")
         .help("number of models on layer2, power of two is recommended.")
         .action([](const std::string &s) { return std::stoul(s); });
 
+    program.add_argument("-t", "--n_threads")
+        .help("number of threads used for computing errors")
+        .default_value(std::size_t(std::max(1U, std::thread::hardware_concurrency())))
+        .action([](const std::string &s) { return std::stoul(s); });
+
     program.add_argument("--header")
         .help("output csv header")
         .default_value(false)
@@ -136,6 +231,11 @@ int main(int argc, char *argv[])
     const auto layer1 = program.get<std::string>("layer1");
     const auto layer2 = program.get<std::string>("layer2");
     const auto n_models = program.get<std::size_t>("n_models");
+    const auto n_threads = program.get<std::size_t>("-t");
+    if (n_threads == 0) {
+        std::cerr << "Error: the number of threads must be positive." << std::endl;
+        exit(EXIT_FAILURE);
+    }
 
     // Load keys.
     auto keys = load_data<key_type>(filename);
@@ -157,13 +257,14 @@ int main(int argc, char *argv[])
                   << "n_models,"
                   << "mean_ae,"
                   << "median_ae,"
-                  << "stdev_ae"
-                  << "min_ae"
-                  << "max_ae"
+                  << "stdev_ae,"
+                  << "min_ae,"
+                  << "max_ae,"
+                  << "mean_log2_ae"
                   << std::endl;
 
     // Run experiment.
-    (*exp_fn)(keys, n_models, dataset_name, layer1, layer2);
+    (*exp_fn)(keys, n_models, n_threads, dataset_name, layer1, layer2);
 
     exit(EXIT_SUCCESS);
 }
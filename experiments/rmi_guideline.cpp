@@ -8,6 +8,8 @@
 #include "rmi/rmi.hpp"
 #include "rmi/util/fn.hpp"
 #include "rmi/util/search.hpp"
+#include "rmi/util/stats.hpp"
+#include "rmi/util/workload.hpp"
 
 using key_type = uint64_t;
 using namespace std::chrono;
@@ -29,6 +31,7 @@ std::size_t s_glob; ///< global size_t variable
  * @param layer2 model type of the second layer
  * @param bounds used by the RMI
  * @param search used by the RMI for correction prediction errors
+ * @param workload name of the workload the samples were drawn from
  * @param budget the budget under which the configuration was chosen
  */
 template<typename Key, typename Rmi, typename Search>
@@ -41,6 +44,7 @@ void experiment(const std::vector<key_type> &keys,
                 const std::string layer2,
                 const std::string bounds,
                 const std::string search,
+                const std::string workload,
                 const std::size_t budget,
                 const bool is_guideline)
 {
@@ -53,17 +57,16 @@ void experiment(const std::vector<key_type> &keys,
     // Skip configurations that are guaranteed to not be the fastest.
     if (search == "model_biased_linear") {
         auto n_keys = keys.size();
-        std::vector<std::size_t> errors;
-        errors.reserve(n_keys);
+        StatsAccumulator<std::size_t> errors;
 
         for (std::size_t i = 0; i != n_keys; ++i) {
             auto key = keys.at(i);
             auto pred = rmi.search(key).pos;
             auto err = pred > i ? pred - i : i - pred;
-            errors.push_back(err);
+            errors.add(err);
         }
 
-        auto mean_ae = mean(errors);
+        auto mean_ae = errors.mean();
         if (mean_ae > 10) return;
     }
 
@@ -97,6 +100,7 @@ void experiment(const std::vector<key_type> &keys,
                   // Experiment
                   << rep << ','
                   << samples.size() << ','
+                  << workload << ','
                   << budget << ','
                   << is_guideline << ','
                   // Results
@@ -119,6 +123,7 @@ typedef void (*exp_fn_ptr)(const std::vector<key_type>&,
                            const std::string,
                            const std::string,
                            const std::string,
+                           const std::string,
                            const std::size_t,
                            const bool);
 
@@ -189,6 +194,8 @@ static std::map<Config, exp_fn_ptr, ConfigCompare> exp_map {
     ENTRIES(cubic_spline,      linear_spline,     rmi::CubicSpline,      rmi::LinearSpline)
     ENTRIES(radix,             linear_regression, rmi::Radix<key_type>,  rmi::LinearRegression)
     ENTRIES(radix,             linear_spline,     rmi::Radix<key_type>,  rmi::LinearSpline)
+    ENTRIES(radix_table,       linear_regression, rmi::RadixTable<key_type>, rmi::LinearRegression)
+    ENTRIES(radix_table,       linear_spline,     rmi::RadixTable<key_type>, rmi::LinearSpline)
 }; ///< Map that assigns an experiment function pointer to RMI configurations.
 #undef ENTRIES
 
@@ -199,12 +206,14 @@ static std::map<Config, exp_fn_ptr, ConfigCompare> exp_map {
  * @param samples for which the lookup time is measured
  * @param n_reps number of repetitions
  * @param dataset_name name of the dataset
+ * @param workload name of the workload the samples were drawn from
  * @param budget the budget under which the configuration is to be chosen
  */
 void evaluate_guideline(const std::vector<key_type> &keys,
                         const std::vector<key_type> &samples,
                         const std::size_t n_reps,
                         const std::string dataset_name,
+                        const std::string workload,
                         const std::size_t budget)
 {
     // Dermine maximum number of layer 2 models for LS->LR NB+MExp.
@@ -215,17 +224,16 @@ void evaluate_guideline(const std::vector<key_type> &keys,
 
     // Evaluate RMI error.
     auto n_keys = keys.size();
-    std::vector<double> log2_errors;
-    log2_errors.reserve(n_keys);
+    StatsAccumulator<double> log2_errors;
 
     for (std::size_t i = 0; i != n_keys; ++i) {
         auto key = keys.at(i);
         auto pred = rmi.search(key).pos;
         auto err = pred > i ? pred - i : i - pred;
-        log2_errors.push_back(std::log2(err+1));
+        log2_errors.add(std::log2(err+1));
     }
 
-    auto mean_log2e = mean(log2_errors);
+    auto mean_log2e = log2_errors.mean();
 
     // Pick and evaluate guideline config based on errors.
     auto l1 = "linear_spline";
@@ -240,7 +248,7 @@ void evaluate_guideline(const std::vector<key_type> &keys,
         Config config {l1, l2, bounds, search};
         exp_fn_ptr exp_fn = exp_map[config];
 
-        (*exp_fn)(keys, n_models, samples, n_reps, dataset_name, l1, l2, bounds, search, budget, true);
+        (*exp_fn)(keys, n_models, samples, n_reps, dataset_name, l1, l2, bounds, search, workload, budget, true);
     } else {
         auto bounds = "labs";
         auto search = "binary";
@@ -249,7 +257,7 @@ void evaluate_guideline(const std::vector<key_type> &keys,
         Config config {l1, l2, bounds, search};
         exp_fn_ptr exp_fn = exp_map[config];
 
-        (*exp_fn)(keys, n_models, samples, n_reps, dataset_name, l1, l2, bounds, search, budget, true);
+        (*exp_fn)(keys, n_models, samples, n_reps, dataset_name, l1, l2, bounds, search, workload, budget, true);
     }
 }
 
@@ -283,6 +291,10 @@ int main(int argc, char *argv[])
         .default_value(std::size_t(1'000'000))
         .action([](const std::string &s) { return std::stoul(s); });
 
+    program.add_argument("-w", "--workload")
+        .help("lookup workload, either uniform, zipf, hotset, absent, out_of_range, sorted, or clustered")
+        .default_value(std::string("uniform"));
+
     program.add_argument("--header")
         .help("output csv header")
         .default_value(false)
@@ -303,21 +315,17 @@ int main(int argc, char *argv[])
     const auto budget = program.get<std::size_t>("budget");
     const auto n_reps = program.get<std::size_t>("-n");
     const auto n_samples = program.get<std::size_t>("-s");
+    const auto workload = program.get<std::string>("-w");
 
     // Load keys.
     auto keys = load_data<key_type>(filename);
 
     // Sample keys.
     uint64_t seed = 42;
-    std::mt19937 gen(seed);
-    std::uniform_int_distribution<> distrib(0, keys.size() - 1);
-    std::vector<key_type> samples;
-    samples.reserve(n_samples);
-    for (std::size_t i = 0; i != n_samples; ++i)
-        samples.push_back(keys[distrib(gen)]);
+    auto samples = generate_workload(keys, workload, n_samples, seed);
 
     // List configuration parameters.
-    std::vector<std::string> l1_models = {"linear_spline", "cubic_spline", "linear_regression", "radix"};
+    std::vector<std::string> l1_models = {"linear_spline", "cubic_spline", "linear_regression", "radix", "radix_table"};
     std::vector<std::string> l2_models = {"linear_regression"}; // We know that lr is always better than ls from previous experiments.
     std::vector<std::pair<std::string, std::string>> err_corrs = {
         std::make_pair("none", "model_biased_exponential"),
@@ -329,9 +337,10 @@ int main(int argc, char *argv[])
     // List model and bound sizes.
     std::map<std::string, std::size_t> model_size = {
         { "linear_spline", 2 * sizeof(double) },
-        { "cubic_spline", 4 * sizeof(double) },
+        { "cubic_spline", 5 * sizeof(double) },
         { "linear_regression", 2 * sizeof(double) },
         { "radix", 1 * sizeof(key_type) },
+        { "radix_table", rmi::RadixTable<key_type>(keys.begin(), keys.end()).size_in_bytes() },
     };
     std::map<std::string, std::size_t> bounds_size = {
         { "none", 0 },
@@ -351,6 +360,7 @@ int main(int argc, char *argv[])
                   << "size_in_bytes,"
                   << "rep,"
                   << "n_samples,"
+                  << "workload,"
                   << "budget_in_bytes,"
                   << "is_guideline,"
                   << "lookup_time,"
@@ -364,6 +374,9 @@ int main(int argc, char *argv[])
                 auto bounds = corr.first;
                 auto search = corr.second;
 
+                // Skip layer1 models that exceed the budget on their own.
+                if (model_size[l1] + 2 * sizeof(std::size_t) >= budget) continue;
+
                 // Dermine maximum number of layer 2 models.
                 auto n_models = (budget - model_size[l1] - 2 * sizeof(std::size_t)) / (model_size[l2] + bounds_size[bounds]);
 
@@ -374,13 +387,13 @@ int main(int argc, char *argv[])
                 exp_fn_ptr exp_fn = exp_map[config];
 
                 // Call evaluatin function with keys and n_models.
-                (*exp_fn)(keys, n_models, samples, n_reps, dataset_name, l1, l2, bounds, search, budget, false);
+                (*exp_fn)(keys, n_models, samples, n_reps, dataset_name, l1, l2, bounds, search, workload, budget, false);
             }
         }
     }
 
     // Evaluate guideline configuration.
-    evaluate_guideline(keys, samples, n_reps, dataset_name, budget);
+    evaluate_guideline(keys, samples, n_reps, dataset_name, workload, budget);
 
     exit(EXIT_SUCCESS);
 }
@@ -1,14 +1,21 @@
+#include <algorithm>
+#include <thread>
 #include <tuple>
+#include <utility>
 
 #include "argparse/argparse.hpp"
 
 #include "rmi/models.hpp"
 #include "rmi/rmi.hpp"
 #include "rmi/util/fn.hpp"
+#include "rmi/util/stats.hpp"
 
 using key_type = uint64_t;
 
 
+constexpr std::size_t batch_size = 4096; ///< number of keys searched at once
+
+
 /**
  * Computes several metrics on the error interval sizes for a given @p Rmi on dataset @p keys and writes results to
  * `std::cout`.
@@ -16,6 +23,7 @@ using key_type = uint64_t;
  * @tparam Rmi RMI type
  * @param keys on which the RMI is built
  * @param n_models number of models in the second layer of the RMI
+ * @param n_threads number of threads used for computing interval sizes
  * @param dataset_name name of the dataset
  * @param layer1 model type of the first layer
  * @param layer2 model type of the second layer
@@ -24,6 +32,7 @@ using key_type = uint64_t;
 template<typename Key, typename Rmi>
 void experiment(const std::vector<key_type> &keys,
                 const std::size_t n_models,
+                const std::size_t n_threads,
                 const std::string dataset_name,
                 const std::string layer1,
                 const std::string layer2,
@@ -36,16 +45,53 @@ void experiment(const std::vector<key_type> &keys,
 
     // Initialize variables.
     auto n_keys = keys.size();
-    std::vector<int64_t> interval_sizes;
-    interval_sizes.reserve(n_keys);
+    auto n_batches = (n_keys + batch_size - 1) / batch_size;
+    std::vector<StatsAccumulator<int64_t>> thread_interval_sizes(n_threads);
+    std::vector<Moments> batch_moments(n_batches);
+
+    // Computes the interval sizes, each thread on a contiguous range of batches, and hands them to fn batch by batch.
+    // Batches do not depend on the number of threads.
+    auto for_each_batch = [&](auto fn) {
+        parallel_for(n_batches, n_threads, [&](std::size_t thread_id, std::size_t first_batch, std::size_t last_batch) {
+            std::vector<rmi::Approx> preds(batch_size);
+            std::vector<int64_t> sizes(batch_size);
+
+            for (std::size_t batch = first_batch; batch != last_batch; ++batch) {
+                std::size_t begin = batch * batch_size;
+                std::size_t end = std::min(n_keys, begin + batch_size);
+                rmi.search(keys.begin() + begin, keys.begin() + end, preds.begin());
+                std::transform(preds.begin(), preds.begin() + (end - begin), sizes.begin(),
+                               [](const rmi::Approx &pred) { return pred.hi - pred.lo; });
+                fn(thread_id, batch, sizes.cbegin(), sizes.cbegin() + (end - begin));
+            }
+        });
+    };
+
+    // Record interval sizes.
+    for_each_batch([&](std::size_t thread_id, std::size_t batch_id, auto first, auto last) {
+        auto &interval_sizes = thread_interval_sizes[thread_id];
+        auto &moments = batch_moments[batch_id];
+        for (auto it = first; it != last; ++it) {
+            interval_sizes.add(*it);
+            moments.add(*it);
+        }
+    });
 
-    // Perform predictions.
-    for (auto key : keys) {
-        auto pred = rmi.search(key);
+    // Merge results. Moments are merged in batch order to be independent of the number of threads.
+    StatsAccumulator<int64_t> interval_sizes;
+    for (auto &sizes : thread_interval_sizes) interval_sizes.merge(std::move(sizes));
+    Moments moments;
+    for (auto &m : batch_moments) moments.merge(m);
 
-        // Record interval size.
-        auto interval_size = pred.hi - pred.lo;
-        interval_sizes.push_back(interval_size);
+    // Select the median, searching the keys again if it is not known yet.
+    auto median = interval_sizes.select(0.5);
+    while (not median.done()) {
+        std::vector<decltype(median)> thread_medians(n_threads, median);
+        for_each_batch([&](std::size_t thread_id, std::size_t, auto first, auto last) {
+            for (auto it = first; it != last; ++it) thread_medians[thread_id].add(*it);
+        });
+        for (auto &m : thread_medians) median.merge(m);
+        median.narrow();
     }
 
     // Report results.
@@ -59,11 +105,11 @@ void experiment(const std::vector<key_type> &keys,
               << bound_type << ','
               << rmi.size_in_bytes() << ','
                  // Interval sizes
-              << mean(interval_sizes) << ','
-              << median(interval_sizes) << ','
-              << stdev(interval_sizes) << ','
-              << min(interval_sizes) << ','
-              << max(interval_sizes) << std::endl;
+              << interval_sizes.mean() << ','
+              << median.value() << ','
+              << moments.stdev() << ','
+              << interval_sizes.min() << ','
+              << interval_sizes.max() << std::endl;
 }
 
 
@@ -71,6 +117,7 @@ void experiment(const std::vector<key_type> &keys,
  * @brief experiment function pointer
  */
 typedef void (*exp_fn_ptr)(const std::vector<key_type>&,
+                           const std::size_t,
                            const std::size_t,
                            const std::string,
                            const std::string,
@@ -113,6 +160,8 @@ static std::map<Config, exp_fn_ptr, ConfigCompare> exp_map {
     ENTRIES(cubic_spline,      linear_spline,     rmi::CubicSpline,      rmi::LinearSpline)
     ENTRIES(radix,             linear_regression, rmi::Radix<key_type>,  rmi::LinearRegression)
     ENTRIES(radix,             linear_spline,     rmi::Radix<key_type>,  rmi::LinearSpline)
+    ENTRIES(radix_table,       linear_regression, rmi::RadixTable<key_type>, rmi::LinearRegression)
+    ENTRIES(radix_table,       linear_spline,     rmi::RadixTable<key_type>, rmi::LinearSpline)
 }; ///< Map that assigns an experiment function pointer to RMI configurations.
 #undef ENTRIES
 
@@ -133,7 +182,7 @@ int main(int argc, char *argv[])
         .help("path to binary file containing uin64_t keys");
 
     program.add_argument("layer1")
-        .help("layer1 model type, either linear_regression, linear_spline, cubic_spline, or radix.");
+        .help("layer1 model type, either linear_regression, linear_spline, cubic_spline, radix, or radix_table.");
 
     program.add_argument("layer2")
         .help("layer2 model type, either linear_regression, linear_spline, or cubic_spline.");
@@ -145,6 +194,11 @@ int main(int argc, char *argv[])
     program.add_argument("bound_type")
         .help("type of error bounds used, either labs, lind, gabs, or gind.");
 
+    program.add_argument("-t", "--n_threads")
+        .help("number of threads used for computing interval sizes")
+        .default_value(std::size_t(std::max(1U, std::thread::hardware_concurrency())))
+        .action([](const std::string &s) { return std::stoul(s); });
+
     program.add_argument("--header")
         .help("output csv header")
         .default_value(false)
@@ -166,6 +220,11 @@ int main(int argc, char *argv[])
     const auto layer2 = program.get<std::string>("layer2");
     const auto n_models = program.get<std::size_t>("n_models");
     const auto bound_type = program.get<std::string>("bound_type");
+    const auto n_threads = program.get<std::size_t>("-t");
+    if (n_threads == 0) {
+        std::cerr << "Error: the number of threads must be positive." << std::endl;
+        exit(EXIT_FAILURE);
+    }
 
     // Load keys.
     auto keys = load_data<key_type>(filename);
@@ -195,7 +254,7 @@ int main(int argc, char *argv[])
                   << std::endl;
 
     // Run experiment.
-    (*exp_fn)(keys, n_models, dataset_name, layer1, layer2, bound_type);
+    (*exp_fn)(keys, n_models, n_threads, dataset_name, layer1, layer2, bound_type);
 
     exit(EXIT_SUCCESS);
 }
@@ -0,0 +1,302 @@
+#include <chrono>
+
+#include "argparse/argparse.hpp"
+
+#include "rmi/models.hpp"
+#include "rmi/rmi.hpp"
+#include "rmi/util/fn.hpp"
+#include "rmi/util/search.hpp"
+#include "rmi/util/workload.hpp"
+
+using namespace std::chrono;
+
+std::size_t s_glob; ///< global size_t variable
+
+
+/**
+ * Converts the sorted uint64_t @p keys to sorted keys of type @p Key. 32-bit keys keep the most significant bits of the
+ * data, which may introduce duplicates. Signed keys are shifted to be centered around zero, floating-point keys are
+ * rounded to the nearest representable value.
+ * @tparam Key key type
+ * @param keys sorted uint64_t keys
+ * @return sorted keys of type @p Key
+ */
+template<typename Key>
+std::vector<Key> convert(const std::vector<uint64_t> &keys)
+{
+    std::vector<Key> converted;
+    converted.reserve(keys.size());
+    if constexpr (std::is_same_v<Key, uint32_t>) {
+        auto width = bit_width(keys.back());
+        auto shift = width > 32 ? width - 32 : 0;
+        for (auto key : keys) converted.push_back(key >> shift);
+    } else if constexpr (std::is_same_v<Key, int64_t>) {
+        for (auto key : keys) converted.push_back(static_cast<int64_t>(key ^ (1UL << 63)));
+    } else {
+        for (auto key : keys) converted.push_back(static_cast<Key>(key));
+    }
+    return converted;
+}
+
+
+/**
+ * Measures lookup times of @p samples on a given @p Rmi built on keys of type @p Key and writes results to
+ * `std::cout`.
+ * @tparam Key key type
+ * @tparam Rmi RMI type
+ * @tparam Search search type
+ * @param keys on which the RMI is built, converted to @p Key
+ * @param n_models number of models in the second layer of the RMI
+ * @param n_samples number of sampled lookup keys
+ * @param n_reps number of repetitions
+ * @param dataset_name name of the dataset
+ * @param key_type name of the key type
+ * @param layer1 model type of the first layer
+ * @param layer2 model type of the second layer
+ * @param bound_type used by the RMI
+ * @param search used by the RMI for correction prediction errors
+ * @param workload name of the workload the samples are drawn from
+ */
+template<typename Key, typename Rmi, typename Search>
+void experiment(const std::vector<uint64_t> &keys,
+                const std::size_t n_models,
+                const std::size_t n_samples,
+                const std::size_t n_reps,
+                const std::string dataset_name,
+                const std::string key_type,
+                const std::string layer1,
+                const std::string layer2,
+                const std::string bound_type,
+                const std::string search,
+                const std::string workload)
+{
+    using rmi_type = Rmi;
+    auto search_fn = Search();
+
+    // Convert keys and sample lookup keys.
+    auto typed_keys = convert<Key>(keys);
+    uint64_t seed = 42;
+    auto samples = generate_workload(typed_keys, workload, n_samples, seed);
+
+    // Build RMI.
+    rmi_type rmi(typed_keys, n_models);
+
+    // Perform n_reps runs.
+    for (std::size_t rep = 0; rep != n_reps; ++rep) {
+
+        // Lookup time.
+        std::size_t lookup_accu = 0;
+        auto start = steady_clock::now();
+        for (std::size_t i = 0; i != samples.size(); ++i) {
+            auto key = samples.at(i);
+            auto range = rmi.search(key);
+            auto pos = search_fn(typed_keys.begin() + range.lo, typed_keys.begin() + range.hi, typed_keys.begin() + range.pos, key);
+            lookup_accu += std::distance(typed_keys.begin(), pos);
+        }
+        auto stop = steady_clock::now();
+        auto lookup_time = duration_cast<nanoseconds>(stop - start).count();
+        s_glob = lookup_accu;
+
+        // Report results.
+                  // Dataset
+        std::cout << dataset_name << ','
+                  << typed_keys.size() << ','
+                  << key_type << ','
+                  << sizeof(Key) << ','
+                  // Index
+                  << layer1 << ','
+                  << layer2 << ','
+                  << n_models << ','
+                  << bound_type << ','
+                  << search << ','
+                  << rmi.size_in_bytes() << ','
+                  // Experiment
+                  << rep << ','
+                  << samples.size() << ','
+                  << workload << ','
+                  // Results
+                  << lookup_time << ','
+                  // Checksums
+                  << lookup_accu << std::endl;
+    } // reps
+}
+
+
+/**
+ * @brief experiment function pointer
+ */
+typedef void (*exp_fn_ptr)(const std::vector<uint64_t>&,
+                           const std::size_t,
+                           const std::size_t,
+                           const std::size_t,
+                           const std::string,
+                           const std::string,
+                           const std::string,
+                           const std::string,
+                           const std::string,
+                           const std::string,
+                           const std::string);
+
+/**
+ * RMI configuration that holds the string representation of the key type, model types of layer 1 and layer 2, error
+ * bound type, and search algorithm.
+ */
+struct Config {
+    std::string key_type;
+    std::string layer1;
+    std::string layer2;
+    std::string bound_type;
+    std::string search;
+};
+
+/**
+ * Comparator class for @p Config objects.
+ */
+struct ConfigCompare {
+    bool operator() (const Config &lhs, const Config &rhs) const {
+        if (lhs.key_type != rhs.key_type) return lhs.key_type < rhs.key_type;
+        if (lhs.layer1 != rhs.layer1) return lhs.layer1 < rhs.layer1;
+        if (lhs.layer2 != rhs.layer2) return lhs.layer2 < rhs.layer2;
+        if (lhs.bound_type != rhs.bound_type) return lhs.bound_type < rhs.bound_type;
+        return lhs.search < rhs.search;
+    }
+};
+
+#define ENTRIES(K, KT, L1, L2, LT1, LT2) \
+    { {#K, #L1, #L2, "none", "model_biased_exponential"}, &experiment<KT, rmi::Rmi<KT, LT1, LT2>, ModelBiasedExponentialSearch> }, \
+    { {#K, #L1, #L2, "labs", "binary"}, &experiment<KT, rmi::RmiLAbs<KT, LT1, LT2>, BinarySearch> }, \
+    { {#K, #L1, #L2, "lind", "model_biased_binary"}, &experiment<KT, rmi::RmiLInd<KT, LT1, LT2>, ModelBiasedBinarySearch> }, \
+    { {#K, #L1, #L2, "gabs", "binary"}, &experiment<KT, rmi::RmiGAbs<KT, LT1, LT2>, BinarySearch> }, \
+    { {#K, #L1, #L2, "gind", "model_biased_binary"}, &experiment<KT, rmi::RmiGInd<KT, LT1, LT2>, ModelBiasedBinarySearch> },
+
+#define KEY_ENTRIES(K, KT) \
+    ENTRIES(K, KT, linear_regression, linear_regression, rmi::LinearRegression, rmi::LinearRegression) \
+    ENTRIES(K, KT, linear_regression, linear_spline,     rmi::LinearRegression, rmi::LinearSpline) \
+    ENTRIES(K, KT, linear_spline,     linear_regression, rmi::LinearSpline,     rmi::LinearRegression) \
+    ENTRIES(K, KT, linear_spline,     linear_spline,     rmi::LinearSpline,     rmi::LinearSpline) \
+    ENTRIES(K, KT, cubic_spline,      linear_regression, rmi::CubicSpline,      rmi::LinearRegression) \
+    ENTRIES(K, KT, cubic_spline,      linear_spline,     rmi::CubicSpline,      rmi::LinearSpline) \
+    ENTRIES(K, KT, radix,             linear_regression, rmi::Radix<KT>,        rmi::LinearRegression) \
+    ENTRIES(K, KT, radix,             linear_spline,     rmi::Radix<KT>,        rmi::LinearSpline) \
+    ENTRIES(K, KT, radix_table,       linear_regression, rmi::RadixTable<KT>, rmi::LinearRegression) \
+    ENTRIES(K, KT, radix_table,       linear_spline,     rmi::RadixTable<KT>, rmi::LinearSpline)
+
+static std::map<Config, exp_fn_ptr, ConfigCompare> exp_map {
+    KEY_ENTRIES(uint32, uint32_t)
+    KEY_ENTRIES(uint64, uint64_t)
+    KEY_ENTRIES(int64,  int64_t)
+    KEY_ENTRIES(double, double)
+}; ///< Map that assigns an experiment function pointer to key types and RMI configurations.
+#undef KEY_ENTRIES
+#undef ENTRIES
+
+
+/**
+ * Triggers measurement of lookup times for a key type and an RMI configuration provided via command line arguments.
+ * @param argc arguments counter
+ * @param argv arguments vector
+ */
+int main(int argc, char *argv[])
+{
+    // Initialize argument parser.
+    argparse::ArgumentParser program(argv[0], "0.1");
+
+    // Define arguments.
+    program.add_argument("filename")
+        .help("path to binary file containing uin64_t keys");
+
+    program.add_argument("key_type")
+        .help("key type the keys are converted to, either uint32, uint64, int64, or double.");
+
+    program.add_argument("layer1")
+        .help("layer1 model type, either linear_regression, linear_spline, cubic_spline, radix, or radix_table.");
+
+    program.add_argument("layer2")
+        .help("layer2 model type, either linear_regression or linear_spline.");
+
+    program.add_argument("n_models")
+        .help("number of models on layer2, power of two is recommended.")
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("bound_type")
+        .help("type of error bounds used, either none, labs, lind, gabs, or gind.");
+
+    program.add_argument("search")
+        .help("search algorithm for error correction, model_biased_exponential for none, binary for labs and gabs, and model_biased_binary for lind and gind.");
+
+   program.add_argument("-n", "--n_reps")
+        .help("number of experiment repetitions")
+        .default_value(std::size_t(3))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("-s", "--n_samples")
+        .help("number of sampled lookup keys")
+        .default_value(std::size_t(1'000'000))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("-w", "--workload")
+        .help("lookup workload, either uniform, zipf, hotset, absent, out_of_range, sorted, or clustered")
+        .default_value(std::string("uniform"));
+
+    program.add_argument("--header")
+        .help("output csv header")
+        .default_value(false)
+        .implicit_value(true);
+
+    // Parse arguments.
+    try {
+        program.parse_args(argc, argv);
+    }
+    catch (const std::runtime_error &err) {
+        std::cout << err.what() << '\n' << program;
+        exit(EXIT_FAILURE);
+    }
+
+    // Read arguments.
+    const auto filename = program.get<std::string>("filename");
+    const auto dataset_name = split(filename, '/').back();
+    const auto key_type = program.get<std::string>("key_type");
+    const auto layer1 = program.get<std::string>("layer1");
+    const auto layer2 = program.get<std::string>("layer2");
+    const auto n_models = program.get<std::size_t>("n_models");
+    const auto bound_type = program.get<std::string>("bound_type");
+    const auto search = program.get<std::string>("search");
+    const auto n_reps = program.get<std::size_t>("-n");
+    const auto n_samples = program.get<std::size_t>("-s");
+    const auto workload = program.get<std::string>("-w");
+
+    // Load keys.
+    auto keys = load_data<uint64_t>(filename);
+
+    // Lookup experiment.
+    Config config{key_type, layer1, layer2, bound_type, search};
+    if (exp_map.find(config) == exp_map.end()) {
+        std::cerr << "Error: " << key_type << ',' << layer1 << ',' << layer2 << ',' << bound_type << ',' << search << " is not a valid configuration." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    exp_fn_ptr exp_fn = exp_map[config];
+
+    // Output header.
+    if (program["--header"]  == true)
+        std::cout << "dataset,"
+                  << "n_keys,"
+                  << "key_type,"
+                  << "key_size,"
+                  << "layer1,"
+                  << "layer2,"
+                  << "n_models,"
+                  << "bounds,"
+                  << "search,"
+                  << "size_in_bytes,"
+                  << "rep,"
+                  << "n_samples,"
+                  << "workload,"
+                  << "lookup_time,"
+                  << "lookup_accu"
+                  << std::endl;
+
+    // Run experiment.
+    (*exp_fn)(keys, n_models, n_samples, n_reps, dataset_name, key_type, layer1, layer2, bound_type, search, workload);
+
+    exit(EXIT_SUCCESS);
+}
@@ -3,14 +3,24 @@
 
 #include "argparse/argparse.hpp"
 
+#include "rmi/adaptive_rmi.hpp"
+#include "rmi/exact_rmi.hpp"
+#include "rmi/index.hpp"
 #include "rmi/models.hpp"
 #include "rmi/rmi.hpp"
+#include "rmi/util/allocator.hpp"
 #include "rmi/util/fn.hpp"
+#include "rmi/util/perf.hpp"
 #include "rmi/util/search.hpp"
+#include "rmi/util/stree.hpp"
+#include "rmi/util/workload.hpp"
 
 using key_type = uint64_t;
+using allocator_type = HugePageAllocator<key_type>;
 using namespace std::chrono;
 
+constexpr std::size_t batch_size = 64; ///< number of keys searched at once in batched lookups
+
 std::size_t s_glob; ///< global size_t variable
 
 
@@ -21,44 +31,91 @@ std::size_t s_glob; ///< global size_t variable
  * @tparam Search search type
  * @param keys on which the RMI is built
  * @param n_models number of models in the second layer of the RMI
- * @param samples for which the lookup time is measured
+ * @param alloc allocator for the RMI
+ * @param samples for which the lookup time is measured, lower bounds in case of range queries
+ * @param upper upper bounds of range queries, empty in case of point queries
  * @param n_reps number of repetitions
  * @param dataset_name name of the dataset
  * @param layer1 model type of the first layer
  * @param layer2 model type of the second layer
  * @param bound_type used by the RMI
  * @param search used by the RMI for correction prediction errors
+ * @param workload name of the workload the samples were drawn from
+ * @param page_size name of the page size backing keys and RMI
+ * @param numa name of the NUMA policy applied to keys and RMI
+ * @param layout name of the layout of layer2
+ * @param batched whether point queries compute the search bounds of a batch of keys at once
+ * @param stree_overhead size of the S-tree as fraction of the size of the keys, if @p Search uses one
  */
 template<typename Key, typename Rmi, typename Search>
-void experiment(const std::vector<key_type> &keys,
+void experiment(const std::vector<key_type, allocator_type> &keys,
                 const std::size_t n_models,
+                const allocator_type &alloc,
                 const std::vector<key_type> &samples,
+                const std::vector<key_type> &upper,
                 const std::size_t n_reps,
                 const std::string dataset_name,
                 const std::string layer1,
                 const std::string layer2,
                 const std::string bound_type,
-                const std::string search)
+                const std::string search,
+                const std::string workload,
+                const std::string page_size,
+                const std::string numa,
+                const std::string layout,
+                const bool batched,
+                const double stree_overhead)
 {
-    using rmi_type = Rmi;
-    auto search_fn = Search();
+    using index_type = rmi::Index<Key, Rmi, Search, allocator_type>;
+
+    // Build auxiliary layout of the keys, if any, which counts towards the index size.
+    auto search_fn = [&]() {
+        if constexpr (std::is_same_v<Search, STreeSearch<Key>>) return Search(keys.data(), keys.size(), stree_overhead);
+        else if constexpr (std::is_same_v<Search, CacheLineSearch<Key>>) return Search(keys.data(), keys.size());
+        else return Search();
+    }();
+    std::size_t aux_size = 0;
+    if constexpr (std::is_same_v<Search, STreeSearch<Key>>) aux_size = search_fn.tree().size_in_bytes();
 
     // Build RMI.
-    rmi_type rmi(keys, n_models);
+    index_type index(keys, n_models, false, alloc, search_fn);
+    const auto &rmi = index.rmi();
+    auto dtlb_counter = PerfCounter::dtlb_load_misses();
 
     // Perform n_reps runs.
     for (std::size_t rep = 0; rep != n_reps; ++rep) {
 
         // Lookup time.
         std::size_t lookup_accu = 0;
+        dtlb_counter.start();
         auto start = steady_clock::now();
-        for (std::size_t i = 0; i != samples.size(); ++i) {
-            auto key = samples.at(i);
-            auto range = rmi.search(key);
-            auto pos = search_fn(keys.begin() + range.lo, keys.begin() + range.hi, keys.begin() + range.pos, key);
-            lookup_accu += std::distance(keys.begin(), pos);
+        if (upper.empty() and not batched) { // point queries
+            for (std::size_t i = 0; i != samples.size(); ++i) {
+                auto key = samples.at(i);
+                auto range = rmi.search(key);
+                auto pos = search_fn(keys.begin() + range.lo, keys.begin() + range.hi, keys.begin() + range.pos, key);
+                lookup_accu += std::distance(keys.begin(), pos);
+            }
+        } else if (upper.empty()) { // batched point queries
+            rmi::Approx ranges[batch_size];
+            for (std::size_t batch = 0; batch < samples.size(); batch += batch_size) {
+                std::size_t batch_end = std::min(samples.size(), batch + batch_size);
+                rmi.search(samples.begin() + batch, samples.begin() + batch_end, ranges);
+                for (std::size_t i = batch; i != batch_end; ++i) {
+                    auto key = samples[i];
+                    auto range = ranges[i - batch];
+                    auto pos = search_fn(keys.begin() + range.lo, keys.begin() + range.hi, keys.begin() + range.pos, key);
+                    lookup_accu += std::distance(keys.begin(), pos);
+                }
+            }
+        } else { // range queries
+            for (std::size_t i = 0; i != samples.size(); ++i) {
+                auto [first, last] = index.range(samples.at(i), upper.at(i));
+                lookup_accu += std::distance(first, last);
+            }
         }
         auto stop = steady_clock::now();
+        auto dtlb_misses = dtlb_counter.stop();
         auto lookup_time = duration_cast<nanoseconds>(stop - start).count();
         s_glob = lookup_accu;
 
@@ -72,12 +129,18 @@ void experiment(const std::vector<key_type> &keys,
                   << n_models << ','
                   << bound_type << ','
                   << search << ','
-                  << rmi.size_in_bytes() << ','
+                  << rmi.size_in_bytes() + aux_size << ','
                   // Experiment
                   << rep << ','
                   << samples.size() << ','
+                  << workload << ','
+                  << page_size << ','
+                  << numa << ','
+                  << layout << ','
+                  << (batched ? "batched" : "scalar") << ','
                   // Results
                   << lookup_time << ','
+                  << dtlb_misses << ','
                   // Checksums
                   << lookup_accu << std::endl;
     } // reps
@@ -87,25 +150,34 @@ void experiment(const std::vector<key_type> &keys,
 /**
  * @brief experiment function pointer
  */
-typedef void (*exp_fn_ptr)(const std::vector<key_type>&,
+typedef void (*exp_fn_ptr)(const std::vector<key_type, allocator_type>&,
                            const std::size_t,
+                           const allocator_type&,
+                           const std::vector<key_type>&,
                            const std::vector<key_type>&,
                            const std::size_t,
                            const std::string,
                            const std::string,
                            const std::string,
                            const std::string,
-                           const std::string);
+                           const std::string,
+                           const std::string,
+                           const std::string,
+                           const std::string,
+                           const std::string,
+                           const bool,
+                           const double);
 
 /**
- * RMI configuration that holds the string representation of model types of layer 1 and layer 2, error bound type, and
- * search algorithm.
+ * RMI configuration that holds the string representation of model types of layer 1 and layer 2, error bound type,
+ * search algorithm, and layout of layer 2.
  */
 struct Config {
     std::string layer1;
     std::string layer2;
     std::string bound_type;
     std::string search;
+    std::string layout;
 };
 
 /**
@@ -116,53 +188,128 @@ struct ConfigCompare {
         if (lhs.layer1 != rhs.layer1) return lhs.layer1 < rhs.layer1;
         if (lhs.layer2 != rhs.layer2) return lhs.layer2 < rhs.layer2;
         if (lhs.bound_type != rhs.bound_type) return lhs.bound_type < rhs.bound_type;
-        return lhs.search < rhs.search;
+        if (lhs.search != rhs.search) return lhs.search < rhs.search;
+        return lhs.layout < rhs.layout;
     }
 };
 
 #define ENTRIES(L1, L2, LT1, LT2) \
-    { {#L1, #L2, "none", "binary"}, &experiment<key_type, rmi::Rmi<key_type, LT1, LT2>, BinarySearch> }, \
-    { {#L1, #L2, "labs", "binary"}, &experiment<key_type, rmi::RmiLAbs<key_type, LT1, LT2>, BinarySearch> }, \
-    { {#L1, #L2, "lind", "binary"}, &experiment<key_type, rmi::RmiLInd<key_type, LT1, LT2>, BinarySearch> }, \
-    { {#L1, #L2, "gabs", "binary"}, &experiment<key_type, rmi::RmiGAbs<key_type, LT1, LT2>, BinarySearch> }, \
-    { {#L1, #L2, "gind", "binary"}, &experiment<key_type, rmi::RmiGInd<key_type, LT1, LT2>, BinarySearch> }, \
-    { {#L1, #L2, "none", "model_biased_binary"}, &experiment<key_type, rmi::Rmi<key_type, LT1, LT2>, ModelBiasedBinarySearch> }, \
-    { {#L1, #L2, "labs", "model_biased_binary"}, &experiment<key_type, rmi::RmiLAbs<key_type, LT1, LT2>, ModelBiasedBinarySearch> }, \
-    { {#L1, #L2, "lind", "model_biased_binary"}, &experiment<key_type, rmi::RmiLInd<key_type, LT1, LT2>, ModelBiasedBinarySearch> }, \
-    { {#L1, #L2, "gabs", "model_biased_binary"}, &experiment<key_type, rmi::RmiGAbs<key_type, LT1, LT2>, ModelBiasedBinarySearch> }, \
-    { {#L1, #L2, "gind", "model_biased_binary"}, &experiment<key_type, rmi::RmiGInd<key_type, LT1, LT2>, ModelBiasedBinarySearch> }, \
-    { {#L1, #L2, "none", "linear"}, &experiment<key_type, rmi::Rmi<key_type, LT1, LT2>, LinearSearch> }, \
-    { {#L1, #L2, "labs", "linear"}, &experiment<key_type, rmi::RmiLAbs<key_type, LT1, LT2>, LinearSearch> }, \
-    { {#L1, #L2, "lind", "linear"}, &experiment<key_type, rmi::RmiLInd<key_type, LT1, LT2>, LinearSearch> }, \
-    { {#L1, #L2, "gabs", "linear"}, &experiment<key_type, rmi::RmiGAbs<key_type, LT1, LT2>, LinearSearch> }, \
-    { {#L1, #L2, "gind", "linear"}, &experiment<key_type, rmi::RmiGInd<key_type, LT1, LT2>, LinearSearch> }, \
-    { {#L1, #L2, "none", "model_biased_linear"}, &experiment<key_type, rmi::Rmi<key_type, LT1, LT2>, ModelBiasedLinearSearch> }, \
-    { {#L1, #L2, "labs", "model_biased_linear"}, &experiment<key_type, rmi::RmiLAbs<key_type, LT1, LT2>, ModelBiasedLinearSearch> }, \
-    { {#L1, #L2, "lind", "model_biased_linear"}, &experiment<key_type, rmi::RmiLInd<key_type, LT1, LT2>, ModelBiasedLinearSearch> }, \
-    { {#L1, #L2, "gabs", "model_biased_linear"}, &experiment<key_type, rmi::RmiGAbs<key_type, LT1, LT2>, ModelBiasedLinearSearch> }, \
-    { {#L1, #L2, "gind", "model_biased_linear"}, &experiment<key_type, rmi::RmiGInd<key_type, LT1, LT2>, ModelBiasedLinearSearch> }, \
-    { {#L1, #L2, "none", "exponential"}, &experiment<key_type, rmi::Rmi<key_type, LT1, LT2>, ExponentialSearch> }, \
-    { {#L1, #L2, "labs", "exponential"}, &experiment<key_type, rmi::RmiLAbs<key_type, LT1, LT2>, ExponentialSearch> }, \
-    { {#L1, #L2, "lind", "exponential"}, &experiment<key_type, rmi::RmiLInd<key_type, LT1, LT2>, ExponentialSearch> }, \
-    { {#L1, #L2, "gabs", "exponential"}, &experiment<key_type, rmi::RmiGAbs<key_type, LT1, LT2>, ExponentialSearch> }, \
-    { {#L1, #L2, "gind", "exponential"}, &experiment<key_type, rmi::RmiGInd<key_type, LT1, LT2>, ExponentialSearch> }, \
-    { {#L1, #L2, "none", "model_biased_exponential"}, &experiment<key_type, rmi::Rmi<key_type, LT1, LT2>, ModelBiasedExponentialSearch> }, \
-    { {#L1, #L2, "labs", "model_biased_exponential"}, &experiment<key_type, rmi::RmiLAbs<key_type, LT1, LT2>, ModelBiasedExponentialSearch> }, \
-    { {#L1, #L2, "lind", "model_biased_exponential"}, &experiment<key_type, rmi::RmiLInd<key_type, LT1, LT2>, ModelBiasedExponentialSearch> }, \
-    { {#L1, #L2, "gabs", "model_biased_exponential"}, &experiment<key_type, rmi::RmiGAbs<key_type, LT1, LT2>, ModelBiasedExponentialSearch> }, \
-    { {#L1, #L2, "gind", "model_biased_exponential"}, &experiment<key_type, rmi::RmiGInd<key_type, LT1, LT2>, ModelBiasedExponentialSearch> }, \
+    { {#L1, #L2, "none", "binary", "aos"}, &experiment<key_type, rmi::Rmi<key_type, LT1, LT2, allocator_type>, BinarySearch> }, \
+    { {#L1, #L2, "labs", "binary", "aos"}, &experiment<key_type, rmi::RmiLAbs<key_type, LT1, LT2, allocator_type>, BinarySearch> }, \
+    { {#L1, #L2, "lind", "binary", "aos"}, &experiment<key_type, rmi::RmiLInd<key_type, LT1, LT2, allocator_type>, BinarySearch> }, \
+    { {#L1, #L2, "gabs", "binary", "aos"}, &experiment<key_type, rmi::RmiGAbs<key_type, LT1, LT2, allocator_type>, BinarySearch> }, \
+    { {#L1, #L2, "gind", "binary", "aos"}, &experiment<key_type, rmi::RmiGInd<key_type, LT1, LT2, allocator_type>, BinarySearch> }, \
+    { {#L1, #L2, "adaptive", "binary", "aos"}, &experiment<key_type, rmi::RmiAdaptive<key_type, LT1, LT2, allocator_type>, BinarySearch> }, \
+    { {#L1, #L2, "none", "model_biased_binary", "aos"}, &experiment<key_type, rmi::Rmi<key_type, LT1, LT2, allocator_type>, ModelBiasedBinarySearch> }, \
+    { {#L1, #L2, "labs", "model_biased_binary", "aos"}, &experiment<key_type, rmi::RmiLAbs<key_type, LT1, LT2, allocator_type>, ModelBiasedBinarySearch> }, \
+    { {#L1, #L2, "lind", "model_biased_binary", "aos"}, &experiment<key_type, rmi::RmiLInd<key_type, LT1, LT2, allocator_type>, ModelBiasedBinarySearch> }, \
+    { {#L1, #L2, "gabs", "model_biased_binary", "aos"}, &experiment<key_type, rmi::RmiGAbs<key_type, LT1, LT2, allocator_type>, ModelBiasedBinarySearch> }, \
+    { {#L1, #L2, "gind", "model_biased_binary", "aos"}, &experiment<key_type, rmi::RmiGInd<key_type, LT1, LT2, allocator_type>, ModelBiasedBinarySearch> }, \
+    { {#L1, #L2, "adaptive", "model_biased_binary", "aos"}, &experiment<key_type, rmi::RmiAdaptive<key_type, LT1, LT2, allocator_type>, ModelBiasedBinarySearch> }, \
+    { {#L1, #L2, "none", "linear", "aos"}, &experiment<key_type, rmi::Rmi<key_type, LT1, LT2, allocator_type>, LinearSearch> }, \
+    { {#L1, #L2, "labs", "linear", "aos"}, &experiment<key_type, rmi::RmiLAbs<key_type, LT1, LT2, allocator_type>, LinearSearch> }, \
+    { {#L1, #L2, "lind", "linear", "aos"}, &experiment<key_type, rmi::RmiLInd<key_type, LT1, LT2, allocator_type>, LinearSearch> }, \
+    { {#L1, #L2, "gabs", "linear", "aos"}, &experiment<key_type, rmi::RmiGAbs<key_type, LT1, LT2, allocator_type>, LinearSearch> }, \
+    { {#L1, #L2, "gind", "linear", "aos"}, &experiment<key_type, rmi::RmiGInd<key_type, LT1, LT2, allocator_type>, LinearSearch> }, \
+    { {#L1, #L2, "none", "model_biased_linear", "aos"}, &experiment<key_type, rmi::Rmi<key_type, LT1, LT2, allocator_type>, ModelBiasedLinearSearch> }, \
+    { {#L1, #L2, "labs", "model_biased_linear", "aos"}, &experiment<key_type, rmi::RmiLAbs<key_type, LT1, LT2, allocator_type>, ModelBiasedLinearSearch> }, \
+    { {#L1, #L2, "lind", "model_biased_linear", "aos"}, &experiment<key_type, rmi::RmiLInd<key_type, LT1, LT2, allocator_type>, ModelBiasedLinearSearch> }, \
+    { {#L1, #L2, "gabs", "model_biased_linear", "aos"}, &experiment<key_type, rmi::RmiGAbs<key_type, LT1, LT2, allocator_type>, ModelBiasedLinearSearch> }, \
+    { {#L1, #L2, "gind", "model_biased_linear", "aos"}, &experiment<key_type, rmi::RmiGInd<key_type, LT1, LT2, allocator_type>, ModelBiasedLinearSearch> }, \
+    { {#L1, #L2, "none", "exponential", "aos"}, &experiment<key_type, rmi::Rmi<key_type, LT1, LT2, allocator_type>, ExponentialSearch> }, \
+    { {#L1, #L2, "labs", "exponential", "aos"}, &experiment<key_type, rmi::RmiLAbs<key_type, LT1, LT2, allocator_type>, ExponentialSearch> }, \
+    { {#L1, #L2, "lind", "exponential", "aos"}, &experiment<key_type, rmi::RmiLInd<key_type, LT1, LT2, allocator_type>, ExponentialSearch> }, \
+    { {#L1, #L2, "gabs", "exponential", "aos"}, &experiment<key_type, rmi::RmiGAbs<key_type, LT1, LT2, allocator_type>, ExponentialSearch> }, \
+    { {#L1, #L2, "gind", "exponential", "aos"}, &experiment<key_type, rmi::RmiGInd<key_type, LT1, LT2, allocator_type>, ExponentialSearch> }, \
+    { {#L1, #L2, "none", "model_biased_exponential", "aos"}, &experiment<key_type, rmi::Rmi<key_type, LT1, LT2, allocator_type>, ModelBiasedExponentialSearch> }, \
+    { {#L1, #L2, "labs", "model_biased_exponential", "aos"}, &experiment<key_type, rmi::RmiLAbs<key_type, LT1, LT2, allocator_type>, ModelBiasedExponentialSearch> }, \
+    { {#L1, #L2, "lind", "model_biased_exponential", "aos"}, &experiment<key_type, rmi::RmiLInd<key_type, LT1, LT2, allocator_type>, ModelBiasedExponentialSearch> }, \
+    { {#L1, #L2, "gabs", "model_biased_exponential", "aos"}, &experiment<key_type, rmi::RmiGAbs<key_type, LT1, LT2, allocator_type>, ModelBiasedExponentialSearch> }, \
+    { {#L1, #L2, "gind", "model_biased_exponential", "aos"}, &experiment<key_type, rmi::RmiGInd<key_type, LT1, LT2, allocator_type>, ModelBiasedExponentialSearch> }, \
+    { {#L1, #L2, "labs", "cache_line", "aos"}, &experiment<key_type, rmi::RmiLAbs<key_type, LT1, LT2, allocator_type>, CacheLineSearch<key_type>> }, \
+    { {#L1, #L2, "lind", "cache_line", "aos"}, &experiment<key_type, rmi::RmiLInd<key_type, LT1, LT2, allocator_type>, CacheLineSearch<key_type>> }, \
+    { {#L1, #L2, "gabs", "cache_line", "aos"}, &experiment<key_type, rmi::RmiGAbs<key_type, LT1, LT2, allocator_type>, CacheLineSearch<key_type>> }, \
+    { {#L1, #L2, "gind", "cache_line", "aos"}, &experiment<key_type, rmi::RmiGInd<key_type, LT1, LT2, allocator_type>, CacheLineSearch<key_type>> }, \
+    { {#L1, #L2, "none", "stree", "aos"}, &experiment<key_type, rmi::Rmi<key_type, LT1, LT2, allocator_type>, STreeSearch<key_type>> }, \
+    { {#L1, #L2, "gabs", "stree", "aos"}, &experiment<key_type, rmi::RmiGAbs<key_type, LT1, LT2, allocator_type>, STreeSearch<key_type>> }, \
+    { {#L1, #L2, "gind", "stree", "aos"}, &experiment<key_type, rmi::RmiGInd<key_type, LT1, LT2, allocator_type>, STreeSearch<key_type>> }, \
+
+#define MONOTONIC_ENTRIES(L1, L2, LT1, LT2) \
+    ENTRIES(L1, L2, LT1, LT2) \
+    { {#L1, #L2, "exact", "binary", "aos"}, &experiment<key_type, rmi::RmiExact<key_type, LT1, LT2, allocator_type>, BinarySearch> }, \
+    { {#L1, #L2, "exact", "exact", "aos"}, &experiment<key_type, rmi::RmiExact<key_type, LT1, LT2, allocator_type>, ExactSearch<>> }, \
+
+#define SOA_ENTRIES(L1, L2, LT1, LT2) \
+    { {#L1, #L2, "none", "model_biased_linear", "soa"}, &experiment<key_type, rmi::Rmi<key_type, LT1, LT2, allocator_type, rmi::SoaStorage>, ModelBiasedLinearSearch> }, \
+    { {#L1, #L2, "none", "model_biased_exponential", "soa"}, &experiment<key_type, rmi::Rmi<key_type, LT1, LT2, allocator_type, rmi::SoaStorage>, ModelBiasedExponentialSearch> }, \
+    { {#L1, #L2, "gabs", "binary", "soa"}, &experiment<key_type, rmi::RmiGAbs<key_type, LT1, LT2, allocator_type, rmi::SoaStorage>, BinarySearch> }, \
+    { {#L1, #L2, "gind", "binary", "soa"}, &experiment<key_type, rmi::RmiGInd<key_type, LT1, LT2, allocator_type, rmi::SoaStorage>, BinarySearch> }, \
+    { {#L1, #L2, "gind", "model_biased_binary", "soa"}, &experiment<key_type, rmi::RmiGInd<key_type, LT1, LT2, allocator_type, rmi::SoaStorage>, ModelBiasedBinarySearch> }, \
+    { {#L1, #L2, "labs", "binary", "soa"}, &experiment<key_type, rmi::RmiLAbs<key_type, LT1, LT2, allocator_type, rmi::SoaStorage>, BinarySearch> }, \
+    { {#L1, #L2, "lind", "binary", "soa"}, &experiment<key_type, rmi::RmiLInd<key_type, LT1, LT2, allocator_type, rmi::SoaStorage>, BinarySearch> }, \
+    { {#L1, #L2, "lind", "model_biased_binary", "soa"}, &experiment<key_type, rmi::RmiLInd<key_type, LT1, LT2, allocator_type, rmi::SoaStorage>, ModelBiasedBinarySearch> }, \
 
 static std::map<Config, exp_fn_ptr, ConfigCompare> exp_map {
-    ENTRIES(linear_regression, linear_regression, rmi::LinearRegression, rmi::LinearRegression)
-    ENTRIES(linear_regression, linear_spline,     rmi::LinearRegression, rmi::LinearSpline)
-    ENTRIES(linear_spline,     linear_regression, rmi::LinearSpline,     rmi::LinearRegression)
-    ENTRIES(linear_spline,     linear_spline,     rmi::LinearSpline,     rmi::LinearSpline)
-    ENTRIES(cubic_spline,      linear_regression, rmi::CubicSpline,      rmi::LinearRegression)
-    ENTRIES(cubic_spline,      linear_spline,     rmi::CubicSpline,      rmi::LinearSpline)
-    ENTRIES(radix,             linear_regression, rmi::Radix<key_type>,  rmi::LinearRegression)
-    ENTRIES(radix,             linear_spline,     rmi::Radix<key_type>,  rmi::LinearSpline)
+    MONOTONIC_ENTRIES(linear_regression, linear_regression, rmi::LinearRegression, rmi::LinearRegression)
+    MONOTONIC_ENTRIES(linear_regression, linear_spline,     rmi::LinearRegression, rmi::LinearSpline)
+    MONOTONIC_ENTRIES(linear_spline,     linear_regression, rmi::LinearSpline,     rmi::LinearRegression)
+    MONOTONIC_ENTRIES(linear_spline,     linear_spline,     rmi::LinearSpline,     rmi::LinearSpline)
+    MONOTONIC_ENTRIES(cubic_spline,      linear_regression, rmi::CubicSpline,      rmi::LinearRegression)
+    MONOTONIC_ENTRIES(cubic_spline,      linear_spline,     rmi::CubicSpline,      rmi::LinearSpline)
+    MONOTONIC_ENTRIES(radix,             linear_regression, rmi::Radix<key_type>,  rmi::LinearRegression)
+    MONOTONIC_ENTRIES(radix,             linear_spline,     rmi::Radix<key_type>,  rmi::LinearSpline)
+    MONOTONIC_ENTRIES(radix_table,       linear_regression, rmi::RadixTable<key_type>, rmi::LinearRegression)
+    MONOTONIC_ENTRIES(radix_table,       linear_spline,     rmi::RadixTable<key_type>, rmi::LinearSpline)
+    MONOTONIC_ENTRIES(piecewise_cdf,     linear_regression, rmi::PiecewiseCdf<>,   rmi::LinearRegression)
+    MONOTONIC_ENTRIES(piecewise_cdf,     linear_spline,     rmi::PiecewiseCdf<>,   rmi::LinearSpline)
+    MONOTONIC_ENTRIES(normal,            linear_regression, rmi::NormalCdf,        rmi::LinearRegression)
+    MONOTONIC_ENTRIES(normal,            linear_spline,     rmi::NormalCdf,        rmi::LinearSpline)
+    MONOTONIC_ENTRIES(lognormal,         linear_regression, rmi::LogNormalCdf,     rmi::LinearRegression)
+    MONOTONIC_ENTRIES(lognormal,         linear_spline,     rmi::LogNormalCdf,     rmi::LinearSpline)
+    ENTRIES(linear_regression, pla,               rmi::LinearRegression, rmi::PiecewiseLinear<key_type>)
+    ENTRIES(linear_spline,     pla,               rmi::LinearSpline,     rmi::PiecewiseLinear<key_type>)
+    ENTRIES(cubic_spline,      pla,               rmi::CubicSpline,      rmi::PiecewiseLinear<key_type>)
+    ENTRIES(radix,             pla,               rmi::Radix<key_type>,  rmi::PiecewiseLinear<key_type>)
+    ENTRIES(radix_table,       pla,               rmi::RadixTable<key_type>, rmi::PiecewiseLinear<key_type>)
+    ENTRIES(piecewise_cdf,     pla,               rmi::PiecewiseCdf<>,   rmi::PiecewiseLinear<key_type>)
+    ENTRIES(normal,            pla,               rmi::NormalCdf,        rmi::PiecewiseLinear<key_type>)
+    ENTRIES(lognormal,         pla,               rmi::LogNormalCdf,     rmi::PiecewiseLinear<key_type>)
+    MONOTONIC_ENTRIES(linear_regression, auto,              rmi::LinearRegression, rmi::AutoLinear)
+    MONOTONIC_ENTRIES(linear_spline,     auto,              rmi::LinearSpline,     rmi::AutoLinear)
+    MONOTONIC_ENTRIES(cubic_spline,      auto,              rmi::CubicSpline,      rmi::AutoLinear)
+    MONOTONIC_ENTRIES(radix,             auto,              rmi::Radix<key_type>,  rmi::AutoLinear)
+    MONOTONIC_ENTRIES(radix_table,       auto,              rmi::RadixTable<key_type>, rmi::AutoLinear)
+    MONOTONIC_ENTRIES(piecewise_cdf,     auto,              rmi::PiecewiseCdf<>,   rmi::AutoLinear)
+    MONOTONIC_ENTRIES(normal,            auto,              rmi::NormalCdf,        rmi::AutoLinear)
+    MONOTONIC_ENTRIES(lognormal,         auto,              rmi::LogNormalCdf,     rmi::AutoLinear)
+    SOA_ENTRIES(linear_regression, linear_regression, rmi::LinearRegression, rmi::LinearRegression)
+    SOA_ENTRIES(linear_spline,     linear_regression, rmi::LinearSpline,     rmi::LinearRegression)
+    SOA_ENTRIES(cubic_spline,      linear_regression, rmi::CubicSpline,      rmi::LinearRegression)
+    SOA_ENTRIES(radix,             linear_regression, rmi::Radix<key_type>,  rmi::LinearRegression)
+    SOA_ENTRIES(radix_table,       linear_regression, rmi::RadixTable<key_type>, rmi::LinearRegression)
+    SOA_ENTRIES(piecewise_cdf,     linear_regression, rmi::PiecewiseCdf<>,   rmi::LinearRegression)
+    SOA_ENTRIES(normal,            linear_regression, rmi::NormalCdf,        rmi::LinearRegression)
+    SOA_ENTRIES(lognormal,         linear_regression, rmi::LogNormalCdf,     rmi::LinearRegression)
+    SOA_ENTRIES(linear_regression, linear_spline,     rmi::LinearRegression, rmi::LinearSpline)
+    SOA_ENTRIES(linear_spline,     linear_spline,     rmi::LinearSpline,     rmi::LinearSpline)
+    SOA_ENTRIES(cubic_spline,      linear_spline,     rmi::CubicSpline,      rmi::LinearSpline)
+    SOA_ENTRIES(radix,             linear_spline,     rmi::Radix<key_type>,  rmi::LinearSpline)
+    SOA_ENTRIES(radix_table,       linear_spline,     rmi::RadixTable<key_type>, rmi::LinearSpline)
+    SOA_ENTRIES(piecewise_cdf,     linear_spline,     rmi::PiecewiseCdf<>,   rmi::LinearSpline)
+    SOA_ENTRIES(normal,            linear_spline,     rmi::NormalCdf,        rmi::LinearSpline)
+    SOA_ENTRIES(lognormal,         linear_spline,     rmi::LogNormalCdf,     rmi::LinearSpline)
+    SOA_ENTRIES(linear_regression, auto,              rmi::LinearRegression, rmi::AutoLinear)
+    SOA_ENTRIES(linear_spline,     auto,              rmi::LinearSpline,     rmi::AutoLinear)
+    SOA_ENTRIES(cubic_spline,      auto,              rmi::CubicSpline,      rmi::AutoLinear)
+    SOA_ENTRIES(radix,             auto,              rmi::Radix<key_type>,  rmi::AutoLinear)
+    SOA_ENTRIES(radix_table,       auto,              rmi::RadixTable<key_type>, rmi::AutoLinear)
+    SOA_ENTRIES(piecewise_cdf,     auto,              rmi::PiecewiseCdf<>,   rmi::AutoLinear)
+    SOA_ENTRIES(normal,            auto,              rmi::NormalCdf,        rmi::AutoLinear)
+    SOA_ENTRIES(lognormal,         auto,              rmi::LogNormalCdf,     rmi::AutoLinear)
 }; ///< Map that assigns an experiment function pointer to RMI configurations.
 #undef ENTRIES
+#undef MONOTONIC_ENTRIES
+#undef SOA_ENTRIES
 
 
 /**
@@ -180,20 +327,21 @@ int main(int argc, char *argv[])
         .help("path to binary file containing uin64_t keys");
 
     program.add_argument("layer1")
-        .help("layer1 model type, either linear_regression, linear_spline, cubic_spline, or radix.");
+        .help("layer1 model type, either linear_regression, linear_spline, cubic_spline, radix, radix_table, "
+              "piecewise_cdf, normal, or lognormal.");
 
     program.add_argument("layer2")
-        .help("layer2 model type, either linear_regression, linear_spline, or cubic_spline.");
+        .help("layer2 model type, either linear_regression, linear_spline, cubic_spline, pla, or auto.");
 
     program.add_argument("n_models")
         .help("number of models on layer2, power of two is recommended.")
         .action([](const std::string &s) { return std::stoul(s); });
 
     program.add_argument("bound_type")
-        .help("type of error bounds used, either none, labs, lind, gabs, or gind.");
+        .help("type of error bounds used, either none, labs, lind, gabs, gind, adaptive, or exact.");
 
     program.add_argument("search")
-        .help("search algorithm for error correction, either binary, model_biased_binary, exponential, model_biased_exponential, linear, or model_biased_linear.");
+        .help("search algorithm for error correction, either binary, model_biased_binary, exponential, model_biased_exponential, linear, model_biased_linear, cache_line (bounded RMIs only), stree (none, gabs, and gind only), or exact (exact bounds only).");
 
    program.add_argument("-n", "--n_reps")
         .help("number of experiment repetitions")
@@ -205,6 +353,41 @@ int main(int argc, char *argv[])
         .default_value(std::size_t(1'000'000))
         .action([](const std::string &s) { return std::stoul(s); });
 
+    program.add_argument("-w", "--workload")
+        .help("lookup workload, either uniform, zipf, hotset, absent, out_of_range, sorted, clustered, or range")
+        .default_value(std::string("uniform"));
+
+    program.add_argument("--selectivity")
+        .help("fraction of keys selected by each query of the range workload")
+        .default_value(0.0001)
+        .action([](const std::string &s) { return std::stod(s); });
+
+    program.add_argument("--page_size")
+        .help("page size backing keys and RMI, either regular, 2mb, or 1gb")
+        .default_value(std::string("regular"));
+
+    program.add_argument("--numa")
+        .help("NUMA policy applied to keys and RMI, either none, bind, or interleave")
+        .default_value(std::string("none"));
+
+    program.add_argument("--numa_nodes")
+        .help("comma-separated list of NUMA nodes the policy refers to")
+        .default_value(std::string("0"));
+
+    program.add_argument("--layout")
+        .help("layout of layer2, either aos (array of models) or soa (array per parameter, linear and cubic models only)")
+        .default_value(std::string("aos"));
+
+    program.add_argument("--batched")
+        .help("compute the search bounds of point queries in batches")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("--stree_overhead")
+        .help("size of the S-tree of the stree search as fraction of the size of the keys")
+        .default_value(0.125)
+        .action([](const std::string &s) { return std::stod(s); });
+
     program.add_argument("--header")
         .help("output csv header")
         .default_value(false)
@@ -229,27 +412,59 @@ int main(int argc, char *argv[])
     const auto search = program.get<std::string>("search");
     const auto n_reps = program.get<std::size_t>("-n");
     const auto n_samples = program.get<std::size_t>("-s");
+    const auto workload = program.get<std::string>("-w");
+    const auto selectivity = program.get<double>("--selectivity");
+    const auto page_size = program.get<std::string>("--page_size");
+    const auto numa = program.get<std::string>("--numa");
+    const auto numa_nodes = program.get<std::string>("--numa_nodes");
+    const auto layout = program.get<std::string>("--layout");
+    const bool batched = program["--batched"] == true;
+    const auto stree_overhead = program.get<double>("--stree_overhead");
+
+    // Configure allocator.
+    std::map<std::string, PageSize> page_sizes {
+        {"regular", PageSize::regular}, {"2mb", PageSize::huge_2mb}, {"1gb", PageSize::huge_1gb} };
+    std::map<std::string, NumaPolicy> numa_policies {
+        {"none", NumaPolicy::none}, {"bind", NumaPolicy::bind}, {"interleave", NumaPolicy::interleave} };
+    if (page_sizes.find(page_size) == page_sizes.end() or numa_policies.find(numa) == numa_policies.end()) {
+        std::cerr << "Error: " << page_size << ',' << numa << " is not a valid page size and NUMA policy." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    uint64_t node_mask = 0;
+    for (auto &node : split(numa_nodes, ',')) node_mask |= 1UL << std::stoul(node);
+    allocator_type alloc(page_sizes[page_size], numa_policies[numa], node_mask);
 
     // Load keys.
     auto keys = load_data<key_type>(filename);
 
     // Sample keys.
     uint64_t seed = 42;
-    std::mt19937 gen(seed);
-    std::uniform_int_distribution<> distrib(0, keys.size() - 1);
     std::vector<key_type> samples;
-    samples.reserve(n_samples);
-    for (std::size_t i = 0; i != n_samples; ++i)
-        samples.push_back(keys[distrib(gen)]);
+    std::vector<key_type> upper;
+    if (workload == "range") {
+        auto ranges = range_workload(keys, n_samples, selectivity, seed);
+        samples.reserve(n_samples);
+        upper.reserve(n_samples);
+        for (auto [lo, hi] : ranges) {
+            samples.push_back(lo);
+            upper.push_back(hi);
+        }
+    } else {
+        samples = generate_workload(keys, workload, n_samples, seed);
+    }
 
     // Lookup experiment.
-    Config config{layer1, layer2, bound_type, search};
+    Config config{layer1, layer2, bound_type, search, layout};
     if (exp_map.find(config) == exp_map.end()) {
-        std::cerr << "Error: " << layer1 << ',' << layer2 << ',' << bound_type << ',' << search << " is not a valid RMI configuration." << std::endl;
+        std::cerr << "Error: " << layer1 << ',' << layer2 << ',' << bound_type << ',' << search << ',' << layout << " is not a valid RMI configuration." << std::endl;
         exit(EXIT_FAILURE);
     }
     exp_fn_ptr exp_fn = exp_map[config];
 
+    // Move keys to memory of the configured allocator.
+    std::vector<key_type, allocator_type> data(keys.begin(), keys.end(), alloc);
+    keys = std::vector<key_type>();
+
     // Output header.
     if (program["--header"]  == true)
         std::cout << "dataset,"
@@ -262,12 +477,19 @@ int main(int argc, char *argv[])
                   << "size_in_bytes,"
                   << "rep,"
                   << "n_samples,"
+                  << "workload,"
+                  << "page_size,"
+                  << "numa,"
+                  << "layout,"
+                  << "lookup_mode,"
                   << "lookup_time,"
+                  << "dtlb_misses,"
                   << "lookup_accu,"
                   << std::endl;
 
     // Run experiment.
-    (*exp_fn)(keys, n_models, samples, n_reps, dataset_name, layer1, layer2, bound_type, search);
+    (*exp_fn)(data, n_models, alloc, samples, upper, n_reps, dataset_name, layer1, layer2, bound_type, search, workload,
+              page_size, numa, layout, batched, stree_overhead);
 
     exit(EXIT_SUCCESS);
 }
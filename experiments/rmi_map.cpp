@@ -0,0 +1,272 @@
+#include <chrono>
+#include <numeric>
+
+#include "argparse/argparse.hpp"
+
+#include "rmi/map.hpp"
+#include "rmi/models.hpp"
+#include "rmi/rmi.hpp"
+#include "rmi/util/fn.hpp"
+#include "rmi/util/search.hpp"
+#include "rmi/util/workload.hpp"
+
+using key_type = uint64_t;
+using value_type = uint64_t;
+using namespace std::chrono;
+
+std::size_t s_glob; ///< global size_t variable
+
+
+/**
+ * Measures lookup times of @p samples on an RMI map that stores @p keys and their positions as values according to a
+ * given storage layout and writes results to `std::cout`.
+ * @tparam Map RMI map type
+ * @param keys on which the RMI is built
+ * @param n_models number of models in the second layer of the RMI
+ * @param samples used for measuring the lookup time
+ * @param n_reps number of repetitions
+ * @param dataset_name name of the dataset
+ * @param layout name of the storage layout
+ * @param layer1 model type of the first layer
+ * @param layer2 model type of the second layer
+ * @param bound_type used by the RMI
+ * @param search used by the RMI for correction prediction errors
+ * @param workload name of the workload the samples were drawn from
+ */
+template<typename Map>
+void experiment(const std::vector<key_type> &keys,
+                const std::size_t n_models,
+                const std::vector<key_type> &samples,
+                const std::size_t n_reps,
+                const std::string dataset_name,
+                const std::string layout,
+                const std::string layer1,
+                const std::string layer2,
+                const std::string bound_type,
+                const std::string search,
+                const std::string workload)
+{
+    using map_type = Map;
+
+    // Build map with positions as values.
+    std::vector<value_type> values(keys.size());
+    std::iota(values.begin(), values.end(), 0);
+    map_type map(keys, values, n_models);
+
+    // Perform n_reps runs.
+    for (std::size_t rep = 0; rep != n_reps; ++rep) {
+
+        // Lookup time.
+        std::size_t lookup_accu = 0;
+        auto start = steady_clock::now();
+        for (std::size_t i = 0; i != samples.size(); ++i) {
+            auto value = map.find(samples[i]);
+            lookup_accu += value ? *value : 0;
+        }
+        auto stop = steady_clock::now();
+        auto lookup_time = duration_cast<nanoseconds>(stop - start).count();
+        s_glob = lookup_accu;
+
+        // Report results.
+                  // Dataset
+        std::cout << dataset_name << ','
+                  << keys.size() << ','
+                  // Index
+                  << layout << ','
+                  << layer1 << ','
+                  << layer2 << ','
+                  << n_models << ','
+                  << bound_type << ','
+                  << search << ','
+                  << map.size_in_bytes() << ','
+                  // Experiment
+                  << rep << ','
+                  << samples.size() << ','
+                  << workload << ','
+                  // Results
+                  << lookup_time << ','
+                  // Checksums
+                  << lookup_accu << std::endl;
+    } // reps
+}
+
+
+/**
+ * @brief experiment function pointer
+ */
+typedef void (*exp_fn_ptr)(const std::vector<key_type>&,
+                           const std::size_t,
+                           const std::vector<key_type>&,
+                           const std::size_t,
+                           const std::string,
+                           const std::string,
+                           const std::string,
+                           const std::string,
+                           const std::string,
+                           const std::string,
+                           const std::string);
+
+/**
+ * RMI map configuration that holds the string representation of the storage layout, model types of layer 1 and layer
+ * 2, error bound type, and search algorithm.
+ */
+struct Config {
+    std::string layout;
+    std::string layer1;
+    std::string layer2;
+    std::string bound_type;
+    std::string search;
+};
+
+/**
+ * Comparator class for @p Config objects.
+ */
+struct ConfigCompare {
+    bool operator() (const Config &lhs, const Config &rhs) const {
+        if (lhs.layout != rhs.layout) return lhs.layout < rhs.layout;
+        if (lhs.layer1 != rhs.layer1) return lhs.layer1 < rhs.layer1;
+        if (lhs.layer2 != rhs.layer2) return lhs.layer2 < rhs.layer2;
+        if (lhs.bound_type != rhs.bound_type) return lhs.bound_type < rhs.bound_type;
+        return lhs.search < rhs.search;
+    }
+};
+
+#define ENTRIES(L, LAYOUT, L1, L2, LT1, LT2) \
+    { {#L, #L1, #L2, "none", "model_biased_exponential"}, &experiment<rmi::RmiMap<key_type, value_type, rmi::Rmi<key_type, LT1, LT2>, ModelBiasedExponentialSearch, LAYOUT>> }, \
+    { {#L, #L1, #L2, "labs", "binary"}, &experiment<rmi::RmiMap<key_type, value_type, rmi::RmiLAbs<key_type, LT1, LT2>, BinarySearch, LAYOUT>> }, \
+    { {#L, #L1, #L2, "lind", "model_biased_binary"}, &experiment<rmi::RmiMap<key_type, value_type, rmi::RmiLInd<key_type, LT1, LT2>, ModelBiasedBinarySearch, LAYOUT>> }, \
+    { {#L, #L1, #L2, "gabs", "binary"}, &experiment<rmi::RmiMap<key_type, value_type, rmi::RmiGAbs<key_type, LT1, LT2>, BinarySearch, LAYOUT>> }, \
+    { {#L, #L1, #L2, "gind", "model_biased_binary"}, &experiment<rmi::RmiMap<key_type, value_type, rmi::RmiGInd<key_type, LT1, LT2>, ModelBiasedBinarySearch, LAYOUT>> },
+
+#define LAYOUT_ENTRIES(L, LAYOUT) \
+    ENTRIES(L, LAYOUT, linear_spline, linear_regression, rmi::LinearSpline,     rmi::LinearRegression) \
+    ENTRIES(L, LAYOUT, linear_spline, linear_spline,     rmi::LinearSpline,     rmi::LinearSpline) \
+    ENTRIES(L, LAYOUT, cubic_spline,  linear_regression, rmi::CubicSpline,      rmi::LinearRegression) \
+    ENTRIES(L, LAYOUT, cubic_spline,  linear_spline,     rmi::CubicSpline,      rmi::LinearSpline) \
+    ENTRIES(L, LAYOUT, radix,         linear_regression, rmi::Radix<key_type>,  rmi::LinearRegression) \
+    ENTRIES(L, LAYOUT, radix,         linear_spline,     rmi::Radix<key_type>,  rmi::LinearSpline) \
+    ENTRIES(L, LAYOUT, radix_table,   linear_regression, rmi::RadixTable<key_type>, rmi::LinearRegression) \
+    ENTRIES(L, LAYOUT, radix_table,   linear_spline,     rmi::RadixTable<key_type>, rmi::LinearSpline)
+
+static std::map<Config, exp_fn_ptr, ConfigCompare> exp_map {
+    LAYOUT_ENTRIES(separate,    rmi::SeparateLayout)
+    LAYOUT_ENTRIES(interleaved, rmi::InterleavedLayout)
+    LAYOUT_ENTRIES(blocked,     rmi::BlockedLayout)
+}; ///< Map that assigns an experiment function pointer to storage layouts and RMI configurations.
+#undef LAYOUT_ENTRIES
+#undef ENTRIES
+
+
+/**
+ * Triggers measurement of lookup times for a storage layout and an RMI configuration provided via command line
+ * arguments.
+ * @param argc arguments counter
+ * @param argv arguments vector
+ */
+int main(int argc, char *argv[])
+{
+    // Initialize argument parser.
+    argparse::ArgumentParser program(argv[0], "0.1");
+
+    // Define arguments.
+    program.add_argument("filename")
+        .help("path to binary file containing uin64_t keys");
+
+    program.add_argument("layout")
+        .help("storage layout of keys and values, either separate, interleaved, or blocked.");
+
+    program.add_argument("layer1")
+        .help("layer1 model type, either linear_spline, cubic_spline, radix, or radix_table.");
+
+    program.add_argument("layer2")
+        .help("layer2 model type, either linear_regression or linear_spline.");
+
+    program.add_argument("n_models")
+        .help("number of models on layer2, power of two is recommended.")
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("bound_type")
+        .help("type of error bounds used, either none, labs, lind, gabs, or gind.");
+
+    program.add_argument("search")
+        .help("search algorithm for error correction, model_biased_exponential for none, binary for labs and gabs, and model_biased_binary for lind and gind.");
+
+    program.add_argument("-n", "--n_reps")
+        .help("number of experiment repetitions")
+        .default_value(std::size_t(3))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("-s", "--n_samples")
+        .help("number of sampled lookup keys")
+        .default_value(std::size_t(1'000'000))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("-w", "--workload")
+        .help("lookup workload, either uniform, zipf, hotset, absent, out_of_range, sorted, or clustered")
+        .default_value(std::string("uniform"));
+
+    program.add_argument("--header")
+        .help("output csv header")
+        .default_value(false)
+        .implicit_value(true);
+
+    // Parse arguments.
+    try {
+        program.parse_args(argc, argv);
+    }
+    catch (const std::runtime_error &err) {
+        std::cout << err.what() << '\n' << program;
+        exit(EXIT_FAILURE);
+    }
+
+    // Read arguments.
+    const auto filename = program.get<std::string>("filename");
+    const auto dataset_name = split(filename, '/').back();
+    const auto layout = program.get<std::string>("layout");
+    const auto layer1 = program.get<std::string>("layer1");
+    const auto layer2 = program.get<std::string>("layer2");
+    const auto n_models = program.get<std::size_t>("n_models");
+    const auto bound_type = program.get<std::string>("bound_type");
+    const auto search = program.get<std::string>("search");
+    const auto n_reps = program.get<std::size_t>("-n");
+    const auto n_samples = program.get<std::size_t>("-s");
+    const auto workload = program.get<std::string>("-w");
+
+    // Load keys.
+    auto keys = load_data<key_type>(filename);
+
+    // Sample keys.
+    uint64_t seed = 42;
+    auto samples = generate_workload(keys, workload, n_samples, seed);
+
+    // Lookup experiment.
+    Config config{layout, layer1, layer2, bound_type, search};
+    if (exp_map.find(config) == exp_map.end()) {
+        std::cerr << "Error: " << layout << ',' << layer1 << ',' << layer2 << ',' << bound_type << ',' << search << " is not a valid configuration." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    exp_fn_ptr exp_fn = exp_map[config];
+
+    // Output header.
+    if (program["--header"]  == true)
+        std::cout << "dataset,"
+                  << "n_keys,"
+                  << "layout,"
+                  << "layer1,"
+                  << "layer2,"
+                  << "n_models,"
+                  << "bounds,"
+                  << "search,"
+                  << "size_in_bytes,"
+                  << "rep,"
+                  << "n_samples,"
+                  << "workload,"
+                  << "lookup_time,"
+                  << "lookup_accu"
+                  << std::endl;
+
+    // Run experiment.
+    (*exp_fn)(keys, n_models, samples, n_reps, dataset_name, layout, layer1, layer2, bound_type, search, workload);
+
+    exit(EXIT_SUCCESS);
+}
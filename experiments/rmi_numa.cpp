@@ -0,0 +1,242 @@
+#include <chrono>
+#include <numeric>
+
+#include "argparse/argparse.hpp"
+
+#include "rmi/index.hpp"
+#include "rmi/models.hpp"
+#include "rmi/replicated_index.hpp"
+#include "rmi/rmi.hpp"
+#include "rmi/util/allocator.hpp"
+#include "rmi/util/fn.hpp"
+#include "rmi/util/numa.hpp"
+#include "rmi/util/search.hpp"
+#include "rmi/util/workload.hpp"
+
+using key_type = uint64_t;
+using allocator_type = HugePageAllocator<key_type>;
+using rmi_type = rmi::RmiLAbs<key_type, rmi::LinearSpline, rmi::LinearRegression, allocator_type>;
+using index_type = rmi::Index<key_type, rmi_type, BinarySearch, allocator_type>;
+using replicated_type = rmi::ReplicatedIndex<key_type, rmi_type, BinarySearch>;
+using namespace std::chrono;
+
+std::size_t s_glob; ///< global size_t variable
+
+
+/**
+ * Returns the CPUs of all @p nodes in round-robin order over the nodes such that consecutive threads are spread across
+ * nodes.
+ * @param nodes NUMA nodes
+ * @return vector of CPUs
+ */
+std::vector<int> interleave_cpus(const std::vector<NumaNode> &nodes)
+{
+    std::vector<int> cpus;
+    for (std::size_t i = 0, added = 1; added; ++i) {
+        added = 0;
+        for (auto &node : nodes) {
+            if (i < node.cpus.size()) {
+                cpus.push_back(node.cpus[i]);
+                ++added;
+            }
+        }
+    }
+    return cpus;
+}
+
+
+/**
+ * Performs lookups of @p samples on @p n_threads threads pinned to @p cpus, each thread on the index returned by @p
+ * index_fn, and returns the elapsed time and the checksum.
+ * @tparam IndexFn the type of the function that returns the index to use for the calling thread
+ * @param samples lookup keys
+ * @param n_threads number of threads
+ * @param cpus CPUs the threads are pinned to in round-robin order
+ * @param index_fn function that returns the index to use for the calling thread
+ * @return pair of lookup time in nanoseconds and checksum
+ */
+template<typename IndexFn>
+std::pair<std::size_t, std::size_t> lookup(const std::vector<key_type> &samples,
+                                           const std::size_t n_threads,
+                                           const std::vector<int> &cpus,
+                                           IndexFn index_fn)
+{
+    std::vector<std::size_t> accus(n_threads);
+    auto start = steady_clock::now();
+    parallel_for(samples.size(), n_threads, [&](std::size_t thread_id, std::size_t begin, std::size_t end) {
+        pin_thread({cpus[thread_id % cpus.size()]});
+        const index_type &index = index_fn();
+        std::size_t accu = 0;
+        for (std::size_t i = begin; i != end; ++i)
+            accu += std::distance(index.begin(), index.lower_bound(samples[i]));
+        accus[thread_id] = accu;
+    });
+    auto stop = steady_clock::now();
+    return {duration_cast<nanoseconds>(stop - start).count(), std::accumulate(accus.begin(), accus.end(), 0UL)};
+}
+
+
+/**
+ * Measures multi-threaded lookup throughput on a single shared index and on indexes replicated per NUMA node, with
+ * and without replicated keys, and writes results to `std::cout`.
+ * @param keys on which the indexes are built
+ * @param n_models number of models in the second layer of the RMI
+ * @param samples used for measuring the lookup time
+ * @param n_threads number of threads
+ * @param n_reps number of repetitions
+ * @param page_size page size backing indexes and keys
+ * @param dataset_name name of the dataset
+ * @param workload name of the workload the samples were drawn from
+ */
+void experiment(const std::vector<key_type> &keys,
+                const std::size_t n_models,
+                const std::vector<key_type> &samples,
+                const std::size_t n_threads,
+                const std::size_t n_reps,
+                const PageSize page_size,
+                const std::string dataset_name,
+                const std::string workload)
+{
+    auto nodes = numa_nodes();
+    auto cpus = interleave_cpus(nodes);
+
+    auto report = [&](const std::string &mode, std::size_t size_in_bytes, std::size_t rep,
+                      std::pair<std::size_t, std::size_t> result) {
+                  // Dataset
+        std::cout << dataset_name << ','
+                  << keys.size() << ','
+                  // Index
+                  << n_models << ','
+                  << mode << ','
+                  << size_in_bytes << ','
+                  // Experiment
+                  << nodes.size() << ','
+                  << n_threads << ','
+                  << rep << ','
+                  << samples.size() << ','
+                  << workload << ','
+                  // Results
+                  << result.first << ','
+                  // Checksums
+                  << result.second << std::endl;
+    };
+
+    // Single copy built and first touched by the main thread.
+    {
+        allocator_type alloc(page_size);
+        std::vector<key_type, allocator_type> data(keys.begin(), keys.end(), alloc);
+        index_type index(data, n_models, false, alloc);
+        for (std::size_t rep = 0; rep != n_reps; ++rep)
+            report("shared", index.size_in_bytes(), rep,
+                   lookup(samples, n_threads, cpus, [&]() -> const index_type& { return index; }));
+    }
+
+    // One replica per node with keys interleaved across nodes or replicated per node.
+    for (bool replicate_keys : {false, true}) {
+        replicated_type index(keys, n_models, replicate_keys, page_size);
+        for (std::size_t rep = 0; rep != n_reps; ++rep)
+            report(replicate_keys ? "replicated" : "replicated_rmi", index.size_in_bytes(), rep,
+                   lookup(samples, n_threads, cpus, [&]() -> const index_type& { return index.local(); }));
+    }
+}
+
+
+/**
+ * Triggers measurement of multi-threaded lookup throughput of shared and NUMA-replicated indexes for an RMI
+ * configuration provided via command line arguments.
+ * @param argc arguments counter
+ * @param argv arguments vector
+ */
+int main(int argc, char *argv[])
+{
+    // Initialize argument parser.
+    argparse::ArgumentParser program(argv[0], "0.1");
+
+    // Define arguments.
+    program.add_argument("filename")
+        .help("path to binary file containing uin64_t keys");
+
+    program.add_argument("n_models")
+        .help("number of models on layer2, power of two is recommended.")
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("-t", "--n_threads")
+        .help("number of lookup threads")
+        .default_value(std::size_t(std::max(1U, std::thread::hardware_concurrency())))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("-n", "--n_reps")
+        .help("number of experiment repetitions")
+        .default_value(std::size_t(3))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("-s", "--n_samples")
+        .help("number of sampled lookup keys")
+        .default_value(std::size_t(1'000'000))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("-w", "--workload")
+        .help("lookup workload, either uniform, zipf, hotset, absent, out_of_range, sorted, or clustered")
+        .default_value(std::string("uniform"));
+
+    program.add_argument("--huge_pages")
+        .help("back indexes and keys with 2 MiB huge pages")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("--header")
+        .help("output csv header")
+        .default_value(false)
+        .implicit_value(true);
+
+    // Parse arguments.
+    try {
+        program.parse_args(argc, argv);
+    }
+    catch (const std::runtime_error &err) {
+        std::cout << err.what() << '\n' << program;
+        exit(EXIT_FAILURE);
+    }
+
+    // Read arguments.
+    const auto filename = program.get<std::string>("filename");
+    const auto dataset_name = split(filename, '/').back();
+    const auto n_models = program.get<std::size_t>("n_models");
+    const auto n_threads = program.get<std::size_t>("-t");
+    if (n_threads == 0) {
+        std::cerr << "Error: the number of threads must be positive." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    const auto n_reps = program.get<std::size_t>("-n");
+    const auto n_samples = program.get<std::size_t>("-s");
+    const auto workload = program.get<std::string>("-w");
+    const auto page_size = program["--huge_pages"] == true ? PageSize::huge_2mb : PageSize::regular;
+
+    // Load keys.
+    auto keys = load_data<key_type>(filename);
+
+    // Sample keys.
+    uint64_t seed = 42;
+    auto samples = generate_workload(keys, workload, n_samples, seed);
+
+    // Output header.
+    if (program["--header"]  == true)
+        std::cout << "dataset,"
+                  << "n_keys,"
+                  << "n_models,"
+                  << "mode,"
+                  << "size_in_bytes,"
+                  << "n_nodes,"
+                  << "n_threads,"
+                  << "rep,"
+                  << "n_samples,"
+                  << "workload,"
+                  << "lookup_time,"
+                  << "lookup_accu"
+                  << std::endl;
+
+    // Run experiment.
+    experiment(keys, n_models, samples, n_threads, n_reps, page_size, dataset_name, workload);
+
+    exit(EXIT_SUCCESS);
+}
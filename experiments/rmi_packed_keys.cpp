@@ -0,0 +1,296 @@
+#include <chrono>
+
+#include "argparse/argparse.hpp"
+
+#include "rmi/index.hpp"
+#include "rmi/models.hpp"
+#include "rmi/packed_index.hpp"
+#include "rmi/rmi.hpp"
+#include "rmi/util/allocator.hpp"
+#include "rmi/util/fn.hpp"
+#include "rmi/util/workload.hpp"
+
+using key_type = uint64_t;
+using allocator_type = HugePageAllocator<key_type>;
+using namespace std::chrono;
+
+std::size_t s_glob; ///< global size_t variable
+
+
+/**
+ * Measures lookup times of @p samples on @p index, which stores keys of size @p keys_size, and writes results to
+ * `std::cout`.
+ * @tparam Index index type
+ * @tparam Lookup lookup function type
+ * @param index the index
+ * @param lookup returns the position of the lower bound of a key in @p index
+ * @param keys_size size of the keys in bytes
+ * @param samples for which the lookup time is measured
+ * @param n_reps number of repetitions
+ * @param workload name of the workload the samples were drawn from
+ * @param storage name of the storage of the keys
+ * @param config the leading columns of the output, i.e. dataset and RMI configuration
+ */
+template<typename Index, typename Lookup>
+void measure(const Index &index,
+             Lookup lookup,
+             const std::size_t keys_size,
+             const std::vector<key_type> &samples,
+             const std::size_t n_reps,
+             const std::string workload,
+             const std::string storage,
+             const std::string config)
+{
+    for (std::size_t rep = 0; rep != n_reps; ++rep) {
+
+        // Lookup time.
+        std::size_t lookup_accu = 0;
+        auto start = steady_clock::now();
+        for (std::size_t i = 0; i != samples.size(); ++i) lookup_accu += lookup(index, samples[i]);
+        auto stop = steady_clock::now();
+        auto lookup_time = duration_cast<nanoseconds>(stop - start).count();
+        s_glob = lookup_accu;
+
+        // Report results.
+        std::cout << config << ','
+                  << index.size_in_bytes() << ','
+                  << storage << ','
+                  << keys_size << ','
+                  // Experiment
+                  << rep << ','
+                  << samples.size() << ','
+                  << workload << ','
+                  // Results
+                  << lookup_time << ','
+                  // Checksums
+                  << lookup_accu << std::endl;
+    }
+}
+
+
+/**
+ * Measures the size of the keys and the lookup times of @p samples on a given @p Rmi once bound to the plain keys and
+ * once bound to compressed keys, and writes results to `std::cout`.
+ * @tparam Key key type
+ * @tparam Rmi RMI type
+ * @param keys on which the RMI is built
+ * @param n_models number of models in the second layer of the RMI
+ * @param alloc allocator for the RMI and the compressed keys
+ * @param samples for which the lookup time is measured
+ * @param n_reps number of repetitions
+ * @param dataset_name name of the dataset
+ * @param layer1 model type of the first layer
+ * @param layer2 model type of the second layer
+ * @param bound_type used by the RMI
+ * @param workload name of the workload the samples were drawn from
+ */
+template<typename Key, typename Rmi>
+void experiment(const std::vector<key_type, allocator_type> &keys,
+                const std::size_t n_models,
+                const allocator_type &alloc,
+                const std::vector<key_type> &samples,
+                const std::size_t n_reps,
+                const std::string dataset_name,
+                const std::string layer1,
+                const std::string layer2,
+                const std::string bound_type,
+                const std::string workload)
+{
+    std::string config = dataset_name + ',' + std::to_string(keys.size()) + ',' + layer1 + ',' + layer2 + ',' +
+                         std::to_string(n_models) + ',' + bound_type;
+
+    {
+        rmi::Index<Key, Rmi, BinarySearch, allocator_type> index(keys, n_models, false, alloc);
+        auto lookup = [](const auto &index, const key_type key) {
+            return std::size_t(std::distance(index.begin(), index.lower_bound(key)));
+        };
+        measure(index, lookup, keys.size() * sizeof(key_type), samples, n_reps, workload, "plain", config);
+    }
+    {
+        rmi::PackedIndex<Key, Rmi> index(keys, n_models, false, alloc);
+        auto lookup = [](const auto &index, const key_type key) { return index.lower_bound(key); };
+        measure(index, lookup, index.keys().size_in_bytes(), samples, n_reps, workload, "packed", config);
+    }
+}
+
+
+/**
+ * @brief experiment function pointer
+ */
+typedef void (*exp_fn_ptr)(const std::vector<key_type, allocator_type>&,
+                           const std::size_t,
+                           const allocator_type&,
+                           const std::vector<key_type>&,
+                           const std::size_t,
+                           const std::string,
+                           const std::string,
+                           const std::string,
+                           const std::string,
+                           const std::string);
+
+/**
+ * RMI configuration that holds the string representation of model types of layer 1 and layer 2 and the error bound
+ * type.
+ */
+struct Config {
+    std::string layer1;
+    std::string layer2;
+    std::string bound_type;
+};
+
+/**
+ * Comparator class for @p Config objects.
+ */
+struct ConfigCompare {
+    bool operator() (const Config &lhs, const Config &rhs) const {
+        if (lhs.layer1 != rhs.layer1) return lhs.layer1 < rhs.layer1;
+        if (lhs.layer2 != rhs.layer2) return lhs.layer2 < rhs.layer2;
+        return lhs.bound_type < rhs.bound_type;
+    }
+};
+
+#define ENTRIES(L1, L2, T1, T2) \
+    { {#L1, #L2, "none"}, &experiment<key_type, rmi::Rmi<key_type, T1, T2, allocator_type>> }, \
+    { {#L1, #L2, "labs"}, &experiment<key_type, rmi::RmiLAbs<key_type, T1, T2, allocator_type>> }, \
+    { {#L1, #L2, "lind"}, &experiment<key_type, rmi::RmiLInd<key_type, T1, T2, allocator_type>> }, \
+    { {#L1, #L2, "gabs"}, &experiment<key_type, rmi::RmiGAbs<key_type, T1, T2, allocator_type>> }, \
+    { {#L1, #L2, "gind"}, &experiment<key_type, rmi::RmiGInd<key_type, T1, T2, allocator_type>> },
+
+static std::map<Config, exp_fn_ptr, ConfigCompare> exp_map {
+    ENTRIES(linear_regression, linear_regression, rmi::LinearRegression, rmi::LinearRegression)
+    ENTRIES(linear_regression, linear_spline,     rmi::LinearRegression, rmi::LinearSpline)
+    ENTRIES(linear_spline,     linear_regression, rmi::LinearSpline,     rmi::LinearRegression)
+    ENTRIES(linear_spline,     linear_spline,     rmi::LinearSpline,     rmi::LinearSpline)
+    ENTRIES(cubic_spline,      linear_regression, rmi::CubicSpline,      rmi::LinearRegression)
+    ENTRIES(cubic_spline,      linear_spline,     rmi::CubicSpline,      rmi::LinearSpline)
+    ENTRIES(radix,             linear_regression, rmi::Radix<key_type>,  rmi::LinearRegression)
+    ENTRIES(radix,             linear_spline,     rmi::Radix<key_type>,  rmi::LinearSpline)
+    ENTRIES(radix_table,       linear_regression, rmi::RadixTable<key_type>, rmi::LinearRegression)
+    ENTRIES(radix_table,       linear_spline,     rmi::RadixTable<key_type>, rmi::LinearSpline)
+}; ///< Map that assigns an experiment function pointer to RMI configurations.
+#undef ENTRIES
+
+
+/**
+ * Triggers measurement of key sizes and lookup times on plain and compressed keys for an RMI configuration provided
+ * via command line arguments.
+ * @param argc arguments counter
+ * @param argv arguments vector
+ */
+int main(int argc, char *argv[])
+{
+    // Initialize argument parser.
+    argparse::ArgumentParser program(argv[0], "0.1");
+
+    // Define arguments.
+    program.add_argument("filename")
+        .help("path to binary file containing uin64_t keys");
+
+    program.add_argument("layer1")
+        .help("layer1 model type, either linear_regression, linear_spline, cubic_spline, radix, or radix_table.");
+
+    program.add_argument("layer2")
+        .help("layer2 model type, either linear_regression or linear_spline.");
+
+    program.add_argument("n_models")
+        .help("number of models on layer2, power of two is recommended.")
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("bound_type")
+        .help("type of error bounds used, either none, labs, lind, gabs, or gind.");
+
+    program.add_argument("-n", "--n_reps")
+        .help("number of experiment repetitions")
+        .default_value(std::size_t(3))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("-s", "--n_samples")
+        .help("number of sampled lookup keys")
+        .default_value(std::size_t(1'000'000))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("-w", "--workload")
+        .help("lookup workload, either uniform, zipf, hotset, absent, out_of_range, sorted, or clustered")
+        .default_value(std::string("uniform"));
+
+    program.add_argument("--page_size")
+        .help("page size backing keys, RMI, and compressed keys, either regular, 2mb, or 1gb")
+        .default_value(std::string("regular"));
+
+    program.add_argument("--header")
+        .help("output csv header")
+        .default_value(false)
+        .implicit_value(true);
+
+    // Parse arguments.
+    try {
+        program.parse_args(argc, argv);
+    }
+    catch (const std::runtime_error &err) {
+        std::cout << err.what() << '\n' << program;
+        exit(EXIT_FAILURE);
+    }
+
+    // Read arguments.
+    const auto filename = program.get<std::string>("filename");
+    const auto dataset_name = split(filename, '/').back();
+    const auto layer1 = program.get<std::string>("layer1");
+    const auto layer2 = program.get<std::string>("layer2");
+    const auto n_models = program.get<std::size_t>("n_models");
+    const auto bound_type = program.get<std::string>("bound_type");
+    const auto n_reps = program.get<std::size_t>("-n");
+    const auto n_samples = program.get<std::size_t>("-s");
+    const auto workload = program.get<std::string>("-w");
+    const auto page_size = program.get<std::string>("--page_size");
+
+    // Configure allocator.
+    std::map<std::string, PageSize> page_sizes {
+        {"regular", PageSize::regular}, {"2mb", PageSize::huge_2mb}, {"1gb", PageSize::huge_1gb} };
+    if (page_sizes.find(page_size) == page_sizes.end()) {
+        std::cerr << "Error: " << page_size << " is not a valid page size." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    allocator_type alloc(page_sizes[page_size]);
+
+    // Load keys.
+    auto keys = load_data<key_type>(filename);
+
+    // Sample keys.
+    uint64_t seed = 42;
+    auto samples = generate_workload(keys, workload, n_samples, seed);
+
+    // Lookup experiment.
+    Config config{layer1, layer2, bound_type};
+    if (exp_map.find(config) == exp_map.end()) {
+        std::cerr << "Error: " << layer1 << ',' << layer2 << ',' << bound_type <<  " is not a valid RMI configuration." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    exp_fn_ptr exp_fn = exp_map[config];
+
+    // Move keys to memory of the configured allocator.
+    std::vector<key_type, allocator_type> data(keys.begin(), keys.end(), alloc);
+    keys = std::vector<key_type>();
+
+    // Output header.
+    if (program["--header"]  == true)
+        std::cout << "dataset,"
+                  << "n_keys,"
+                  << "layer1,"
+                  << "layer2,"
+                  << "n_models,"
+                  << "bounds,"
+                  << "size_in_bytes,"
+                  << "storage,"
+                  << "keys_size_in_bytes,"
+                  << "rep,"
+                  << "n_samples,"
+                  << "workload,"
+                  << "lookup_time,"
+                  << "lookup_accu"
+                  << std::endl;
+
+    // Run experiment.
+    (*exp_fn)(data, n_models, alloc, samples, n_reps, dataset_name, layer1, layer2, bound_type, workload);
+
+    exit(EXIT_SUCCESS);
+}
@@ -72,6 +72,10 @@ static std::map<std::string, exp_fn_ptr> exp_map {
     ENTRY(linear_spline,     rmi::LinearSpline),
     ENTRY(cubic_spline,      rmi::CubicSpline),
     ENTRY(radix,             rmi::Radix<key_type>),
+    ENTRY(radix_table,       rmi::RadixTable<key_type>),
+    ENTRY(piecewise_cdf,     rmi::PiecewiseCdf<>),
+    ENTRY(normal,            rmi::NormalCdf),
+    ENTRY(lognormal,         rmi::LogNormalCdf),
 }; ///< Map that assigns an experiment function pointer to model types.
 #undef ENTRY
 
@@ -92,7 +96,7 @@ int main(int argc, char *argv[])
         .help("path to binary file containing uin64_t keys");
 
     program.add_argument("model")
-        .help("model type, either linear_regression, linear_spline, cubic_spline, or radix.");
+        .help("model type, either linear_regression, linear_spline, cubic_spline, radix, radix_table, piecewise_cdf, normal, or lognormal.");
 
     program.add_argument("n_segments")
         .help("number of segments, power of two is recommended.")
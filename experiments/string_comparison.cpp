@@ -0,0 +1,516 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+
+#include "argparse/argparse.hpp"
+
+#include "rmi/models.hpp"
+#include "rmi/rmi.hpp"
+#include "rmi/string_index.hpp"
+#include "rmi/util/fn.hpp"
+#include "rmi/util/search.hpp"
+#include "rmi/util/workload.hpp"
+
+#include "art/art.hpp"
+
+#include "tlx/container/btree_multimap.hpp"
+
+
+using namespace std::chrono;
+
+std::size_t s_glob; ///< global size_t variable
+
+
+/*======================================================================================================================
+ * Datasets
+ *====================================================================================================================*/
+
+/**
+ * Returns a random lowercase word with a length between @p min_length and @p max_length.
+ * @param gen random number generator
+ * @param min_length minimum length of the word
+ * @param max_length maximum length of the word
+ * @return random word
+ */
+std::string random_word(std::mt19937_64 &gen, const std::size_t min_length = 3, const std::size_t max_length = 10)
+{
+    std::uniform_int_distribution<std::size_t> length(min_length, max_length);
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::string word(length(gen), ' ');
+    for (auto &c : word) c = static_cast<char>(letter(gen));
+    return word;
+}
+
+/**
+ * Returns @p n random words whose sampling weights follow a Zipf distribution with exponent 1.
+ * @param n number of words
+ * @param gen random number generator
+ * @return pair of words and a distribution over their indices
+ */
+std::pair<std::vector<std::string>, std::discrete_distribution<std::size_t>> vocabulary(const std::size_t n,
+                                                                                        std::mt19937_64 &gen)
+{
+    std::vector<std::string> words(n);
+    std::vector<double> weights(n);
+    for (std::size_t i = 0; i != n; ++i) {
+        words[i] = random_word(gen);
+        weights[i] = 1.0 / (i + 1);
+    }
+    return {words, std::discrete_distribution<std::size_t>(weights.begin(), weights.end())};
+}
+
+
+/**
+ * URLs of the form `https://www.<domain>.<tld>/<path>` with skewed domains and one to three path segments.
+ */
+struct Urls {
+    std::vector<std::string> operator()(const std::size_t n_keys, std::mt19937_64 &gen) const {
+        const std::vector<std::string> tlds = { "com", "de", "io", "net", "org" };
+        auto [domains, domain] = vocabulary(100'000, gen);
+        std::uniform_int_distribution<std::size_t> tld(0, tlds.size() - 1);
+        std::uniform_int_distribution<std::size_t> n_segments(1, 3);
+        std::uniform_int_distribution<std::size_t> id(0, 999'999);
+
+        std::vector<std::string> keys(n_keys);
+        for (auto &key : keys) {
+            key = "https://www." + domains[domain(gen)] + '.' + tlds[tld(gen)];
+            for (std::size_t i = n_segments(gen); i != 0; --i) key += '/' + random_word(gen);
+            key += "?id=" + std::to_string(id(gen));
+        }
+        return keys;
+    }
+};
+
+/**
+ * Email addresses of the form `<first>.<last><number>@<domain>.com` with skewed first names and domains.
+ */
+struct Emails {
+    std::vector<std::string> operator()(const std::size_t n_keys, std::mt19937_64 &gen) const {
+        auto [first_names, first_name] = vocabulary(5'000, gen);
+        auto [domains, domain] = vocabulary(1'000, gen);
+        std::uniform_int_distribution<std::size_t> number(0, 9'999);
+
+        std::vector<std::string> keys(n_keys);
+        for (auto &key : keys)
+            key = first_names[first_name(gen)] + '.' + random_word(gen) + std::to_string(number(gen)) + '@'
+                + domains[domain(gen)] + ".com";
+        return keys;
+    }
+};
+
+
+/**
+ * Generates @p n_keys sorted string keys of the synthetic @p dataset.
+ * @param dataset name of the dataset, either urls or emails
+ * @param n_keys number of keys
+ * @param seed seed of the random number generator
+ * @return vector of sorted keys
+ */
+std::vector<std::string> generate_strings(const std::string &dataset, const std::size_t n_keys, const uint64_t seed)
+{
+    std::mt19937_64 gen(seed);
+    std::vector<std::string> keys;
+    if (dataset == "urls") {
+        keys = Urls()(n_keys, gen);
+    } else if (dataset == "emails") {
+        keys = Emails()(n_keys, gen);
+    } else {
+        std::cerr << "Error: " << dataset << " is not a valid dataset." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+/**
+ * Samples @p n_samples lookup keys according to @p workload, either uniform (drawn from @p keys) or absent (freshly
+ * generated keys of @p dataset that are not part of @p keys).
+ * @param keys sorted keys to sample from
+ * @param dataset name of the dataset
+ * @param workload name of the workload
+ * @param n_samples number of lookup keys
+ * @param seed seed of the random number generator
+ * @return vector of lookup keys
+ */
+std::vector<std::string> generate_string_workload(const std::vector<std::string> &keys,
+                                                  const std::string &dataset,
+                                                  const std::string &workload,
+                                                  const std::size_t n_samples,
+                                                  const uint64_t seed)
+{
+    if (workload == "uniform") return uniform_workload(keys, n_samples, seed);
+    if (workload != "absent") {
+        std::cerr << "Error: " << workload << " is not a valid workload for string keys." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    std::vector<std::string> samples;
+    samples.reserve(n_samples);
+    for (uint64_t round = 1; samples.size() < n_samples; ++round) {
+        auto candidates = generate_strings(dataset, n_samples, seed + round);
+        std::shuffle(candidates.begin(), candidates.end(), std::mt19937_64(seed));
+        for (auto &key : candidates) {
+            if (samples.size() == n_samples) break;
+            if (not std::binary_search(keys.begin(), keys.end(), key)) samples.push_back(std::move(key));
+        }
+    }
+    return samples;
+}
+
+
+/**
+ * Writes a result line to `std::cout`.
+ */
+void report(const std::string &dataset_name,
+            const std::size_t n_keys,
+            const std::string &index,
+            const std::string &config,
+            const std::size_t size_in_bytes,
+            const std::size_t rep,
+            const std::size_t n_samples,
+            const std::string &workload,
+            const long build_time,
+            const long lookup_time,
+            const std::size_t lookup_accu)
+{
+              // Dataset
+    std::cout << dataset_name << ','
+              << n_keys << ','
+              // Index
+              << index << ','
+              << "\"" << config << "\"" << ','
+              << size_in_bytes << ','
+              // Experiment
+              << rep << ','
+              << n_samples << ','
+              << workload << ','
+              // Results
+              << build_time << ','
+              << lookup_time << ','
+              // Checksums
+              << lookup_accu << std::endl;
+}
+
+
+/*======================================================================================================================
+ * Recursive Model Index
+ *====================================================================================================================*/
+
+/**
+ * Builds string indexes with recursive model indexes of different size on @p keys and performs @p n_reps of lookups on
+ * @p samples. Writes results including build time and lookup time to `std::cout`.
+ * @param keys on which the index is built
+ * @param samples used for measuring the lookup time
+ * @param n_reps number of repetitions
+ * @param dataset_name name of the dataset
+ * @param workload name of the workload the samples were drawn from
+ */
+void benchmark_rmi(const std::vector<std::string> &keys,
+                   const std::vector<std::string> &samples,
+                   const std::size_t n_reps,
+                   const std::string dataset_name,
+                   const std::string workload)
+{
+    using rmi_type = rmi::RmiLAbs<uint64_t, rmi::LinearSpline, rmi::LinearRegression>;
+
+    // Benchmark each configuration.
+    for (std::size_t k = 6; k <= 22; k += 2) {
+        std::size_t n_models = 1UL << k;
+
+        // Perform n_reps runs.
+        for (std::size_t rep = 0; rep != n_reps; ++rep) {
+
+            // Build time.
+            auto start = steady_clock::now();
+            rmi::StringIndex<rmi_type, BinarySearch> index(keys, n_models);
+            auto stop = steady_clock::now();
+            auto build_time = duration_cast<nanoseconds>(stop - start).count();
+
+            // Lookup time.
+            std::size_t lookup_accu = 0;
+            start = steady_clock::now();
+            for (std::size_t i = 0; i != samples.size(); ++i)
+                lookup_accu += index.lower_bound(samples[i]);
+            stop = steady_clock::now();
+            auto lookup_time = duration_cast<nanoseconds>(stop - start).count();
+            s_glob = lookup_accu;
+
+            // Report results.
+            report(dataset_name, keys.size(), "RMI-ours",
+                   "rmi::RmiLAbs,layer2_size=" + std::to_string(n_models) + ",prefix_skip="
+                   + std::to_string(index.common_prefix_length()),
+                   index.size_in_bytes(), rep, samples.size(), workload, build_time, lookup_time, lookup_accu);
+        } // rep
+    } // k
+}
+
+
+/*======================================================================================================================
+ * ART
+ *====================================================================================================================*/
+
+/**
+ * Builds an Adaptive Radix Tree on the 64-bit prefixes of @p keys and performs @p n_reps of lookups on @p samples. The
+ * ART only supports 64-bit integer keys, hence ties among keys sharing a prefix are resolved like in the string index.
+ * Writes results including build time and lookup time to `std::cout`.
+ * @param keys on which the index is built
+ * @param samples used for measuring the lookup time
+ * @param n_reps number of repetitions
+ * @param dataset_name name of the dataset
+ * @param workload name of the workload the samples were drawn from
+ */
+void benchmark_art(const std::vector<std::string> &keys,
+                   const std::vector<std::string> &samples,
+                   const std::size_t n_reps,
+                   const std::string dataset_name,
+                   const std::string workload)
+{
+    // Encode keys, the string index only serves for tie resolution.
+    rmi::StringIndex<rmi::RmiLAbs<uint64_t, rmi::LinearSpline, rmi::LinearRegression>> index(keys, 1);
+    auto &prefixes = index.prefixes();
+
+    // Prepare dataset.
+    std::vector<art::KeyValue<uint64_t, std::size_t>> dataset;
+    dataset.reserve(prefixes.size());
+    for (std::size_t i = 0; i != prefixes.size(); ++i)
+        dataset.push_back({prefixes[i], i});
+
+    // Perform n_reps runs.
+    for (std::size_t rep = 0; rep != n_reps; ++rep) {
+
+        // Build time.
+        auto start = steady_clock::now();
+        art::ART art(dataset);
+        auto stop = steady_clock::now();
+        auto build_time = duration_cast<nanoseconds>(stop - start).count();
+
+        // Lookup time.
+        std::size_t lookup_accu = 0;
+        start = steady_clock::now();
+        for (std::size_t i = 0; i != samples.size(); ++i) {
+            auto &key = samples[i];
+            auto prefix = index.encode(key);
+            auto res = art.search(prefix).first;
+            auto first = prefixes[res] < prefix ? prefixes.size() : res; // ART returns the last key if none is greater
+            lookup_accu += index.lower_bound(key, first);
+        }
+        stop = steady_clock::now();
+        auto lookup_time = duration_cast<nanoseconds>(stop - start).count();
+        s_glob = lookup_accu;
+
+        // Report results.
+        auto size_in_bytes = art.size_in_bytes() + prefixes.size() * sizeof(uint64_t)
+            + (keys.size() + 1) * sizeof(std::size_t);
+        report(dataset_name, keys.size(), "ART", "prefix_skip=" + std::to_string(index.common_prefix_length()),
+               size_in_bytes, rep, samples.size(), workload, build_time, lookup_time, lookup_accu);
+    } // rep
+}
+
+
+/*======================================================================================================================
+ * B-tree
+ *====================================================================================================================*/
+
+/**
+ * Builds a TLX B-tree on @p keys and performs @p n_reps of lookups on @p samples. Writes results including build time
+ * and lookup time to `std::cout`.
+ * @param keys on which the index is built
+ * @param samples used for measuring the lookup time
+ * @param n_reps number of repetitions
+ * @param dataset_name name of the dataset
+ * @param workload name of the workload the samples were drawn from
+ */
+void benchmark_tlx(const std::vector<std::string> &keys,
+                   const std::vector<std::string> &samples,
+                   const std::size_t n_reps,
+                   const std::string dataset_name,
+                   const std::string workload)
+{
+    // Prepare dataset.
+    std::vector<std::pair<std::string, std::size_t>> dataset;
+    dataset.reserve(keys.size());
+    for (std::size_t i = 0; i != keys.size(); ++i)
+        dataset.emplace_back(keys[i], i);
+
+    // Perform n_reps runs.
+    for (std::size_t rep = 0; rep != n_reps; ++rep) {
+
+        // Build time.
+        auto start = steady_clock::now();
+        tlx::btree_multimap<std::string, std::size_t> btree;
+        btree.bulk_load(dataset.begin(), dataset.end());
+        auto stop = steady_clock::now();
+        auto build_time = duration_cast<nanoseconds>(stop - start).count();
+
+        // Lookup time.
+        std::size_t lookup_accu = 0;
+        start = steady_clock::now();
+        for (std::size_t i = 0; i != samples.size(); ++i) {
+            auto it = btree.lower_bound(samples[i]);
+            lookup_accu += it == btree.end() ? keys.size() : it->second;
+        }
+        stop = steady_clock::now();
+        auto lookup_time = duration_cast<nanoseconds>(stop - start).count();
+        s_glob = lookup_accu;
+
+        // Compute size, the B-tree stores the keys itself so their characters are not accounted for.
+        auto stats = btree.get_stats();
+        auto inner_slots = stats.inner_slots;
+        auto n_inner_nodes = stats.inner_nodes;
+        auto inner_node_size = inner_slots * sizeof(std::string) + (inner_slots + 1) * sizeof(void*); // keys and pointers
+
+        auto leaf_slots = stats.leaf_slots;
+        auto n_leaves = stats.leaves;
+        auto leaf_size = 2 * sizeof(void*) + leaf_slots * (sizeof(std::string) + sizeof(uint64_t)); // prev/next + data
+
+        std::size_t size_in_bytes = inner_node_size * n_inner_nodes + leaf_size * n_leaves;
+
+        // Report results.
+        report(dataset_name, keys.size(), "BTree", "leaf_slots=" + std::to_string(leaf_slots), size_in_bytes, rep,
+               samples.size(), workload, build_time, lookup_time, lookup_accu);
+    } // rep
+}
+
+
+/*======================================================================================================================
+ * Binary search
+ *====================================================================================================================*/
+
+/**
+ * Performs @p n_reps of binary search lookups on @p samples in @p keys. Writes results including lookup time to
+ * `std::cout`.
+ * @param keys which are searched
+ * @param samples used for measuring the lookup time
+ * @param n_reps number of repetitions
+ * @param dataset_name name of the dataset
+ * @param workload name of the workload the samples were drawn from
+ */
+void benchmark_bin(const std::vector<std::string> &keys,
+                   const std::vector<std::string> &samples,
+                   const std::size_t n_reps,
+                   const std::string dataset_name,
+                   const std::string workload)
+{
+    // Perform n_reps runs.
+    for (std::size_t rep = 0; rep != n_reps; ++rep) {
+
+        // Lookup time.
+        std::size_t lookup_accu = 0;
+        auto start = steady_clock::now();
+        for (std::size_t i = 0; i != samples.size(); ++i) {
+            auto pos = std::lower_bound(keys.begin(), keys.end(), samples[i]);
+            lookup_accu += std::distance(keys.begin(), pos);
+        }
+        auto stop = steady_clock::now();
+        auto lookup_time = duration_cast<nanoseconds>(stop - start).count();
+        s_glob = lookup_accu;
+
+        // Report results.
+        report(dataset_name, keys.size(), "BinarySearch", "", 0, rep, samples.size(), workload, 0, lookup_time,
+               lookup_accu);
+    } // rep
+}
+
+
+/**
+ * Triggers benchmarks of several indexes on a synthetic string dataset provided via command line arguments.
+ * @param argc arguments counter
+ * @param argv arguments vector
+ */
+int main(int argc, char *argv[])
+{
+    // Initialize argument parser.
+    argparse::ArgumentParser program(argv[0], "0.1");
+
+    // Define arguments.
+    program.add_argument("dataset")
+        .help("synthetic string dataset, either urls or emails");
+
+    program.add_argument("-k", "--n_keys")
+        .help("number of generated keys")
+        .default_value(std::size_t(10'000'000))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("-n", "--n_reps")
+        .help("number of experiment repetitions")
+        .default_value(std::size_t(3))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("-s", "--n_samples")
+        .help("number of sampled lookup keys")
+        .default_value(std::size_t(1'000'000))
+        .action([](const std::string &s) { return std::stoul(s); });
+
+    program.add_argument("-w", "--workload")
+        .help("lookup workload, either uniform or absent")
+        .default_value(std::string("uniform"));
+
+    program.add_argument("--header")
+        .help("output csv header")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("--rmi")
+        .help("run benchmark on Recursive Model Index")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("--art")
+        .help("run benchmark on Adaptive Radix Tree")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("--tlx")
+        .help("run benchmark on TLX B-tree")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("--bin")
+        .help("run benchmark on binary search")
+        .default_value(false)
+        .implicit_value(true);
+
+    // Parse arguments.
+    try {
+        program.parse_args(argc, argv);
+    }
+    catch (const std::runtime_error &err) {
+        std::cout << err.what() << '\n' << program;
+        exit(EXIT_FAILURE);
+    }
+
+    // Read arguments.
+    const auto dataset_name = program.get<std::string>("dataset");
+    const auto n_keys = program.get<std::size_t>("-k");
+    const auto n_reps = program.get<std::size_t>("-n");
+    const auto n_samples = program.get<std::size_t>("-s");
+    const auto workload = program.get<std::string>("-w");
+
+    // Generate keys and sample lookup keys.
+    uint64_t seed = 42;
+    auto keys = generate_strings(dataset_name, n_keys, seed);
+    auto samples = generate_string_workload(keys, dataset_name, workload, n_samples, seed);
+
+    // Output header.
+    if (program["--header"]  == true)
+        std::cout << "dataset,"
+                  << "n_keys,"
+                  << "index,"
+                  << "config,"
+                  << "size_in_bytes,"
+                  << "rep,"
+                  << "n_samples,"
+                  << "workload,"
+                  << "build_time,"
+                  << "lookup_time,"
+                  << "lookup_accu"
+                  << std::endl;
+
+    // Run benchmarks.
+    if (program["--rmi"] == true) benchmark_rmi(keys, samples, n_reps, dataset_name, workload);
+    if (program["--art"] == true) benchmark_art(keys, samples, n_reps, dataset_name, workload);
+    if (program["--tlx"] == true) benchmark_tlx(keys, samples, n_reps, dataset_name, workload);
+    if (program["--bin"] == true) benchmark_bin(keys, samples, n_reps, dataset_name, workload);
+
+    exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,374 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "rmi/rmi.hpp"
+
+
+namespace rmi {
+
+/**
+ * Recursive model index with data-driven segmentation and local individual bounds.
+ *
+ * Layer1 partitions the keys into @p layer2_size segments and a model with individual error bounds is trained per
+ * segment, as in RmiLInd. Segmentation is then refined based on the errors of these models:
+ * 1. Neighbouring segments whose errors do not exceed the median error are merged pairwise, repeatedly, as long as the
+ *    model trained on their union stays within the median error. Merged segments, including runs of empty segments,
+ *    share a node via a redirect table.
+ * 2. The memory saved by merging, plus any memory granted by the budget, is spent on the nodes with the largest errors.
+ *    Such a node keeps its model as a router that distributes keys among child models based on its position estimate,
+ *    i.e. the node becomes a mini third layer.
+ *
+ * This bounds the error of the few segments that dominate the maximum error. By default, the index is granted the size
+ * of an RmiLInd with the same number of segments.
+ *
+ * @tparam Key the type of the keys to be indexed
+ * @tparam Layer1 the type of the model used in layer1
+ * @tparam Layer2 the type of the models used in layer2
+ * @tparam Allocator the allocator used for layer2 and error bounds, rebound to their types, e.g. HugePageAllocator
+ */
+template<typename Key, typename Layer1, typename Layer2, typename Allocator = std::allocator<Layer2>>
+class RmiAdaptive
+{
+    using key_type = Key;
+    using layer1_type = Layer1;
+    using layer2_type = Layer2;
+
+    public:
+    using allocator_type = Allocator;
+
+    protected:
+    template<typename T>
+    using rebind_alloc = typename std::allocator_traits<allocator_type>::template rebind_alloc<T>;
+
+    static constexpr std::size_t router_tag = -1; ///< Marks the bounds of a router.
+
+    /**
+     * Struct to store a lower and an upper error bound. The bounds of a router hold the router id in `lo` and
+     * router_tag in `hi`.
+     */
+    struct bounds {
+        std::size_t lo; ///< The lower error bound.
+        std::size_t hi; ///< The upper error bound.
+    };
+
+    /**
+     * A router estimates a position with its model and forwards to the child responsible for that position.
+     */
+    struct router {
+        std::size_t begin;  ///< The first position covered by the router.
+        std::size_t end;    ///< The position past the last covered by the router.
+        std::size_t child;  ///< The node id of the first child.
+        std::size_t fanout; ///< The number of children.
+    };
+
+    /**
+     * A contiguous range of segments and their keys during construction.
+     */
+    struct group {
+        std::size_t segment_lo; ///< The first segment.
+        std::size_t segment_hi; ///< The segment past the last.
+        std::size_t begin;      ///< The position of the first key.
+        std::size_t end;        ///< The position past the last key.
+        layer2_type model;      ///< The model trained on the keys.
+        std::size_t lo;         ///< The lower error bound of the model.
+        std::size_t hi;         ///< The upper error bound of the model.
+
+        std::size_t error() const { return lo + hi; }
+    };
+
+    std::size_t n_keys_ = 0;                                 ///< The number of keys the index was built on.
+    std::size_t layer2_size_ = 0;                            ///< The number of segments in layer2.
+    layer1_type l1_;                                         ///< The layer1 model.
+    std::vector<layer2_type, rebind_alloc<layer2_type>> l2_; ///< The models of all nodes.
+    std::vector<bounds, rebind_alloc<bounds>> errors_;       ///< The error bounds of all nodes.
+    std::vector<router, rebind_alloc<router>> routers_;      ///< The routers.
+    std::vector<uint32_t, rebind_alloc<uint32_t>> redirect_; ///< The node of each segment.
+
+    public:
+    static constexpr std::size_t max_fanout = 1024; ///< The maximum number of children of a router.
+
+    /**
+     * Default constructor.
+     */
+    RmiAdaptive() = default;
+
+    /**
+     * Builds the index with @p layer2_size segments in layer2 on the sorted @p keys.
+     * @param keys vector of sorted keys to be indexed
+     * @param layer2_size the number of segments in layer2
+     * @param compress ignored, neighbouring segments are always merged
+     * @param alloc allocator for layer2 and error bounds
+     * @param budget the maximum size of the index in bytes, 0 for the size of RmiLInd with @p layer2_size models
+     */
+    template<typename KeyAllocator>
+    RmiAdaptive(const std::vector<key_type, KeyAllocator> &keys, const std::size_t layer2_size,
+                const bool compress = false, const allocator_type &alloc = allocator_type(),
+                const std::size_t budget = 0)
+        : RmiAdaptive(keys.begin(), keys.end(), layer2_size, compress, alloc, budget) { }
+
+    /**
+     * Builds the index with @p layer2_size segments in layer2 on the sorted keys in the range [first, last). If the
+     * index exceeds @p budget after merging, no node is split.
+     * @param first, last iterators that define the range of sorted keys to be indexed
+     * @param layer2_size the number of segments in layer2
+     * @param compress ignored, neighbouring segments are always merged
+     * @param alloc allocator for layer2 and error bounds
+     * @param budget the maximum size of the index in bytes, 0 for the size of RmiLInd with @p layer2_size models
+     */
+    template<typename RandomIt>
+    RmiAdaptive(RandomIt first, RandomIt last, const std::size_t layer2_size, const bool /* compress */ = false,
+                const allocator_type &alloc = allocator_type(), std::size_t budget = 0)
+        : n_keys_(std::distance(first, last))
+        , layer2_size_(layer2_size)
+        , l2_(alloc)
+        , errors_(alloc)
+        , routers_(alloc)
+        , redirect_(alloc)
+    {
+        // Train layer1.
+        l1_ = layer1_type(first, last, 0, static_cast<double>(layer2_size) / n_keys_); // train with compression
+
+        // Determine the position of the first key of each segment.
+        std::vector<std::size_t> starts(layer2_size + 1, n_keys_);
+        std::size_t segment_id = 0;
+        for (std::size_t i = 0; i != n_keys_; ++i) {
+            std::size_t pred_segment_id = get_segment_id(*(first + i));
+            for (; segment_id <= pred_segment_id; ++segment_id) starts[segment_id] = i;
+        }
+
+        // Train one model per segment.
+        std::vector<group> groups;
+        groups.reserve(layer2_size);
+        for (std::size_t s = 0; s != layer2_size; ++s)
+            groups.push_back(train(first, s, s + 1, starts[s], starts[s + 1]));
+
+        // The target error is the median error of non-empty segments.
+        std::vector<std::size_t> errors;
+        for (auto &g : groups)
+            if (g.begin != g.end) errors.push_back(g.error());
+        std::nth_element(errors.begin(), errors.begin() + errors.size() / 2, errors.end());
+        const std::size_t target = errors[errors.size() / 2];
+
+        // Merge neighbours within the target error pairwise until no pair can be merged.
+        for (bool merged = true; merged; ) {
+            merged = false;
+            std::vector<group> next;
+            next.reserve(groups.size());
+            for (std::size_t i = 0; i != groups.size(); ) {
+                if (i + 1 != groups.size() and groups[i].error() <= target and groups[i + 1].error() <= target) {
+                    auto g = train(first, groups[i].segment_lo, groups[i + 1].segment_hi, groups[i].begin,
+                                   groups[i + 1].end);
+                    if (g.error() <= target) {
+                        next.push_back(g);
+                        i += 2;
+                        merged = true;
+                        continue;
+                    }
+                }
+                next.push_back(groups[i++]);
+            }
+            groups.swap(next);
+        }
+
+        // Split the nodes with the largest errors within the budget.
+        const std::size_t node_size = groups.front().model.size_in_bytes() + sizeof(bounds);
+        const std::size_t base_size = l1_.size_in_bytes() + sizeof(n_keys_) + sizeof(layer2_size_);
+        if (budget == 0) budget = base_size + layer2_size * node_size; // size of RmiLInd
+        std::size_t size = base_size + layer2_size * sizeof(uint32_t) + groups.size() * node_size;
+
+        std::vector<std::size_t> order;
+        for (std::size_t i = 0; i != groups.size(); ++i)
+            if (groups[i].error() > target and groups[i].end - groups[i].begin > 1) order.push_back(i);
+        std::sort(order.begin(), order.end(), [&groups](const std::size_t lhs, const std::size_t rhs) {
+            return groups[lhs].error() > groups[rhs].error();
+        });
+
+        std::vector<std::vector<group>> children(groups.size());
+        for (std::size_t i : order) {
+            if (size + 2 * node_size + sizeof(router) > budget) break;
+            const group &g = groups[i];
+            std::size_t fanout = std::min({(g.error() + target) / std::max<std::size_t>(target, 1), g.end - g.begin,
+                                           max_fanout, (budget - size - sizeof(router)) / node_size});
+            fanout = std::max<std::size_t>(fanout, 2);
+            if (split(first, g, fanout, children[i])) size += fanout * node_size + sizeof(router);
+        }
+
+        // Lay out nodes, children of routers at the end.
+        std::size_t n_nodes = groups.size();
+        for (auto &c : children) n_nodes += c.size();
+        l2_.reserve(n_nodes);
+        errors_.reserve(n_nodes);
+        redirect_.resize(layer2_size);
+        for (std::size_t i = 0; i != groups.size(); ++i) {
+            const group &g = groups[i];
+            std::fill(redirect_.begin() + g.segment_lo, redirect_.begin() + g.segment_hi, i);
+            l2_.push_back(g.model);
+            errors_.push_back({g.lo, g.hi});
+        }
+        for (std::size_t i = 0; i != groups.size(); ++i) {
+            if (children[i].empty()) continue;
+            errors_[i] = {routers_.size(), router_tag};
+            routers_.push_back({groups[i].begin, groups[i].end, l2_.size(), children[i].size()});
+            for (const group &c : children[i]) {
+                l2_.push_back(c.model);
+                errors_.push_back({c.lo, c.hi});
+            }
+        }
+    }
+
+    /**
+     * Returns the id of the segment @p key belongs to.
+     * @param key to get segment id for
+     * @return segment id of the given key
+     */
+    std::size_t get_segment_id(const key_type key) const {
+        return std::clamp<double>(l1_.predict(key), 0, layer2_size_ - 1);
+    }
+
+    /**
+     * Returns a position estimate and search bounds for a given key.
+     * @param key to search for
+     * @return position estimate and search bounds
+     */
+    Approx search(const key_type key) const {
+        std::size_t node_id = redirect_[get_segment_id(key)];
+        std::size_t pred = predict(node_id, key);
+        if (errors_[node_id].hi == router_tag) {
+            const router &r = routers_[errors_[node_id].lo];
+            node_id = r.child + route(r, pred);
+            pred = predict(node_id, key);
+        }
+        return bound(node_id, pred);
+    }
+
+    /**
+     * Returns position estimates and search bounds for the keys in the range [first, last) and writes them to the range
+     * beginning at @p d_first.
+     * @param first, last iterators that define the range of keys to search for
+     * @param d_first the beginning of the destination range
+     * @return output iterator to the element past the last element written
+     */
+    template<typename RandomIt, typename OutputIt>
+    OutputIt search(RandomIt first, RandomIt last, OutputIt d_first) const {
+        return std::transform(first, last, d_first, [this](const key_type key) { return search(key); });
+    }
+
+    /**
+     * Returns the number of keys the index was built on.
+     * @return the number of keys the index was built on
+     */
+    std::size_t n_keys() const { return n_keys_; }
+
+    /**
+     * Returns the number of segments in layer2.
+     * @return the number of segments in layer2
+     */
+    std::size_t layer2_size() const { return layer2_size_; }
+
+    /**
+     * Returns the number of models in layer2, including routers and their children.
+     * @return the number of models in layer2
+     */
+    std::size_t n_models() const { return l2_.size(); }
+
+    /**
+     * Returns the size of the index in bytes.
+     * @return index size in bytes
+     */
+    std::size_t size_in_bytes() const {
+        std::size_t l2_size = 0;
+        for (auto &m : l2_) l2_size += m.size_in_bytes(); // models may differ in size
+        return l1_.size_in_bytes() + l2_size + errors_.size() * sizeof(bounds)
+            + routers_.size() * sizeof(router) + redirect_.size() * sizeof(uint32_t) + sizeof(n_keys_)
+            + sizeof(layer2_size_);
+    }
+
+    private:
+    /**
+     * Returns the position estimate of the model of node @p node_id for @p key.
+     */
+    std::size_t predict(const std::size_t node_id, const key_type key) const {
+        return std::clamp<double>(l2_[node_id].predict(key), 0, n_keys_ - 1);
+    }
+
+    /**
+     * Returns the child of router @p r responsible for position estimate @p pred.
+     */
+    static std::size_t route(const router &r, const std::size_t pred) {
+        if (pred <= r.begin) return 0;
+        return std::min((pred - r.begin) * r.fanout / (r.end - r.begin), r.fanout - 1);
+    }
+
+    /**
+     * Returns the search bounds of node @p node_id around position estimate @p pred.
+     * @param node_id leaf the position was estimated by
+     * @param pred position estimate
+     * @return position estimate and search bounds
+     */
+    Approx bound(const std::size_t node_id, const std::size_t pred) const {
+        bounds err = errors_[node_id];
+        std::size_t lo = pred > err.lo ? pred - err.lo : 0;
+        std::size_t hi = std::min(pred + err.hi + 1, n_keys_);
+        return {pred, lo, hi};
+    }
+
+    /**
+     * Trains a model on the keys at positions [begin, end) of the segments [segment_lo, segment_hi) and computes its
+     * error bounds. Without keys, the model is trained on the preceding key, or on the first key if there is none.
+     * @param first iterator to the first key
+     * @param segment_lo, segment_hi the range of segments
+     * @param begin, end the range of key positions
+     * @return the trained group
+     */
+    template<typename RandomIt>
+    group train(RandomIt first, const std::size_t segment_lo, const std::size_t segment_hi, const std::size_t begin,
+                const std::size_t end) const {
+        if (begin == end) {
+            std::size_t i = begin == 0 ? 0 : begin - 1;
+            return {segment_lo, segment_hi, begin, end, layer2_type(first + i, first + i + 1, i), 0, 0};
+        }
+        group g{segment_lo, segment_hi, begin, end, layer2_type(first + begin, first + end, begin), 0, 0};
+        for (std::size_t i = begin; i != end; ++i) {
+            std::size_t pred = std::clamp<double>(g.model.predict(*(first + i)), 0, n_keys_ - 1);
+            if (pred > i) g.lo = std::max(g.lo, pred - i); // overestimation
+            else g.hi = std::max(g.hi, i - pred); // underestimation
+        }
+        return g;
+    }
+
+    /**
+     * Distributes the keys of @p g among @p fanout children based on the position estimates of its model and trains
+     * the children. The split is rejected if routing is not monotonic or does not reduce the error.
+     * @param first iterator to the first key
+     * @param g the group to split
+     * @param fanout the number of children
+     * @param children receives the trained children if the split is accepted
+     * @return whether the split is accepted
+     */
+    template<typename RandomIt>
+    bool split(RandomIt first, const group &g, const std::size_t fanout, std::vector<group> &children) const {
+        const router r{g.begin, g.end, 0, fanout};
+        std::vector<std::size_t> starts(fanout + 1, g.end);
+        std::size_t child = 0;
+        for (std::size_t i = g.begin; i != g.end; ++i) {
+            std::size_t pred_child = route(r, std::clamp<double>(g.model.predict(*(first + i)), 0, n_keys_ - 1));
+            if (pred_child + 1 < child) return false; // routing is not monotonic
+            for (; child <= pred_child; ++child) starts[child] = i;
+        }
+
+        std::vector<group> result;
+        result.reserve(fanout);
+        for (std::size_t c = 0; c != fanout; ++c) {
+            result.push_back(train(first, g.segment_lo, g.segment_hi, starts[c], starts[c + 1]));
+            if (result.back().error() >= g.error()) return false;
+        }
+        children.swap(result);
+        return true;
+    }
+};
+
+} // namespace rmi
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "rmi/models.hpp"
+#include "rmi/rmi.hpp"
+
+
+namespace rmi {
+
+/**
+ * Writes @p v as a C++ floating-point literal that evaluates to exactly @p v.
+ * @param out output stream to write the literal to
+ * @param v the value
+ * @return the output stream
+ */
+inline std::ostream &emit_double(std::ostream &out, const double v)
+{
+    if (std::isnan(v)) return out << "std::numeric_limits<double>::quiet_NaN()";
+    if (std::isinf(v)) return out << (v < 0 ? "-" : "") << "std::numeric_limits<double>::infinity()";
+    auto flags = out.flags();
+    out << std::hexfloat << v;
+    out.flags(flags);
+    return out;
+}
+
+/**
+ * Returns the name of the narrowest unsigned integer type that holds @p max.
+ * @param max the largest value to hold
+ * @return the name of the type
+ */
+inline std::string uint_type_name(const uint64_t max)
+{
+    if (max <= UINT8_MAX) return "std::uint8_t";
+    if (max <= UINT16_MAX) return "std::uint16_t";
+    if (max <= UINT32_MAX) return "std::uint32_t";
+    return "std::uint64_t";
+}
+
+/**
+ * Writes the parameters of a linear layer1 model as `constexpr` constants and its prediction as function `l1()`.
+ * @param out output stream to write the code to
+ * @param m the model
+ */
+template<typename Model>
+auto emit_layer1(std::ostream &out, const Model &m)
+    -> std::enable_if_t<std::is_same_v<Model, LinearSpline> or std::is_same_v<Model, LinearRegression>>
+{
+    out << "constexpr double L1_SLOPE = "; emit_double(out, m.slope()) << ";\n";
+    out << "constexpr double L1_INTERCEPT = "; emit_double(out, m.intercept()) << ";\n\n";
+    out << "inline double l1(const key_type x) { return std::fma(L1_SLOPE, static_cast<double>(x), L1_INTERCEPT); }\n";
+}
+
+/**
+ * Writes the coefficients of a cubic spline layer1 model as `constexpr` constants and its prediction as function
+ * `l1()`. Keys are rebased like CubicSpline::rebase() does for unsigned keys.
+ * @param out output stream to write the code to
+ * @param m the model
+ */
+inline void emit_layer1(std::ostream &out, const CubicSpline &m)
+{
+    out << "constexpr key_type L1_XMIN = " << static_cast<uint64_t>(m.xmin()) << "ULL;\n";
+    out << "constexpr double L1_A = "; emit_double(out, m.a()) << ";\n";
+    out << "constexpr double L1_B = "; emit_double(out, m.b()) << ";\n";
+    out << "constexpr double L1_C = "; emit_double(out, m.c()) << ";\n";
+    out << "constexpr double L1_D = "; emit_double(out, m.d()) << ";\n\n";
+    out << "inline double l1(const key_type x) {\n"
+        << "    double x_ = x >= L1_XMIN ? static_cast<double>(key_type(x - L1_XMIN))\n"
+        << "                             : -static_cast<double>(key_type(L1_XMIN - x));\n"
+        << "    return std::fma(std::fma(std::fma(L1_A, x_, L1_B), x_, L1_C), x_, L1_D);\n"
+        << "}\n";
+}
+
+/**
+ * Writes the mask and shift of a radix layer1 model as `constexpr` constants and its prediction as function `l1()`.
+ * The projection is always emitted as mask and shift, which yields the same result as `_pext`. Only unsigned keys are
+ * supported, for which radix_key() is the identity.
+ * @param out output stream to write the code to
+ * @param m the model
+ */
+template<typename X, bool Pext>
+void emit_layer1(std::ostream &out, const Radix<X, Pext> &m)
+{
+    static_assert(std::is_unsigned_v<X>, "code generation of radix models requires unsigned keys");
+    auto flags = out.flags();
+    out << "constexpr key_type L1_MASK = 0x" << std::hex << static_cast<uint64_t>(m.mask()) << std::dec << ";\n";
+    out.flags(flags);
+    out << "constexpr unsigned L1_SHIFT = " << unsigned(m.shift()) << ";\n\n";
+    out << "inline double l1(const key_type x) { return (x & L1_MASK) >> L1_SHIFT; }\n";
+}
+
+/**
+ * Writes the C++ source of a header that implements the lookup of the trained @p rmi with all parameters compiled in.
+ *
+ * The header defines namespace @p name, which holds the root parameters as `constexpr` constants, the slopes and
+ * intercepts of the layer2 models interleaved in one static array, the error bounds in another one of the narrowest
+ * integer type that fits the largest error bound, and the redirect table if @p rmi is compressed. Sizes are compile-time
+ * constants, too. Function `search()` returns the same position estimates and search bounds as `rmi.search()`, but
+ * without loading parameters from the index object first. The header depends only on the standard library.
+ *
+ * Layer1 may be a linear spline, a linear regression, a cubic spline, or a radix model. Layer2 models must be linear,
+ * i.e. provide `slope()` and `intercept()`, and keys must be unsigned integers.
+ * @param out output stream to write the header to
+ * @param rmi the recursive model index
+ * @param errors the error bound of each layer2 model, or `nullptr` if @p rmi does not provide error bounds
+ * @param size_in_bytes the size of @p rmi in bytes including its error bounds
+ * @param name the namespace of the generated code
+ */
+template<typename Key, typename Layer1, typename Layer2, typename Allocator>
+void emit_rmi(std::ostream &out,
+              const Rmi<Key, Layer1, Layer2, Allocator> &rmi,
+              const std::size_t *errors,
+              const std::size_t size_in_bytes,
+              const std::string &name)
+{
+    static_assert(std::is_unsigned_v<Key>, "code generation requires unsigned keys");
+
+    // Write preamble.
+    out << "#pragma once\n\n"
+        << "// Generated by rmi::emit(), do not edit.\n\n"
+        << "#include <algorithm>\n"
+        << "#include <cmath>\n"
+        << "#include <cstddef>\n"
+        << "#include <cstdint>\n"
+        << "#include <limits>\n\n\n"
+        << "namespace " << name << " {\n\n"
+        << "using key_type = " << uint_type_name(std::numeric_limits<Key>::max()) << ";\n\n"
+        << "/**\n"
+        << " * Struct to hold the approximated position and error bounds returned by the index.\n"
+        << " */\n"
+        << "struct Approx {\n"
+        << "    std::size_t pos; ///< The estimated position of the key.\n"
+        << "    std::size_t lo;  ///< The lower bound of the search range.\n"
+        << "    std::size_t hi;  ///< The upper bound of the search range.\n"
+        << "};\n\n"
+        << "constexpr std::size_t N_KEYS = " << rmi.n_keys() << ";\n"
+        << "constexpr std::size_t LAYER2_SIZE = " << rmi.layer2_size() << ";\n"
+        << "constexpr std::size_t N_MODELS = " << rmi.n_models() << ";\n"
+        << "constexpr std::size_t RMI_SIZE = " << size_in_bytes << ";\n\n";
+
+    // Write layer1.
+    emit_layer1(out, rmi.layer1());
+    out << '\n';
+
+    // Write layer2 as pairs of slope and intercept.
+    out << "alignas(16) inline constexpr double L2_PARAMS[2 * N_MODELS] = {\n";
+    for (std::size_t i = 0; i != rmi.n_models(); ++i) {
+        out << "    "; emit_double(out, rmi.layer2(i).slope()) << ", ";
+        emit_double(out, rmi.layer2(i).intercept()) << ",\n";
+    }
+    out << "};\n\n";
+
+    // Write error bounds.
+    if (errors) {
+        std::string error_type = uint_type_name(*std::max_element(errors, errors + rmi.n_models()));
+        out << "inline constexpr " << error_type << " L2_ERRORS[N_MODELS] = {\n";
+        for (std::size_t i = 0; i != rmi.n_models(); ++i) out << "    " << errors[i] << ",\n";
+        out << "};\n\n";
+    }
+
+    // Write redirect table.
+    auto &redirect = rmi.redirect();
+    if (not redirect.empty()) {
+        out << "inline constexpr " << uint_type_name(rmi.n_models() - 1) << " REDIRECT[LAYER2_SIZE] = {\n";
+        for (auto model_id : redirect) out << "    " << model_id << ",\n";
+        out << "};\n\n";
+    }
+
+    // Write search.
+    out << "/**\n"
+        << " * Returns a position estimate and search bounds for a given key.\n"
+        << " * @param key to search for\n"
+        << " * @return position estimate and search bounds\n"
+        << " */\n"
+        << "inline Approx search(const key_type key) {\n"
+        << "    std::size_t segment_id = std::clamp<double>(l1(key), 0, LAYER2_SIZE - 1);\n"
+        << (redirect.empty() ? "    std::size_t model_id = segment_id;\n"
+                             : "    std::size_t model_id = REDIRECT[segment_id];\n")
+        << "    double l2 = std::fma(L2_PARAMS[2 * model_id], static_cast<double>(key), L2_PARAMS[2 * model_id + 1]);\n"
+        << "    std::size_t pred = std::clamp<double>(l2, 0, N_KEYS - 1);\n";
+    if (errors) {
+        out << "    std::size_t err = L2_ERRORS[model_id];\n"
+            << "    std::size_t lo = pred > err ? pred - err : 0;\n"
+            << "    std::size_t hi = std::min(pred + err + 1, N_KEYS);\n"
+            << "    return {pred, lo, hi};\n";
+    } else {
+        out << "    return {pred, 0, N_KEYS};\n";
+    }
+    out << "}\n\n"
+        << "} // namespace " << name << '\n';
+}
+
+/**
+ * Writes the C++ source of a header that implements the lookup of the trained @p rmi without error bounds. See
+ * emit_rmi().
+ * @param out output stream to write the header to
+ * @param rmi the recursive model index
+ * @param name the namespace of the generated code
+ */
+template<typename Key, typename Layer1, typename Layer2, typename Allocator>
+void emit(std::ostream &out, const Rmi<Key, Layer1, Layer2, Allocator> &rmi, const std::string &name)
+{
+    emit_rmi(out, rmi, nullptr, rmi.size_in_bytes(), name);
+}
+
+/**
+ * Writes the C++ source of a header that implements the lookup of the trained @p rmi with local absolute error bounds.
+ * See emit_rmi().
+ * @param out output stream to write the header to
+ * @param rmi the recursive model index
+ * @param name the namespace of the generated code
+ */
+template<typename Key, typename Layer1, typename Layer2, typename Allocator>
+void emit(std::ostream &out, const RmiLAbs<Key, Layer1, Layer2, Allocator> &rmi, const std::string &name)
+{
+    std::vector<std::size_t> errors(rmi.n_models());
+    for (std::size_t i = 0; i != rmi.n_models(); ++i) errors[i] = rmi.error(i);
+    emit_rmi(out, rmi, errors.data(), rmi.size_in_bytes(), name);
+}
+
+} // namespace rmi
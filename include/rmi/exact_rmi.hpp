@@ -0,0 +1,225 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "rmi/rmi.hpp"
+#include "rmi/util/fn.hpp"
+
+
+namespace rmi {
+
+/**
+ * Recursive model index with a correction table that turns position estimates into exact positions.
+ *
+ * Since layer2 models are monotonic, the keys whose position estimate is p form a contiguous run. For every position
+ * estimate p of a model, the index stores the position of the first key whose estimate is not less than p, bit-packed
+ * per model as difference from p at the minimal bit width of the model, i.e. the width of the spread of its individual
+ * errors as known to RmiLInd. The search bounds of a key with estimate p are then the run of keys with estimate p,
+ * which holds at most one key unless keys collide, and the lower bound of any key within the range of the keys, present
+ * or not, lies within or right after that run. Hence, a key whose run holds a single key is resolved by a single
+ * comparison without search, see ExactSearch, and all other keys are searched within their run only.
+ *
+ * The search bounds are never empty, i.e. an estimate without keys yields the single key at the lower bound.
+ *
+ * @tparam Key the type of the keys to be indexed
+ * @tparam Layer1 the type of the model used in layer1
+ * @tparam Layer2 the type of the models used in layer2, must be monotonic, see is_monotonic
+ * @tparam Allocator the allocator used for layer2 and the correction table, rebound to their types
+ * @tparam Storage the layout of layer2, either AosStorage (array of models) or SoaStorage (array per parameter)
+ */
+template<typename Key, typename Layer1, typename Layer2, typename Allocator = std::allocator<Layer2>,
+         template<typename, typename> class Storage = AosStorage>
+class RmiExact : public Rmi<Key, Layer1, Layer2, Allocator, Storage>
+{
+    static_assert(is_monotonic_v<Layer2>, "layer2 models must be monotonic");
+
+    using base_type = Rmi<Key, Layer1, Layer2, Allocator, Storage>;
+    using key_type = Key;
+    using layer1_type = Layer1;
+    using layer2_type = Layer2;
+
+    protected:
+    /**
+     * Struct to store the correction table of a model, which covers the position estimates [first, last].
+     */
+    struct corrections {
+        std::size_t first;    ///< The smallest position estimate of the keys of the model.
+        std::size_t last;     ///< The largest position estimate of the keys of the model plus one.
+        int64_t base;         ///< The smallest difference between a position and its estimate.
+        uint64_t offset : 56; ///< The first word of the bit-packed differences.
+        uint64_t width : 8;   ///< The bit width of the differences.
+    };
+
+    using corrections_type = std::vector<corrections, typename base_type::template rebind_alloc<corrections>>;
+    using words_type = std::vector<uint64_t, typename base_type::template rebind_alloc<uint64_t>>;
+
+    corrections_type corrections_; ///< The correction table of each layer2 model.
+    words_type words_;             ///< The bit-packed differences of all models, followed by two padding words.
+
+    public:
+    /**
+     * Default constructor.
+     */
+    RmiExact() = default;
+
+    /**
+     * Builds the index with @p layer2_size models in layer2 on the sorted @p keys.
+     * @param keys vector of sorted keys to be indexed
+     * @param layer2_size the number of models in layer2
+     * @param compress whether runs of empty segments share a single model
+     * @param alloc allocator for layer2 and the correction table
+     */
+    template<typename KeyAllocator>
+    RmiExact(const std::vector<key_type, KeyAllocator> &keys, const std::size_t layer2_size, const bool compress = false,
+             const Allocator &alloc = Allocator())
+        : RmiExact(keys.begin(), keys.end(), layer2_size, compress, alloc) { }
+
+    /**
+     * Builds the index with @p layer2_size models in layer2 on the sorted keys in the range [first, last).
+     * @param first, last iterators that define the range of sorted keys to be indexed
+     * @param layer2_size the number of models in layer2
+     * @param compress whether runs of empty segments share a single model
+     * @param alloc allocator for layer2 and the correction table
+     */
+    template<typename RandomIt>
+    RmiExact(RandomIt first, RandomIt last, const std::size_t layer2_size, const bool compress = false,
+             const Allocator &alloc = Allocator())
+        : base_type(first, last, layer2_size, compress, alloc)
+        , corrections_(alloc)
+        , words_(alloc)
+    {
+        const std::size_t n_keys = base_type::n_keys_;
+        const std::size_t n_models = base_type::n_models_;
+
+        // Compute the model and the position estimate of each key. Keys of a model are contiguous.
+        std::vector<std::size_t> model_ids(n_keys);
+        std::vector<std::size_t> preds(n_keys);
+        for (std::size_t i = 0; i != n_keys; ++i) {
+            key_type key = *(first + i);
+            model_ids[i] = base_type::get_model_id(key);
+            preds[i] = std::clamp<double>(base_type::l2_.predict(model_ids[i], key), 0, n_keys - 1);
+        }
+
+        // Determine the position of the first key of each model. Models without keys start at the following key.
+        std::vector<std::size_t> begins(n_models + 1, n_keys);
+        for (std::size_t i = n_keys; i-- != 0; ) begins[model_ids[i]] = i;
+        for (std::size_t m = n_models; m-- != 0; ) begins[m] = std::min(begins[m], begins[m + 1]);
+
+        // Determine the first position of each estimate [first, last] of each model.
+        corrections_.reserve(n_models);
+        std::vector<std::size_t> starts;
+        std::vector<std::size_t> model_starts(n_models + 1);
+        std::size_t n_words = 0;
+        for (std::size_t m = 0; m != n_models; ++m) {
+            std::size_t begin = begins[m];
+            std::size_t end = begin;
+            while (end != n_keys and model_ids[end] == m) ++end;
+
+            model_starts[m] = starts.size();
+            std::size_t lo = begin == end ? 0 : preds[begin];
+            std::size_t hi = begin == end ? 0 : preds[end - 1] + 1;
+            for (std::size_t p = lo, i = begin; p <= hi; ++p) {
+                while (i != end and preds[i] < p) ++i;
+                starts.push_back(i);
+            }
+
+            // Differences from the estimate are shifted by the smallest one and stored at the minimal width.
+            int64_t min_d = int64_t(begin) - int64_t(lo);
+            int64_t max_d = min_d;
+            for (std::size_t p = lo; p <= hi; ++p) {
+                int64_t d = int64_t(starts[model_starts[m] + p - lo]) - int64_t(p);
+                min_d = std::min(min_d, d);
+                max_d = std::max(max_d, d);
+            }
+            uint64_t width = bit_width<uint64_t>(uint64_t(max_d - min_d));
+            corrections_.push_back(corrections{lo, hi, min_d, n_words, width});
+            n_words += ((hi - lo + 1) * width + 63) / 64;
+        }
+        model_starts[n_models] = starts.size();
+
+        // Pack the differences.
+        words_.assign(n_words + 2, 0); // decoding reads two words, even for differences of width zero
+        for (std::size_t m = 0; m != n_models; ++m) {
+            const corrections &c = corrections_[m];
+            for (std::size_t j = 0; j != model_starts[m + 1] - model_starts[m] and c.width != 0; ++j) {
+                uint64_t u = uint64_t(int64_t(starts[model_starts[m] + j]) - int64_t(c.first + j) - c.base);
+                std::size_t bit = j * c.width;
+                std::size_t word = c.offset + bit / 64;
+                std::size_t shift = bit % 64;
+                words_[word] |= u << shift;
+                if (shift != 0 and shift + c.width > 64) words_[word + 1] |= u >> (64 - shift);
+            }
+        }
+    }
+
+    /**
+     * Returns a position estimate and search bounds for a given key. The estimate is exact if @p key is part of the
+     * data and the bounds hold a single key.
+     * @param key to search for
+     * @return position estimate and search bounds
+     */
+    Approx search(const key_type key) const {
+        auto model_id = base_type::get_model_id(key);
+        std::size_t pred = std::clamp<double>(base_type::l2_.predict(model_id, key), 0, base_type::n_keys_ - 1);
+        return bound(model_id, pred);
+    }
+
+    /**
+     * Returns position estimates and search bounds for the keys in the range [first, last) and writes them to the range
+     * beginning at @p d_first.
+     * @param first, last iterators that define the range of keys to search for
+     * @param d_first the beginning of the destination range
+     * @return output iterator to the element past the last element written
+     */
+    template<typename RandomIt, typename OutputIt>
+    OutputIt search(RandomIt first, RandomIt last, OutputIt d_first) const {
+        return base_type::search(first, last, d_first, [this](const std::size_t model_id, const std::size_t pred) {
+            return bound(model_id, pred);
+        });
+    }
+
+    /**
+     * Returns the size of the index in bytes.
+     * @return index size in bytes
+     */
+    std::size_t size_in_bytes() const {
+        return base_type::size_in_bytes() + corrections_.size() * sizeof(corrections) + words_.size() * sizeof(uint64_t);
+    }
+
+    private:
+    /**
+     * Returns the position of the first key of a model whose position estimate is not less than @p pred.
+     * @param c the correction table of the model
+     * @param pred position estimate
+     * @return position of the first key whose estimate is not less than @p pred
+     */
+    std::size_t start(const corrections &c, const std::size_t pred) const {
+        std::size_t p = std::clamp(pred, c.first, std::size_t(c.last));
+        const uint64_t width = c.width;
+        std::size_t bit = (p - c.first) * width;
+        const uint64_t *w = words_.data() + c.offset + bit / 64;
+        std::size_t shift = bit % 64;
+        uint64_t u = (w[0] >> shift) | ((w[1] << 1) << (63 - shift)); // second part is 0 if shift is 0
+        uint64_t mask = width == 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+        return p + c.base + (u & mask);
+    }
+
+    /**
+     * Returns the search bounds of model @p model_id for position estimate @p pred, i.e. the keys whose estimate is
+     * @p pred, or the key at the lower bound if there is none.
+     * @param model_id model the position was estimated by
+     * @param pred position estimate
+     * @return exact position estimate and search bounds
+     */
+    Approx bound(const std::size_t model_id, const std::size_t pred) const {
+        const corrections &c = corrections_[model_id];
+        std::size_t lo = std::min(start(c, pred), base_type::n_keys_ - 1);
+        std::size_t hi = std::max(start(c, pred + 1), lo + 1);
+        return {lo, lo, hi};
+    }
+};
+
+} // namespace rmi
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "rmi/rmi.hpp"
+#include "rmi/util/search.hpp"
+
+
+namespace rmi {
+
+/**
+ * Binds a recursive model index to the sorted keys it was built on and answers lower bound, upper bound, and range
+ * queries with iterators into these keys.
+ *
+ * The RMI only narrows down the search to an interval around its position estimate, which @p Search then examines. Keys
+ * that are not part of the data may lie outside of the error bounds of an RMI. In that case, the result is corrected by
+ * galloping outward from the interval boundary. The index keeps a reference to the keys, which must outlive the index
+ * and must not be modified.
+ *
+ * @tparam Key the type of the keys to be indexed
+ * @tparam Rmi the type of the recursive model index, e.g. `RmiLAbs<Key, LinearSpline, LinearRegression>`
+ * @tparam Search the functor used for searching the interval returned by @p Rmi
+ * @tparam KeyAllocator the allocator of the vector holding the keys
+ */
+template<typename Key, typename Rmi, typename Search = BinarySearch, typename KeyAllocator = std::allocator<Key>>
+class Index
+{
+    public:
+    using key_type = Key;
+    using rmi_type = Rmi;
+    using search_type = Search;
+    using const_iterator = typename std::vector<key_type, KeyAllocator>::const_iterator;
+
+    private:
+    const std::vector<key_type, KeyAllocator> &keys_; ///< The sorted keys the index is built on.
+    rmi_type rmi_;                                    ///< The recursive model index.
+    search_type search_;                              ///< The functor searching the interval of a key.
+
+    public:
+    /**
+     * Builds the index with @p layer2_size models in layer2 on the sorted @p keys.
+     * @param keys vector of sorted keys to be indexed
+     * @param layer2_size the number of models in layer2
+     * @param compress whether runs of empty segments share a single model
+     * @param alloc allocator of the recursive model index
+     * @param search functor searching the interval of a key, e.g. one holding an auxiliary layout of @p keys
+     */
+    Index(const std::vector<key_type, KeyAllocator> &keys, const std::size_t layer2_size, const bool compress = false,
+          const typename rmi_type::allocator_type &alloc = typename rmi_type::allocator_type(),
+          const search_type &search = search_type())
+        : keys_(keys)
+        , rmi_(keys, layer2_size, compress, alloc)
+        , search_(search) { }
+
+    Index(const Index&) = delete;
+    Index &operator=(const Index&) = delete;
+
+    /**
+     * Returns an iterator to the first element that is not less than @p key.
+     * @param key to search for
+     * @return iterator to the first element that is not less than @p key, or end() if there is no such element
+     */
+    const_iterator lower_bound(const key_type key) const { return lower_bound(key, rmi_.search(key)); }
+
+    /**
+     * Returns an iterator to the first element that is greater than @p key. Gallops from the lower bound of @p key so
+     * that duplicates cost a logarithmic number of comparisons in their number.
+     * @param key to search for
+     * @return iterator to the first element that is greater than @p key, or end() if there is no such element
+     */
+    const_iterator upper_bound(const key_type key) const { return equal_range(key).second; }
+
+    /**
+     * Returns the range of elements equal to @p key.
+     * @param key to search for
+     * @return pair of iterators to the first element not less than and the first element greater than @p key
+     */
+    std::pair<const_iterator, const_iterator> equal_range(const key_type key) const {
+        auto first = lower_bound(key);
+        auto last = gallop(first, keys_.end(), first, [key](const key_type x) { return not (key < x); });
+        return {first, last};
+    }
+
+    /**
+     * Returns the range of elements in the half-open interval [@p lo_key, @p hi_key).
+     *
+     * Both ends are predicted up front. Galloping from the lower end over a distance d takes about 2 log d comparisons
+     * while searching the interval of @p hi_key takes about log w for an interval of size w. Hence, short ranges whose
+     * predicted length is below sqrt(w) gallop from the lower end, all others search the interval of @p hi_key.
+     * @param lo_key inclusive lower end of the interval
+     * @param hi_key exclusive upper end of the interval
+     * @return pair of iterators to the first element not less than @p lo_key and the first element not less than @p
+     * hi_key
+     */
+    std::pair<const_iterator, const_iterator> range(const key_type lo_key, const key_type hi_key) const {
+        auto lo_approx = rmi_.search(lo_key);
+        auto hi_approx = rmi_.search(hi_key);
+        auto first = lower_bound(lo_key, lo_approx);
+        if (not (lo_key < hi_key)) return {first, first};
+
+        std::size_t distance = hi_approx.pos > lo_approx.pos ? hi_approx.pos - lo_approx.pos : 0;
+        if (distance * distance < hi_approx.hi - hi_approx.lo)
+            return {first, gallop(first, keys_.end(), first, [hi_key](const key_type x) { return x < hi_key; })};
+        return {first, lower_bound(hi_key, hi_approx)};
+    }
+
+    /**
+     * Returns an iterator to the first key.
+     * @return iterator to the first key
+     */
+    const_iterator begin() const { return keys_.begin(); }
+
+    /**
+     * Returns an iterator to the element following the last key.
+     * @return iterator to the element following the last key
+     */
+    const_iterator end() const { return keys_.end(); }
+
+    /**
+     * Returns the number of keys.
+     * @return number of keys
+     */
+    std::size_t size() const { return keys_.size(); }
+
+    /**
+     * Returns the underlying recursive model index.
+     * @return the recursive model index
+     */
+    const rmi_type &rmi() const { return rmi_; }
+
+    /**
+     * Returns the size of the index in bytes, excluding the keys.
+     * @return index size in bytes
+     */
+    std::size_t size_in_bytes() const { return rmi_.size_in_bytes(); }
+
+    private:
+    /**
+     * Searches the interval of @p approx for the first element that is not less than @p key and corrects the result if
+     * it lies outside of that interval.
+     * @param key to search for
+     * @param approx position estimate and search bounds of @p key
+     * @return iterator to the first element that is not less than @p key
+     */
+    const_iterator lower_bound(const key_type key, const Approx approx) const {
+        if (keys_.empty()) return keys_.end();
+
+        auto first = keys_.begin() + approx.lo;
+        auto last = keys_.begin() + approx.hi;
+        auto it = search_(first, last, keys_.begin() + approx.pos, key);
+
+        // The lower bound lies outside of the search bounds if the key is not part of the data.
+        if ((it == last and it != keys_.end() and *it < key) or
+            (it == first and it != keys_.begin() and not (*(it - 1) < key)))
+            it = gallop(keys_.begin(), keys_.end(), it, [key](const key_type x) { return x < key; });
+        return it;
+    }
+
+    /**
+     * Performs exponential search starting at @p hint to find the partition point of the range [first, last), i.e. the
+     * first element for which @p is_before returns false.
+     * @tparam Pred unary predicate type
+     * @param first, last iterators defining the range partitioned by @p is_before
+     * @param hint iterator in the range [first, last] to start searching from
+     * @param is_before predicate that returns true for all elements before the partition point
+     * @return iterator to the first element for which @p is_before returns false, or @p last if there is no such element
+     */
+    template<typename Pred>
+    static const_iterator gallop(const_iterator first, const_iterator last, const_iterator hint, Pred is_before) {
+        std::size_t step = 1;
+        if (hint != last and is_before(*hint)) { // search right side
+            auto lo = hint;
+            while (static_cast<std::size_t>(std::distance(lo, last)) > step and is_before(*(lo + step))) {
+                lo += step;
+                step *= 2;
+            }
+            auto hi = static_cast<std::size_t>(std::distance(lo, last)) > step ? lo + step : last;
+            return std::partition_point(lo + 1, hi, is_before);
+        } else { // search left side
+            auto hi = hint;
+            while (static_cast<std::size_t>(std::distance(first, hi)) > step and not is_before(*(hi - step))) {
+                hi -= step;
+                step *= 2;
+            }
+            auto lo = static_cast<std::size_t>(std::distance(first, hi)) > step ? hi - step : first;
+            return std::partition_point(lo, hi, is_before);
+        }
+    }
+};
+
+} // namespace rmi
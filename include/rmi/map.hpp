@@ -0,0 +1,307 @@
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "rmi/rmi.hpp"
+#include "rmi/util/fn.hpp"
+#include "rmi/util/search.hpp"
+
+
+namespace rmi {
+
+/*======================================================================================================================
+ * Key Iterator
+ *====================================================================================================================*/
+
+/**
+ * Random access iterator over the keys of a storage layout that does not store its keys contiguously. This allows RMIs
+ * and search functors to operate on keys stored next to their values.
+ * @tparam Layout the storage layout providing `key(i)`
+ */
+template<typename Layout>
+class KeyIterator
+{
+    public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = typename Layout::key_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+    private:
+    const Layout *layout_; ///< The storage layout.
+    difference_type i_;    ///< The position of the key, may temporarily leave the range of keys.
+
+    public:
+    KeyIterator() = default;
+    KeyIterator(const Layout *layout, const difference_type i) : layout_(layout), i_(i) { }
+
+    reference operator*() const { return layout_->key(i_); }
+    pointer operator->() const { return &layout_->key(i_); }
+    reference operator[](const difference_type n) const { return layout_->key(i_ + n); }
+
+    KeyIterator &operator++() { ++i_; return *this; }
+    KeyIterator &operator--() { --i_; return *this; }
+    KeyIterator operator++(int) { KeyIterator tmp = *this; ++i_; return tmp; }
+    KeyIterator operator--(int) { KeyIterator tmp = *this; --i_; return tmp; }
+    KeyIterator &operator+=(const difference_type n) { i_ += n; return *this; }
+    KeyIterator &operator-=(const difference_type n) { i_ -= n; return *this; }
+    KeyIterator operator+(const difference_type n) const { return KeyIterator(layout_, i_ + n); }
+    KeyIterator operator-(const difference_type n) const { return KeyIterator(layout_, i_ - n); }
+    friend KeyIterator operator+(const difference_type n, const KeyIterator &it) { return it + n; }
+    difference_type operator-(const KeyIterator &other) const { return i_ - other.i_; }
+
+    bool operator==(const KeyIterator &other) const { return i_ == other.i_; }
+    bool operator!=(const KeyIterator &other) const { return i_ != other.i_; }
+    bool operator<(const KeyIterator &other) const { return i_ < other.i_; }
+    bool operator>(const KeyIterator &other) const { return i_ > other.i_; }
+    bool operator<=(const KeyIterator &other) const { return i_ <= other.i_; }
+    bool operator>=(const KeyIterator &other) const { return i_ >= other.i_; }
+};
+
+
+/*======================================================================================================================
+ * Storage Layouts
+ *====================================================================================================================*/
+
+/**
+ * Stores keys and values in two separate arrays. Searching touches the key array only, but a successful lookup incurs
+ * another cache miss on the value array.
+ * @tparam Key the type of the keys
+ * @tparam Value the type of the values
+ */
+template<typename Key, typename Value>
+class SeparateLayout
+{
+    public:
+    using key_type = Key;
+    using value_type = Value;
+    using key_iterator = typename std::vector<key_type>::const_iterator;
+
+    private:
+    std::vector<key_type> keys_;     ///< The sorted keys.
+    std::vector<value_type> values_; ///< The values in the order of their keys.
+
+    public:
+    /**
+     * Stores the sorted @p keys and their @p values.
+     * @param keys vector of sorted keys
+     * @param values vector of values in the order of @p keys
+     */
+    SeparateLayout(const std::vector<key_type> &keys, const std::vector<value_type> &values)
+        : keys_(keys)
+        , values_(values) { }
+
+    const key_type &key(const std::size_t i) const { return keys_[i]; }
+    const value_type &value(const std::size_t i) const { return values_[i]; }
+    key_iterator key_begin() const { return keys_.begin(); }
+    key_iterator key_end() const { return keys_.end(); }
+    std::size_t size() const { return keys_.size(); }
+    std::size_t size_in_bytes() const { return keys_.size() * sizeof(key_type) + values_.size() * sizeof(value_type); }
+};
+
+
+/**
+ * Stores key/value pairs in a single array. A value shares its cache line with its key unless the pair straddles a
+ * cache line boundary, but searching loads values along with keys.
+ * @tparam Key the type of the keys
+ * @tparam Value the type of the values
+ */
+template<typename Key, typename Value>
+class InterleavedLayout
+{
+    public:
+    using key_type = Key;
+    using value_type = Value;
+    using key_iterator = KeyIterator<InterleavedLayout>;
+
+    private:
+    std::vector<std::pair<key_type, value_type>> data_; ///< The key/value pairs sorted by key.
+
+    public:
+    /**
+     * Stores the sorted @p keys and their @p values.
+     * @param keys vector of sorted keys
+     * @param values vector of values in the order of @p keys
+     */
+    InterleavedLayout(const std::vector<key_type> &keys, const std::vector<value_type> &values) {
+        data_.reserve(keys.size());
+        for (std::size_t i = 0; i != keys.size(); ++i)
+            data_.emplace_back(keys[i], values[i]);
+    }
+
+    const key_type &key(const std::size_t i) const { return data_[i].first; }
+    const value_type &value(const std::size_t i) const { return data_[i].second; }
+    key_iterator key_begin() const { return key_iterator(this, 0); }
+    key_iterator key_end() const { return key_iterator(this, data_.size()); }
+    std::size_t size() const { return data_.size(); }
+    std::size_t size_in_bytes() const { return data_.size() * sizeof(data_[0]); }
+};
+
+
+/**
+ * Stores key/value pairs in cache-line-aligned blocks that hold a run of keys followed by their values. Searching
+ * within a block only compares keys stored next to each other, and a successful lookup finds its value in the same
+ * cache line. The number of pairs per block is the largest power of two that fits into a cache line.
+ * @tparam Key the type of the keys
+ * @tparam Value the type of the values
+ */
+template<typename Key, typename Value>
+class BlockedLayout
+{
+    public:
+    using key_type = Key;
+    using value_type = Value;
+    using key_iterator = KeyIterator<BlockedLayout>;
+
+    static constexpr std::size_t block_size = [] {
+        std::size_t n = 1;
+        while (2 * n * (sizeof(key_type) + sizeof(value_type)) <= cache_line_size) n *= 2;
+        return n;
+    }(); ///< The number of key/value pairs per block.
+
+    private:
+    /**
+     * A block of keys followed by their values.
+     */
+    struct alignas(cache_line_size) Block {
+        key_type keys[block_size];
+        value_type values[block_size];
+    };
+
+    std::vector<Block> blocks_; ///< The blocks of key/value pairs sorted by key.
+    std::size_t n_keys_;        ///< The number of keys.
+
+    public:
+    /**
+     * Stores the sorted @p keys and their @p values.
+     * @param keys vector of sorted keys
+     * @param values vector of values in the order of @p keys
+     */
+    BlockedLayout(const std::vector<key_type> &keys, const std::vector<value_type> &values)
+        : blocks_((keys.size() + block_size - 1) / block_size)
+        , n_keys_(keys.size())
+    {
+        for (std::size_t i = 0; i != n_keys_; ++i) {
+            blocks_[i / block_size].keys[i % block_size] = keys[i];
+            blocks_[i / block_size].values[i % block_size] = values[i];
+        }
+    }
+
+    const key_type &key(const std::size_t i) const { return blocks_[i / block_size].keys[i % block_size]; }
+    const value_type &value(const std::size_t i) const { return blocks_[i / block_size].values[i % block_size]; }
+    key_iterator key_begin() const { return key_iterator(this, 0); }
+    key_iterator key_end() const { return key_iterator(this, n_keys_); }
+    std::size_t size() const { return n_keys_; }
+    std::size_t size_in_bytes() const { return blocks_.size() * sizeof(Block); }
+};
+
+
+/*======================================================================================================================
+ * RMI Map
+ *====================================================================================================================*/
+
+/**
+ * Maps sorted keys to values with a recursive model index. Unlike Index, the map owns its keys and values and stores
+ * them according to @p Layout, so that a lookup finds the value without another random access into a separate array.
+ *
+ * @tparam Key the type of the keys
+ * @tparam Value the type of the values
+ * @tparam Rmi the type of the recursive model index, e.g. `RmiLAbs<Key, LinearSpline, LinearRegression>`
+ * @tparam Search the functor used for searching the interval returned by @p Rmi
+ * @tparam Layout the storage layout of keys and values, either SeparateLayout, InterleavedLayout, or BlockedLayout
+ */
+template<typename Key,
+         typename Value,
+         typename Rmi,
+         typename Search = BinarySearch,
+         template<typename, typename> class Layout = BlockedLayout>
+class RmiMap
+{
+    public:
+    using key_type = Key;
+    using value_type = Value;
+    using rmi_type = Rmi;
+    using search_type = Search;
+    using layout_type = Layout<key_type, value_type>;
+
+    private:
+    layout_type layout_; ///< The stored keys and values.
+    rmi_type rmi_;       ///< The recursive model index.
+    search_type search_; ///< The functor searching the interval of a key.
+
+    public:
+    /**
+     * Builds the map with @p layer2_size models in layer2 on the sorted, non-empty @p keys and their @p values.
+     * @param keys vector of sorted keys
+     * @param values vector of values in the order of @p keys
+     * @param layer2_size the number of models in layer2
+     * @param search functor searching the interval of a key
+     */
+    RmiMap(const std::vector<key_type> &keys, const std::vector<value_type> &values, const std::size_t layer2_size,
+           const search_type &search = search_type())
+        : layout_(keys, values)
+        , rmi_(layout_.key_begin(), layout_.key_end(), layer2_size)
+        , search_(search) { }
+
+    RmiMap(const RmiMap&) = delete;
+    RmiMap &operator=(const RmiMap&) = delete;
+
+    /**
+     * Returns a pointer to the value of the first occurrence of @p key.
+     * @param key to search for
+     * @return pointer to the value of @p key, or `nullptr` if @p key is not contained
+     */
+    const value_type *find(const key_type key) const {
+        auto approx = rmi_.search(key);
+        auto begin = layout_.key_begin();
+        auto it = search_(begin + approx.lo, begin + approx.hi, begin + approx.pos, key);
+        // Keys that are part of the data always lie within the search bounds.
+        if (it == layout_.key_end() or *it != key) return nullptr;
+        return &layout_.value(std::distance(begin, it));
+    }
+
+    /**
+     * Returns whether @p key is contained.
+     * @param key to search for
+     * @return whether @p key is contained
+     */
+    bool contains(const key_type key) const { return find(key) != nullptr; }
+
+    /**
+     * Returns the key at position @p i.
+     * @param i position of the key
+     * @return the key
+     */
+    const key_type &key(const std::size_t i) const { return layout_.key(i); }
+
+    /**
+     * Returns the value at position @p i.
+     * @param i position of the value
+     * @return the value
+     */
+    const value_type &value(const std::size_t i) const { return layout_.value(i); }
+
+    /**
+     * Returns the number of key/value pairs.
+     * @return number of key/value pairs
+     */
+    std::size_t size() const { return layout_.size(); }
+
+    /**
+     * Returns the underlying recursive model index.
+     * @return the recursive model index
+     */
+    const rmi_type &rmi() const { return rmi_; }
+
+    /**
+     * Returns the size of the map in bytes, including keys and values.
+     * @return map size in bytes
+     */
+    std::size_t size_in_bytes() const { return rmi_.size_in_bytes() + layout_.size_in_bytes(); }
+};
+
+} // namespace rmi
@@ -1,12 +1,39 @@
 #pragma once
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include <x86intrin.h>
 
 #include "rmi/util/fn.hpp"
 
+#ifndef RMI_RADIX_PEXT
+#ifdef __BMI2__
+#define RMI_RADIX_PEXT true
+#else
+#define RMI_RADIX_PEXT false
+#endif
+#endif
+
 namespace rmi {
 
+/**
+ * Whether the predictions of a model never decrease for increasing x-values. Models are not considered monotonic unless
+ * they opt in by specializing this trait.
+ * @tparam Model the type of the model
+ */
+template<typename Model>
+struct is_monotonic : std::false_type { };
+
+template<typename Model>
+inline constexpr bool is_monotonic_v = is_monotonic<Model>::value;
+
+
 /**
  * A model that fits a linear segment from the first first to the last data point.
  *
@@ -48,7 +75,7 @@ class LinearSpline
         }
 
         double numerator = static_cast<double>(n); // (offset + n) - offset
-        double denominator = static_cast<double>(*(last - 1) - *first);
+        double denominator = width(*first, *(last - 1));
 
         slope_ = denominator != 0.0 ? numerator/denominator * compression_factor : 0.0;
         intercept_ = offset * compression_factor - slope_ * *first;
@@ -78,7 +105,7 @@ class LinearSpline
      * Returns the size of the linear segment in bytes.
      * @return segment size in bytes.
      */
-    std::size_t size_in_bytes() { return 2 * sizeof(double); }
+    std::size_t size_in_bytes() const { return 2 * sizeof(double); }
 
     /**
      * Writes the mathematical representation of the linear segment to an output stream.
@@ -89,8 +116,31 @@ class LinearSpline
     friend std::ostream & operator<<(std::ostream &out, const LinearSpline &m) {
         return out << m.slope() << " * x + " << m.intercept();
     }
+
+    private:
+    /**
+     * Returns the distance between @p lo and @p hi without overflowing signed integral types.
+     * @tparam X the type of x-values
+     * @param lo, hi x-values with lo <= hi
+     * @return the distance between the x-values
+     */
+    template<typename X>
+    static double width(const X lo, const X hi) {
+        if constexpr (std::is_integral_v<X>) {
+            using unsigned_type = std::make_unsigned_t<X>;
+            return static_cast<double>(static_cast<unsigned_type>(hi) - static_cast<unsigned_type>(lo));
+        } else {
+            return static_cast<double>(hi) - static_cast<double>(lo);
+        }
+    }
 };
 
+/**
+ * LinearSpline is monotonic, since its slope from the first to the last data point is non-negative.
+ */
+template<>
+struct is_monotonic<LinearSpline> : std::true_type { };
+
 
 /**
  * A linear regression model that fits a straight line to minimize the mean squared error.
@@ -132,30 +182,40 @@ class LinearRegression
             return;
         }
 
-        double mean_x = 0.0;
-        double mean_y = 0.0;
-        double c = 0.0;
-        double m2 = 0.0;
-
-        for (std::size_t i = 0; i != n; ++i) {
-            auto x = *(first + i);
-            std::size_t y = offset + i;
-
-            double dx = x - mean_x;
-            mean_x += dx /  (i + 1);
-            mean_y += (y - mean_y) / (i + 1);
-            c += dx * (y - mean_y);
-
-            double dx2 = x - mean_x;
-            m2 += dx * dx2;
+        // Center x-values at the median and y-values at their mean. Distances of integral x-values are computed
+        // exactly in integer arithmetic unless they may overflow, i.e. if the x-values span more than half the range.
+        using x_type = typename std::iterator_traits<RandomIt>::value_type;
+        auto center = *(first + n / 2);
+        sums s;
+        if constexpr (std::is_integral_v<x_type>) {
+            using unsigned_type = std::make_unsigned_t<x_type>;
+            using signed_type = std::make_signed_t<x_type>;
+            auto range = static_cast<unsigned_type>(*(last - 1)) - static_cast<unsigned_type>(*first);
+            if (range <= static_cast<unsigned_type>(std::numeric_limits<signed_type>::max())) {
+                s = centered_sums(first, n, [center](const x_type x) {
+                    return static_cast<double>(static_cast<signed_type>(
+                            static_cast<unsigned_type>(x) - static_cast<unsigned_type>(center)));
+                });
+            } else {
+                s = centered_sums(first, n, [center](const x_type x) {
+                    return static_cast<double>(x) - static_cast<double>(center);
+                });
+            }
+        } else {
+            s = centered_sums(first, n, [center](const x_type x) {
+                return static_cast<double>(x) - static_cast<double>(center);
+            });
         }
 
-        double cov = c / (n - 1);
-        double var = m2 / (n - 1);
+        double mean_dx = s.dx / n;
+        double mean_x = static_cast<double>(center) + mean_dx;
+        double mean_y = offset + (n - 1) / 2.;
+        double var = s.dx_dx - mean_dx * s.dx; // n times the variance of x-values
+        double cov = s.dx_dy;                  // n times the covariance of x- and y-values
 
-        if (var == 0.f) {
+        if (var <= 0.) {
             slope_  = 0.f;
-            intercept_ = mean_y;
+            intercept_ = mean_y * compression_factor;
             return;
         }
 
@@ -163,6 +223,83 @@ class LinearRegression
         intercept_ = mean_y * compression_factor - slope_ * mean_x;
     }
 
+    private:
+    /**
+     * Sums of centered x- and y-values and their products.
+     */
+    struct sums {
+        double dx = 0.;    ///< The sum of centered x-values.
+        double dx_dx = 0.; ///< The sum of squared centered x-values.
+        double dx_dy = 0.; ///< The sum of products of centered x- and y-values.
+    };
+
+    /**
+     * Adds @p v to the sum @p sum and accumulates the rounding error of the addition in @p err (TwoSum).
+     * @param sum the sum
+     * @param err the accumulated rounding errors of the sum
+     * @param v the value to add
+     */
+    static void add(double &sum, double &err, const double v) {
+        double s = sum + v;
+        double z = s - sum;
+        err += (sum - (s - z)) + (v - z);
+        sum = s;
+    }
+
+    /**
+     * Computes the sums of the x-values centered by @p delta, their squares, and their products with the y-values
+     * centered at their mean. The sums are accumulated in independent lanes, which lets the compiler vectorize the loop
+     * without reassociating floating-point additions. Each lane is compensated, i.e. the rounding errors of additions
+     * and products are accumulated separately and added in the end, so that the sums are as accurate as if computed in
+     * twice the precision.
+     * @param first iterator to the first x-value
+     * @param n number of x-values
+     * @param delta function computing the distance of an x-value to the center
+     * @return the sums
+     */
+    template<typename RandomIt, typename Delta>
+    static sums centered_sums(RandomIt first, const std::size_t n, Delta delta) {
+        constexpr std::size_t n_lanes = 4;
+        double dx[n_lanes] = {}, dx_err[n_lanes] = {};
+        double dx_dx[n_lanes] = {}, dx_dx_err[n_lanes] = {};
+        double dx_dy[n_lanes] = {}, dx_dy_err[n_lanes] = {};
+        const double center_y = (n - 1) / 2.;
+
+        auto accumulate = [&](const std::size_t l, const double x, const double y) {
+            double xx = x * x;
+            double xy = x * y;
+            add(dx[l], dx_err[l], x);
+            add(dx_dx[l], dx_dx_err[l], xx);
+            add(dx_dy[l], dx_dy_err[l], xy);
+            dx_dx_err[l] += std::fma(x, x, -xx); // rounding error of the product
+            dx_dy_err[l] += std::fma(x, y, -xy);
+        };
+
+        std::size_t i = 0;
+        for (; i + n_lanes <= n; i += n_lanes) {
+            for (std::size_t l = 0; l != n_lanes; ++l)
+                accumulate(l, delta(*(first + i + l)), static_cast<double>(i + l) - center_y);
+        }
+        for (std::size_t l = 0; i != n; ++i, ++l)
+            accumulate(l, delta(*(first + i)), static_cast<double>(i) - center_y);
+
+        double err[3] = {};
+        sums s;
+        for (std::size_t l = 0; l != n_lanes; ++l) {
+            add(s.dx, err[0], dx[l]);
+            add(s.dx_dx, err[1], dx_dx[l]);
+            add(s.dx_dy, err[2], dx_dy[l]);
+            err[0] += dx_err[l];
+            err[1] += dx_dx_err[l];
+            err[2] += dx_dy_err[l];
+        }
+        s.dx += err[0];
+        s.dx_dx += err[1];
+        s.dx_dy += err[2];
+        return s;
+    }
+
+    public:
     /**
      * Returns the estimated y-value of @p x.
      * @param x to estimate a y-value for
@@ -187,7 +324,7 @@ class LinearRegression
      * Returns the size of the linear regression model in bytes.
      * @return model size in bytes.
      */
-    std::size_t size_in_bytes() { return 2 * sizeof(double); }
+    std::size_t size_in_bytes() const { return 2 * sizeof(double); }
 
     /**
      * Writes the mathematical representation of the linear regression model to an output stream.
@@ -200,9 +337,25 @@ class LinearRegression
     }
 };
 
+/**
+ * LinearRegression is monotonic, since the least-squares slope of sorted data is non-negative.
+ */
+template<>
+struct is_monotonic<LinearRegression> : std::true_type { };
+
 
 /**
- * A model that fits a cubic segment from the first first to the last data point.
+ * A model that fits a monotone cubic segment from the first to the last data point.
+ *
+ * The segment is a cubic Hermite spline through the first and last data point whose end slopes are chosen among
+ * several candidates, which are derived from secants at different quantiles of the data points as well as a straight
+ * line. Each candidate is made monotone by scaling its end slopes to the region of Fritsch and Carlson and all
+ * candidates are evaluated simultaneously on a sample of the data points. The candidate with the smallest mean
+ * absolute error on the sample wins, hence the segment is never worse than a linear spline on the sample.
+ *
+ * The segment is evaluated on x-values rebased to the first x-value, which avoids the cancellation between the terms
+ * of the polynomial that large x-values, e.g. 64-bit keys, would otherwise cause. Integral x-values are rebased in
+ * integer arithmetic, see rebase(), so that they are not rounded to double before the subtraction.
  *
  * We assume that x-values are sorted in ascending order and y-values are handed implicitly where @p offset and @p
  * offset + distance(first, last) are the first and last y-value, respectively. The y-values can be scaled by
@@ -211,10 +364,14 @@ class LinearRegression
 class CubicSpline
 {
     private:
-    double a_; ///< The cubic coefficient.
-    double b_; ///< The quadric coefficietn.
-    double c_; ///< The linear coefficient.
-    double d_; ///< The y-intercept.
+    double xmin_; ///< The first x-value, rounded down to a double, which x-values are rebased to.
+    double a_;    ///< The cubic coefficient.
+    double b_;    ///< The quadric coefficient.
+    double c_;    ///< The linear coefficient.
+    double d_;    ///< The y-intercept.
+
+    static constexpr std::size_t n_candidates = 5;  ///< The number of candidate end slopes.
+    static constexpr std::size_t sample_size = 256; ///< The maximum number of data points candidates are evaluated on.
 
     public:
     /**
@@ -229,7 +386,9 @@ class CubicSpline
      * @param compression_factor by which the y-values are scaled
      */
     template<typename RandomIt>
-    CubicSpline(RandomIt first, RandomIt last, std::size_t offset = 0, double compression_factor = 1.f) {
+    CubicSpline(RandomIt first, RandomIt last, std::size_t offset = 0, double compression_factor = 1.f)
+        : xmin_(0.f)
+    {
         std::size_t n = std::distance(first, last);
 
         if (n == 0) {
@@ -239,7 +398,10 @@ class CubicSpline
             d_ = 0.f;
             return;
         }
-        if (n == 1 or *first == *(last - 1)) {
+        xmin_ = round_down(*first);
+        double x0 = rebase(*first, xmin_); // non-zero if the first x-value is not representable as double
+        double width = rebase(*(last - 1), xmin_) - x0;
+        if (n == 1 or width == 0.0) {
             a_ = 0.f;
             b_ = 0.f;
             c_ = 0.f;
@@ -247,85 +409,60 @@ class CubicSpline
             return;
         }
 
-        double xmin = static_cast<double>(*first);
-        double ymin = static_cast<double>(offset) * compression_factor;
-        double xmax = static_cast<double>(*(last - 1));
-        double ymax = static_cast<double>(offset + n - 1) * compression_factor;
-
-        double x1 = 0.0;
-        double y1 = 0.0;
-        double x2 = 1.0;
-        double y2 = 1.0;
-
-        double sxn, syn = 0.0;
-        for (std::size_t i = 0; i != n; ++i) {
-            double x = static_cast<double>(*(first + i));
-            double y = static_cast<double>(offset + i) * compression_factor;
-            sxn = (x - xmin) / (xmax - xmin);
-            if (sxn > 0.0) {
-                syn = (y - ymin) / (ymax - ymin);
-                break;
-            }
+        // Fit in normalized coordinates, i.e. on the unit square, where the segment passes through (0, 0) and (1, 1).
+        auto normalized = [&](std::size_t i) {
+            return std::make_pair((rebase(*(first + i), xmin_) - x0) / width, static_cast<double>(i) / (n - 1));
+        };
+
+        // Derive candidate end slopes from secants to the first and last data point, using the closest data points
+        // that differ in x-value and data points at quantiles 1%, 5%, and 25%. The last candidate is a straight line.
+        double m1[n_candidates];
+        double m2[n_candidates];
+        const double quantiles[n_candidates - 1] = { 0.0, 0.01, 0.05, 0.25 };
+        for (std::size_t k = 0; k != n_candidates - 1; ++k) {
+            std::size_t lo = std::max<std::size_t>(1, quantiles[k] * (n - 1));
+            std::size_t hi = std::min<std::size_t>(n - 2, (1. - quantiles[k]) * (n - 1));
+            auto p = normalized(lo);
+            while (p.first == 0.0) p = normalized(++lo); // skip duplicates of the first x-value
+            auto q = normalized(hi);
+            while (q.first == 1.0) q = normalized(--hi); // skip duplicates of the last x-value
+            m1[k] = p.second / p.first;
+            m2[k] = (1.0 - q.second) / (1.0 - q.first);
         }
-        double m1 = (syn - y1) / (sxn - x1);
-
-        double sxp, syp = 0.0;
-        for (std::size_t i = 0; i != n; ++i) {
-            double x = static_cast<double>(*(first + i));
-            double y = static_cast<double>(offset + i) * compression_factor;
-            sxp = (x - xmin) / (xmax - xmin);
-            if (sxp < 1.0) {
-                syp = (y - ymin) / (ymax - ymin);
-                break;
+        m1[n_candidates - 1] = 1.0;
+        m2[n_candidates - 1] = 1.0;
+
+        // Scale end slopes into the circle of radius 3, which is sufficient for a monotone segment.
+        for (std::size_t k = 0; k != n_candidates; ++k) {
+            double norm = m1[k] * m1[k] + m2[k] * m2[k];
+            if (norm > 9.0) {
+                double tau = 3.0 / std::sqrt(norm);
+                m1[k] *= tau;
+                m2[k] *= tau;
             }
         }
-        double m2 = (y2 - syp) / (x2 - sxp);
 
-        if (std::pow(m1, 2.0) + std::pow(m2, 2.0) > 9.0) {
-            double tau = 3.0 / std::sqrt(std::pow(m1, 2.0) + std::pow(m2, 2.0));
-            m1 *= tau;
-            m2 *= tau;
+        // Evaluate all candidates on an evenly spaced sample of the data points.
+        double error[n_candidates] = {};
+        std::size_t n_samples = std::min(n, sample_size);
+        for (std::size_t s = 0; s != n_samples; ++s) {
+            auto [x, y] = normalized(n_samples == 1 ? 0 : s * (n - 1) / (n_samples - 1));
+            for (std::size_t k = 0; k != n_candidates; ++k)
+                error[k] += std::abs(hermite(m1[k], m2[k], x) - y);
         }
+        std::size_t best = std::distance(error, std::min_element(error, error + n_candidates));
 
-        a_ = (m1 + m2 - 2.0)
-            / std::pow(xmax - xmin, 3.0);
-
-        b_ = -(xmax * (2.0 * m1 + m2 - 3.0) + xmin * (m1 + 2.0 * m2 - 3.0))
-            / std::pow(xmax - xmin, 3.0);
-
-        c_ = (m1 * std::pow(xmax, 2.0) + m2 * std::pow(xmin, 2.0) + xmax * xmin * (2.0 * m1 + 2.0 * m2 - 6.0))
-            / std::pow(xmax - xmin, 3.0);
-
-        d_ = -xmin * (m1 * std::pow(xmax, 2.0) + xmax * xmin * (m2 - 3.0) + std::pow(xmin, 2.0))
-            / std::pow(xmax - xmin, 3.0);
-
-        a_ *= ymax - ymin;
-        b_ *= ymax - ymin;
-        c_ *= ymax - ymin;
-        d_ *= ymax - ymin;
-        d_ += ymin;
-
-        // Check if linear spline performs better.
-        // LinearSpline ls(first, last, offset, compression_factor);
-
-        // double ls_error = 0.f;
-        // double cs_error = 0.f;
-
-        // for (std::size_t i = 0; i != n; ++i) {
-        //     double y = (offset +i) * compression_factor;
-        //     auto key = *(first + i);
-        //     double ls_pred = ls.predict(key);
-        //     double cs_pred = predict(key);
-        //     ls_error += std::abs(ls_pred - y);
-        //     cs_error += std::abs(cs_pred - y);
-        // }
-
-        // if (ls_error < cs_error) {
-        //     a_ = 0;
-        //     b_ = 0;
-        //     c_ = ls.slope();
-        //     d_ = ls.intercept();
-        // }
+        // Scale coefficients from the unit square to x-values relative to the first one and y-values, then shift them to
+        // rebased x-values.
+        double ymin = static_cast<double>(offset) * compression_factor;
+        double height = static_cast<double>(n - 1) * compression_factor;
+        double a = (m1[best] + m2[best] - 2.0) * height / (width * width * width);
+        double b = (3.0 - 2.0 * m1[best] - m2[best]) * height / (width * width);
+        double c = m1[best] * height / width;
+        a_ = a;
+        b_ = b - 3.0 * a * x0;
+        c_ = c - (2.0 * b - 3.0 * a * x0) * x0;
+        d_ = ymin - (c - (b - a * x0) * x0) * x0;
     }
 
     /**
@@ -335,13 +472,37 @@ class CubicSpline
      */
     template<typename X>
     double predict(const X x) const {
-        double x_ = static_cast<double>(x);
+        double x_ = rebase(x, xmin_);
         double v1 = std::fma(a_, x_, b_);
         double v2 = std::fma(v1, x_, c_);
         double v3 = std::fma(v2, x_, d_);
         return v3;
     }
 
+    /** Returns the first x-value, rounded down to a double, which x-values are rebased to.
+     * @return the first x-value
+     */
+    double xmin() const { return xmin_; }
+
+    /**
+     * Returns @p x rebased to @p xmin, i.e. x - xmin. For integral x-values, @p xmin must be a value of type X, and the
+     * difference is computed exactly in integer arithmetic and rounded to double only once.
+     * @param x the x-value
+     * @param xmin the x-value to rebase to
+     * @return the rebased x-value
+     */
+    template<typename X>
+    static double rebase(const X x, const double xmin) {
+        if constexpr (std::is_integral_v<X>) {
+            using unsigned_type = std::make_unsigned_t<X>;
+            X base = static_cast<X>(xmin);
+            auto d = static_cast<unsigned_type>(x) - static_cast<unsigned_type>(base);
+            return x >= base ? static_cast<double>(d) : -static_cast<double>(static_cast<unsigned_type>(-d));
+        } else {
+            return static_cast<double>(x) - xmin;
+        }
+    }
+
     /** Returns the cubic coefficient.
      * @return the cubic coefficient
      */
@@ -366,7 +527,7 @@ class CubicSpline
      * Returns the size of the cubic segment in bytes.
      * @return segment size in bytes.
      */
-    std::size_t size_in_bytes() { return 4 * sizeof(double); }
+    std::size_t size_in_bytes() const { return 5 * sizeof(double); }
 
     /**
      * Writes the mathematical representation of the cubic segment to an output stream.
@@ -375,65 +536,516 @@ class CubicSpline
      * @returns the output stream
      */
     friend std::ostream & operator<<(std::ostream &out, const CubicSpline &m) {
-        return out << m.a() << " * x^3 + "
-                   << m.b() << " * x^2 + "
-                   << m.c() << " * x + d";
+        return out << m.a() << " * u^3 + "
+                   << m.b() << " * u^2 + "
+                   << m.c() << " * u + "
+                   << m.d() << " with u = x - " << m.xmin();
+    }
+
+    private:
+    /**
+     * Returns the largest double that does not exceed @p x. For integral x-values, the result is a value of type X.
+     * @param x the x-value
+     * @return @p x rounded down to a double
+     */
+    template<typename X>
+    static double round_down(const X x) {
+        double d = static_cast<double>(x);
+        if constexpr (std::is_integral_v<X>) {
+            if (d >= std::ldexp(1., std::numeric_limits<X>::digits) or static_cast<X>(d) > x)
+                d = std::nextafter(d, -std::numeric_limits<double>::infinity());
+        }
+        return d;
+    }
+
+    /**
+     * Evaluates the cubic Hermite spline through (0, 0) and (1, 1) with end slopes @p m1 and @p m2 at @p x.
+     * @param m1, m2 the slopes at x = 0 and x = 1
+     * @param x the x-value in [0, 1]
+     * @return the y-value at @p x
+     */
+    static double hermite(const double m1, const double m2, const double x) {
+        return ((m1 + m2 - 2.0) * x + (3.0 - 2.0 * m1 - m2)) * x * x + m1 * x;
     }
 };
 
+/**
+ * CubicSpline is monotonic, since its end slopes are scaled into the region of Fritsch and Carlson.
+ */
+template<>
+struct is_monotonic<CubicSpline> : std::true_type { };
+
 
 /**
- * A radix model that projects a x-values to their most significant bits after eliminating the common prefix.
+ * A linear model that picks, for the data points it is fit on, whichever of a linear spline, a linear regression, and
+ * a constant function yields the smallest mean log2 error, i.e. the mean of log2(|e| + 1) over the errors e of all data
+ * points, which `rmi_errors` reports as `mean_log2_ae`.
+ *
+ * All candidates are linear functions, hence the model stores the coefficients of the winner in the same space as a
+ * single linear model and predicts without dispatching on the candidate. Segments of an RMI with this layer2 model
+ * therefore select their model type individually at no extra cost in size or lookup time.
  *
  * We assume that x-values are sorted in ascending order and y-values are handed implicitly where @p offset and @p
  * offset + distance(first, last) are the first and last y-value, respectively. The y-values can be scaled by
  * providing a @p compression_factor.
+ */
+class AutoLinear
+{
+    private:
+    double slope_;     ///< The slope of the linear function.
+    double intercept_; ///< The y-intercept of the linear function.
+
+    public:
+    /**
+     * Default constructor.
+     */
+    AutoLinear() = default;
+
+    /**
+     * Fits each candidate on the given data points and keeps the one with the smallest mean log2 error.
+     * @param first, last iterators to the first and last x-value the candidates are fit on
+     * @param offset first y-value the candidates are fit on
+     * @param compression_factor by which the y-values are scaled
+     */
+    template<typename RandomIt>
+    AutoLinear(RandomIt first, RandomIt last, std::size_t offset = 0, double compression_factor = 1.f) {
+        std::size_t n = std::distance(first, last);
+        LinearRegression lr(first, last, offset, compression_factor);
+        LinearSpline ls(first, last, offset, compression_factor);
+        double median = static_cast<double>(offset + (n == 0 ? 0 : (n - 1) / 2)) * compression_factor;
+
+        // Sum up the log2 errors of all candidates in a single pass. Estimates are truncated to positions like in the
+        // lookup of an RMI.
+        const double slopes[] = { lr.slope(), ls.slope(), 0. };
+        const double intercepts[] = { lr.intercept(), ls.intercept(), median };
+        double errors[] = { 0., 0., 0. };
+        for (std::size_t i = 0; i != n; ++i) {
+            double x = static_cast<double>(*(first + i));
+            double y = static_cast<double>(offset + i) * compression_factor;
+            for (std::size_t k = 0; k != 3; ++k) {
+                double pos = std::floor(std::max(0., std::fma(slopes[k], x, intercepts[k])));
+                errors[k] += std::log2(std::abs(pos - y) + 1.);
+            }
+        }
+
+        std::size_t best = std::distance(errors, std::min_element(errors, errors + 3));
+        slope_ = slopes[best];
+        intercept_ = intercepts[best];
+    }
+
+    /**
+     * Returns the estimated y-value of @p x.
+     * @param x to estimate a y-value for
+     * @return the estimated y-value for @p x
+     */
+    template<typename X>
+    double predict(const X x) const { return std::fma(slope_, static_cast<double>(x), intercept_); }
+
+    /**
+     * Returns the slope of the chosen linear function.
+     * @return the slope of the chosen linear function
+     */
+    double slope() const { return slope_; }
+
+    /**
+     * Returns the y-intercept of the chosen linear function.
+     * return the y-intercept of the chosen linear function
+     */
+    double intercept() const { return intercept_; }
+
+    /**
+     * Returns the size of the model in bytes.
+     * @return model size in bytes.
+     */
+    std::size_t size_in_bytes() const { return 2 * sizeof(double); }
+
+    /**
+     * Writes the mathematical representation of the chosen linear function to an output stream.
+     * @param out output stream to write the linear function to
+     * @param m the model
+     * @returns the output stream
+     */
+    friend std::ostream & operator<<(std::ostream &out, const AutoLinear &m) {
+        return out << m.slope() << " * x + " << m.intercept();
+    }
+};
+
+/**
+ * AutoLinear is monotonic, since each of its candidates is.
+ */
+template<>
+struct is_monotonic<AutoLinear> : std::true_type { };
+
+
+/**
+ * A piecewise linear model that approximates each data point within a maximum error of @p Epsilon.
+ *
+ * The data points are split into as few linear pieces as possible in a single pass using the optimal streaming
+ * algorithm of O'Rourke (https://doi.org/10.1145/358645.358652), also used by the PGM-index. Each piece is stored
+ * relative to its first x-value to preserve precision. A model consisting of a single piece does not allocate.
+ *
+ * The first piece is stored inline. If x-values precede the second piece, predict() evaluates it without further memory
+ * accesses, otherwise it binary searches the remaining k pieces in O(log k) steps. Inside an RMI, the remaining pieces of
+ * all models share a single array allocated by the RMI's allocator, see AosStorage.
  *
- * @tparam the type of x-values.
+ * We assume that x-values are sorted in ascending order and y-values are handed implicitly where @p offset and @p
+ * offset + distance(first, last) are the first and last y-value, respectively. The y-values can be scaled by
+ * providing a @p compression_factor, in which case @p Epsilon refers to scaled y-values. Duplicate x-values are
+ * approximated by the y-value of their first occurrence.
+ * Estimates may drop at the boundary between two pieces, hence the model is not monotonic, see is_monotonic.
+ *
+ * @tparam X the type of x-values
+ * @tparam Epsilon the maximum error of the estimated y-values
  */
-template<typename X = uint64_t>
-class Radix
+template<typename X = uint64_t, std::size_t Epsilon = 32>
+class PiecewiseLinear
 {
     using x_type = X;
 
+    public:
+    /**
+     * A linear piece starting at x-value @p key.
+     */
+    struct piece {
+        x_type key;       ///< The first x-value of the piece.
+        double slope;     ///< The slope of the piece.
+        double intercept; ///< The y-value of the piece at @p key.
+    };
+
     private:
-    x_type mask_; ///< The mask for parallel bits extract.
+    piece first_;             ///< The first piece.
+    std::vector<piece> rest_; ///< The remaining pieces, sorted by their first x-value.
 
     public:
-    /*
+    static constexpr std::size_t epsilon = Epsilon; ///< The maximum error of the estimated y-values.
+
+    /**
      * Default constructor.
      */
-    Radix() = default;
+    PiecewiseLinear() = default;
 
     /**
-     * Builds a radix model on the given data points.
-     * @param first, last iterators to the first and last x-value the linear regression is fit on
-     * @param offset first y-value the linear regression is fit on
+     * Builds a piecewise linear model on the given data points.
+     * @param first, last iterators to the first and last x-value the model is fit on
+     * @param offset first y-value the model is fit on
      * @param compression_factor by which the y-values are scaled
      */
     template<typename RandomIt>
-    Radix(RandomIt first, RandomIt last, std::size_t offset = 0, double compression_factor = 1.f) {
+    PiecewiseLinear(RandomIt first, RandomIt last, std::size_t offset = 0, double compression_factor = 1.f) {
         std::size_t n = std::distance(first, last);
 
         if (n == 0) {
-            mask_ = 0;
+            first_ = {x_type(), 0.0, 0.0};
             return;
         }
 
-        auto prefix = common_prefix_width(*first, *(last - 1)); // compute common prefix length
+        Fit fit(epsilon);
+        x_type key = *first;
+        std::vector<piece> pieces;
+        for (std::size_t i = 0; i != n; ++i) {
+            x_type x = *(first + i);
+            if (i != 0 and x == *(first + i - 1)) continue; // approximate duplicates by their first occurrence
+            long double y = static_cast<long double>(offset + i) * compression_factor;
+            if (not fit.add(distance<long double>(key, x), y)) {
+                // Start a new piece at x.
+                auto [slope, intercept] = fit.line();
+                pieces.push_back({key, static_cast<double>(slope), static_cast<double>(intercept)});
+                key = x;
+                fit.reset();
+                fit.add(0, y);
+            }
+        }
+        auto [slope, intercept] = fit.line();
+        pieces.push_back({key, static_cast<double>(slope), static_cast<double>(intercept)});
 
-        if (prefix == (sizeof(x_type) * 8)) {
-            mask_ = 42; // TODO: What should the mask be in this case?
-            return;
+        first_ = pieces.front();
+        rest_.assign(pieces.begin() + 1, pieces.end());
+    }
+
+    /**
+     * Returns the estimated y-value of @p x.
+     * @param x to estimate a y-value for
+     * @return the estimated y-value for @p x
+     */
+    double predict(const x_type x) const { return predict(first_, rest_.data(), rest_.size(), x); }
+
+    /**
+     * Returns the estimated y-value of @p x by the piecewise linear model with the given pieces.
+     * @param first the first piece
+     * @param rest, n_rest the remaining pieces, sorted by their first x-value, and their number
+     * @param x to estimate a y-value for
+     * @return the estimated y-value for @p x
+     */
+    static double predict(const piece &first, const piece *rest, const std::size_t n_rest, const x_type x) {
+        const piece *p = &first;
+        if (n_rest != 0 and not (x < rest[0].key)) {
+            p = std::upper_bound(rest, rest + n_rest, x, [](const x_type x, const piece &p) { return x < p.key; }) - 1;
         }
+        return std::fma(p->slope, distance<double>(p->key, x), p->intercept);
+    }
+
+    /**
+     * Returns the first linear piece.
+     * @return the first linear piece
+     */
+    const piece &first_piece() const { return first_; }
+
+    /**
+     * Returns the remaining linear pieces, sorted by their first x-value.
+     * @return the remaining linear pieces
+     */
+    const std::vector<piece> &rest_pieces() const { return rest_; }
+
+    /**
+     * Returns the number of linear pieces.
+     * @return the number of linear pieces
+     */
+    std::size_t n_pieces() const { return 1 + rest_.size(); }
+
+    /**
+     * Returns the size of the piecewise linear model in bytes.
+     * @return model size in bytes.
+     */
+    std::size_t size_in_bytes() const { return sizeof(first_) + sizeof(rest_) + rest_.size() * sizeof(piece); }
+
+    /**
+     * Writes the mathematical representation of the piecewise linear model to an output stream.
+     * @param out output stream to write the piecewise linear model to
+     * @param m the piecewise linear model
+     * @returns the output stream
+     */
+    friend std::ostream & operator<<(std::ostream &out, const PiecewiseLinear &m) {
+        out << m.first_.slope << " * (x - " << m.first_.key << ") + " << m.first_.intercept;
+        for (auto &p : m.rest_)
+            out << ", x >= " << p.key << ": " << p.slope << " * (x - " << p.key << ") + " << p.intercept;
+        return out;
+    }
+
+    private:
+    /**
+     * Returns the signed distance from @p from to @p to without overflowing integral types.
+     * @tparam T the floating-point type of the distance
+     * @param from, to x-values
+     * @return the distance between the x-values, negative if @p to is less than @p from
+     */
+    template<typename T>
+    static T distance(const x_type from, const x_type to) {
+        if constexpr (std::is_integral_v<x_type>) {
+            using unsigned_type = std::make_unsigned_t<x_type>;
+            auto lo = static_cast<unsigned_type>(from);
+            auto hi = static_cast<unsigned_type>(to);
+            return to < from ? -static_cast<T>(lo - hi) : static_cast<T>(hi - lo);
+        } else {
+            return static_cast<T>(to) - static_cast<T>(from);
+        }
+    }
+
+    /**
+     * Incrementally fits a line to points with strictly increasing x-values such that the line approximates all points
+     * within an error of epsilon. Maintains the convex hulls of the points shifted up and down by epsilon and the
+     * extreme feasible lines through them.
+     */
+    class Fit
+    {
+        /**
+         * A point, or the direction between two points.
+         */
+        struct point {
+            long double x; ///< The x-value.
+            long double y; ///< The y-value.
+        };
+
+        long double epsilon_;      ///< The maximum error.
+        std::size_t n_ = 0;        ///< The number of points added since the last reset.
+        point rect_[4];            ///< The points defining the extreme lines of minimal and maximal slope.
+        std::vector<point> upper_; ///< The convex hull of the points shifted up by epsilon.
+        std::vector<point> lower_; ///< The convex hull of the points shifted down by epsilon.
+        std::size_t upper_start_ = 0; ///< The first point of the upper hull that is still relevant.
+        std::size_t lower_start_ = 0; ///< The first point of the lower hull that is still relevant.
+
+        public:
+        explicit Fit(const long double epsilon) : epsilon_(epsilon) { }
+
+        /**
+         * Discards all points.
+         */
+        void reset() { n_ = 0; }
+
+        /**
+         * Adds the point (@p x, @p y) if a line approximating all points within epsilon exists afterwards.
+         * @param x the x-value, greater than the x-value of the previous point
+         * @param y the y-value
+         * @return whether the point was added
+         */
+        bool add(const long double x, const long double y) {
+            point p1{x, y + epsilon_}; // upper bound
+            point p2{x, y - epsilon_}; // lower bound
+
+            if (n_ == 0) {
+                rect_[0] = p1;
+                rect_[1] = p2;
+                upper_.assign(1, p1);
+                lower_.assign(1, p2);
+                upper_start_ = 0;
+                lower_start_ = 0;
+                ++n_;
+                return true;
+            }
+            if (n_ == 1) {
+                rect_[2] = p2;
+                rect_[3] = p1;
+                upper_.push_back(p1);
+                lower_.push_back(p2);
+                ++n_;
+                return true;
+            }
+
+            point slope1 = diff(rect_[2], rect_[0]); // minimal slope
+            point slope2 = diff(rect_[3], rect_[1]); // maximal slope
+            if (less(diff(p1, rect_[2]), slope1) or less(slope2, diff(p2, rect_[3]))) return false;
+
+            if (less(diff(p1, rect_[1]), slope2)) { // upper bound lowers the maximal slope
+                point min = diff(lower_[lower_start_], p1);
+                std::size_t min_i = lower_start_;
+                for (std::size_t i = lower_start_ + 1; i < lower_.size(); ++i) {
+                    point val = diff(lower_[i], p1);
+                    if (less(min, val)) break;
+                    min = val;
+                    min_i = i;
+                }
+                rect_[1] = lower_[min_i];
+                rect_[3] = p1;
+                lower_start_ = min_i;
+
+                std::size_t end = upper_.size();
+                while (end >= upper_start_ + 2 and cross(upper_[end - 2], upper_[end - 1], p1) <= 0) --end;
+                upper_.resize(end);
+                upper_.push_back(p1);
+            }
+
+            if (less(slope1, diff(p2, rect_[0]))) { // lower bound raises the minimal slope
+                point max = diff(upper_[upper_start_], p2);
+                std::size_t max_i = upper_start_;
+                for (std::size_t i = upper_start_ + 1; i < upper_.size(); ++i) {
+                    point val = diff(upper_[i], p2);
+                    if (less(val, max)) break;
+                    max = val;
+                    max_i = i;
+                }
+                rect_[0] = upper_[max_i];
+                rect_[2] = p2;
+                upper_start_ = max_i;
+
+                std::size_t end = lower_.size();
+                while (end >= lower_start_ + 2 and cross(lower_[end - 2], lower_[end - 1], p2) >= 0) --end;
+                lower_.resize(end);
+                lower_.push_back(p2);
+            }
+
+            ++n_;
+            return true;
+        }
+
+        /**
+         * Returns a line that approximates all points within epsilon. Its slope is the mean of the extreme slopes and
+         * it passes through the intersection of the extreme lines.
+         * @return slope and y-intercept of the line
+         */
+        std::pair<long double, long double> line() const {
+            if (n_ == 1) return {0, (rect_[0].y + rect_[1].y) / 2};
+            point slope1 = diff(rect_[2], rect_[0]);
+            point slope2 = diff(rect_[3], rect_[1]);
+            long double slope = (slope1.y / slope1.x + slope2.y / slope2.x) / 2;
+
+            point intersection = rect_[0];
+            long double det = slope1.x * slope2.y - slope1.y * slope2.x;
+            if (det != 0) {
+                point d = diff(rect_[1], rect_[0]);
+                long double t = (d.x * slope2.y - d.y * slope2.x) / det;
+                intersection = {rect_[0].x + t * slope1.x, rect_[0].y + t * slope1.y};
+            }
+            return {slope, intersection.y - intersection.x * slope};
+        }
+
+        private:
+        static point diff(const point &a, const point &b) { return {a.x - b.x, a.y - b.y}; }
+
+        /**
+         * Returns whether direction @p s is less steep than direction @p t, both pointing into the same half-plane.
+         */
+        static bool less(const point &s, const point &t) { return s.y * t.x < s.x * t.y; }
+
+        /**
+         * Returns the cross product of the directions from @p o to @p a and from @p o to @p b.
+         */
+        static long double cross(const point &o, const point &a, const point &b) {
+            point oa = diff(a, o);
+            point ob = diff(b, o);
+            return oa.x * ob.y - oa.y * ob.x;
+        }
+    };
+};
+
+/**
+ * A radix model that projects a x-values to their most significant bits after eliminating the common prefix.
+ *
+ * Signed and floating-point x-values are mapped to unsigned integers of the same width by the order-preserving
+ * transformation radix_key() first.
+ *
+ * Since the projected bits are contiguous, the projection is computed either by parallel bits extract `_pext` or,
+ * equivalently, by masking and shifting. `_pext` is microcoded and slow on AMD processors prior to Zen 3, hence the
+ * variant is chosen at build time via `RMI_RADIX_PEXT`, which defaults to `_pext` if BMI2 is available.
+ *
+ * We assume that x-values are sorted in ascending order and y-values are handed implicitly where @p offset and @p
+ * offset + distance(first, last) are the first and last y-value, respectively. The y-values can be scaled by
+ * providing a @p compression_factor. If all x-values are equal, no bits remain and all x-values are mapped to 0.
+ *
+ * @tparam X the type of x-values
+ * @tparam Pext whether the projection is computed by `_pext` instead of masking and shifting
+ */
+template<typename X = uint64_t, bool Pext = RMI_RADIX_PEXT>
+class Radix
+{
+    using x_type = X;
+    using radix_type = radix_key_t<X>;
+
+    private:
+    radix_type mask_; ///< The mask of the projected bits.
+    uint8_t shift_;   ///< The number of bits below the projected bits.
+
+    public:
+    /*
+     * Default constructor.
+     */
+    Radix() = default;
+
+    /**
+     * Builds a radix model on the given data points.
+     * @param first, last iterators to the first and last x-value the linear regression is fit on
+     * @param offset first y-value the linear regression is fit on
+     * @param compression_factor by which the y-values are scaled
+     */
+    template<typename RandomIt>
+    Radix(RandomIt first, RandomIt last, std::size_t offset = 0, double compression_factor = 1.f)
+        : mask_(0)
+        , shift_(0)
+    {
+        std::size_t n = std::distance(first, last);
+        if (n == 0) return;
+
+        auto prefix = common_prefix_width(radix_key(*first), radix_key(*(last - 1))); // compute common prefix length
+        if (prefix == (sizeof(radix_type) * 8)) return; // all x-values are equal
 
         // Determine radix width.
         std::size_t max = static_cast<std::size_t>(offset + n - 1) * compression_factor;
         bool is_mersenne = (max & (max + 1)) == 0; // check if max is 2^n-1
         auto radix = is_mersenne ? bit_width<std::size_t>(max) : bit_width<std::size_t>(max) - 1;
+        radix = std::min<std::size_t>(radix, sizeof(radix_type) * 8 - prefix); // narrow keys may have too few bits
+        if (radix == 0) return;
 
-        // Mask all bits but the radix
-        mask_ = (~(x_type)0 >> prefix) & (~(x_type)0 << ((sizeof(x_type) * 8) - radix - prefix)); //0xffff << prefix_
+        // Mask all bits but the radix.
+        shift_ = sizeof(radix_type) * 8 - radix - prefix;
+        mask_ = (~(radix_type)0 >> prefix) & (~(radix_type)0 << shift_);
     }
 
     /**
@@ -441,28 +1053,41 @@ class Radix
      * @param x to estimate a y-value for
      * @return the estimated y-value for @p x
      */
-    // double predict(const x_type x) const { return (x << prefix_) >> ((sizeof(x_type) * 8) - radix_); }
     double predict(const x_type x) const {
-        if constexpr(sizeof(x_type) <= sizeof(unsigned)) {
-            return _pext_u32(x, mask_);
-        } else if constexpr(sizeof(x_type) <= sizeof(unsigned long long)) {
-            return _pext_u64(x, mask_);
+        if constexpr (not Pext) {
+            return (radix_key(x) & mask_) >> shift_;
+        } else if constexpr (sizeof(radix_type) <= sizeof(unsigned)) {
+            return _pext_u32(radix_key(x), mask_);
+        } else if constexpr (sizeof(radix_type) <= sizeof(unsigned long long)) {
+            return _pext_u64(radix_key(x), mask_);
         } else {
-            static_assert(sizeof(x_type) > sizeof(unsigned long long), "unsupported width of integral type");
+            static_assert(sizeof(radix_type) > sizeof(unsigned long long), "unsupported width of integral type");
         }
     }
 
     /**
-     * Returns the mask used for parallel bits extraction.
+     * Returns the mask of the projected bits.
      * @return the mask
      */
-    uint8_t mask() const { return mask_; }
+    radix_type mask() const { return mask_; }
+
+    /**
+     * Returns the number of bits below the projected bits.
+     * @return the shift
+     */
+    uint8_t shift() const { return shift_; }
+
+    /**
+     * Returns the number of projected bits.
+     * @return the radix width
+     */
+    uint8_t radix() const { return bit_width<radix_type>(mask_) - (mask_ ? shift_ : 0); }
 
     /**
      * Returns the size of the radix model in bytes.
      * @return radix model size in bytes.
      */
-    std::size_t size_in_bytes() { return sizeof(mask_); }
+    std::size_t size_in_bytes() const { return sizeof(mask_) + sizeof(shift_); }
 
     /**
      * Writes a human readable representation of the radix model to an output stream.
@@ -471,8 +1096,380 @@ class Radix
      * @returns the output stream
      */
     friend std::ostream & operator<<(std::ostream &out, const Radix &m) {
-        return out << "_pext(x, " << m.mask() << ")";
+        auto flags = out.flags();
+        if constexpr (Pext) out << "_pext(x, 0x" << std::hex << m.mask() << ")";
+        else out << "(x & 0x" << std::hex << m.mask() << std::dec << ") >> " << unsigned(m.shift());
+        out.flags(flags);
+        return out;
+    }
+};
+
+
+/**
+ * A radix model that maps the most significant bits of x-values to a range of y-values via a lookup table, similar to
+ * the radix table of RadixSpline.
+ *
+ * Signed and floating-point x-values are mapped to unsigned integers of the same width by the order-preserving
+ * transformation radix_key() first. The smallest x-value is subtracted and the top @p Bits bits of the remaining
+ * difference select a bucket. The table stores the first y-value of each bucket, so that the y-values of a bucket are
+ * known exactly and the x-value is interpolated linearly within them based on the bits below the bucket bits. Unlike
+ * Radix, the predicted y-values thus follow the distribution of the x-values at the granularity of the buckets, at the
+ * cost of a table lookup. With the default of 2^12 buckets, the table takes 16 KiB.
+ *
+ * We assume that x-values are sorted in ascending order and y-values are handed implicitly where @p offset and @p
+ * offset + distance(first, last) are the first and last y-value, respectively. The y-values can be scaled by
+ * providing a @p compression_factor. The last y-value must fit into 32 bits.
+ *
+ * @tparam X the type of x-values
+ * @tparam Bits the number of most significant bits that select a bucket
+ */
+template<typename X = uint64_t, std::size_t Bits = 12>
+class RadixTable
+{
+    using x_type = X;
+    using radix_type = radix_key_t<X>;
+
+    static_assert(Bits > 0 and Bits < 32, "number of bits must be in [1, 31]");
+
+    private:
+    radix_type min_;               ///< The smallest x-value after radix_key().
+    radix_type max_;               ///< The largest x-value after radix_key().
+    radix_type mask_;              ///< The mask of the bits below the bucket bits.
+    uint8_t shift_;                ///< The number of bits below the bucket bits.
+    double scale_;                 ///< The factor mapping the bits below the bucket bits to [0, 1).
+    double compression_factor_;    ///< The factor by which y-values are scaled.
+    std::vector<uint32_t> table_;  ///< The first y-value of each bucket, followed by the y-value past the last one.
+
+    public:
+    /*
+     * Default constructor.
+     */
+    RadixTable() = default;
+
+    /**
+     * Builds a radix table on the given data points.
+     * @param first, last iterators to the first and last x-value the radix table is built on
+     * @param offset first y-value the radix table is built on
+     * @param compression_factor by which the y-values are scaled
+     */
+    template<typename RandomIt>
+    RadixTable(RandomIt first, RandomIt last, std::size_t offset = 0, double compression_factor = 1.f)
+        : compression_factor_(compression_factor)
+    {
+        std::size_t n = std::distance(first, last);
+
+        if (n == 0) {
+            min_ = max_ = mask_ = 0;
+            shift_ = 0;
+            scale_ = 0;
+            table_.assign(2, offset);
+            return;
+        }
+
+        // Determine the bucket bits within the range of x-values.
+        min_ = radix_key(*first);
+        max_ = radix_key(*(last - 1));
+        auto width = bit_width<radix_type>(max_ - min_);
+        auto radix = std::min<std::size_t>(Bits, width);
+        shift_ = width - radix;
+        mask_ = shift_ == 0 ? 0 : ~(radix_type)0 >> (sizeof(radix_type) * 8 - shift_);
+        scale_ = std::ldexp(1., -shift_);
+
+        // Store the first y-value of each bucket.
+        table_.resize((1UL << radix) + 1);
+        std::size_t bucket = 0;
+        for (std::size_t i = 0; i != n; ++i) {
+            std::size_t b = (radix_key(first[i]) - min_) >> shift_;
+            while (bucket <= b) table_[bucket++] = offset + i;
+        }
+        while (bucket != table_.size()) table_[bucket++] = offset + n;
+    }
+
+    /**
+     * Returns the estimated y-value of @p x.
+     * @param x to estimate a y-value for
+     * @return the estimated y-value for @p x
+     */
+    double predict(const x_type x) const {
+        radix_type key = std::clamp(radix_key(x), min_, max_) - min_;
+        std::size_t bucket = key >> shift_;
+        double lo = table_[bucket];
+        double hi = table_[bucket + 1];
+        return (lo + (key & mask_) * scale_ * (hi - lo)) * compression_factor_;
+    }
+
+    /**
+     * Returns the number of buckets.
+     * @return the number of buckets
+     */
+    std::size_t n_buckets() const { return table_.size() - 1; }
+
+    /**
+     * Returns the size of the radix table in bytes.
+     * @return radix table size in bytes.
+     */
+    std::size_t size_in_bytes() const {
+        return sizeof(min_) + sizeof(max_) + sizeof(mask_) + sizeof(shift_) + sizeof(scale_)
+            + sizeof(compression_factor_) + table_.size() * sizeof(uint32_t);
+    }
+
+    /**
+     * Writes a human readable representation of the radix table to an output stream.
+     * @param out output stream to write the radix table to
+     * @param m the radix table
+     * @returns the output stream
+     */
+    friend std::ostream & operator<<(std::ostream &out, const RadixTable &m) {
+        return out << "table[(x - " << m.min_ << ") >> " << unsigned(m.shift_) << "], " << m.n_buckets() << " buckets";
     }
 };
 
+
+/**
+ * A model that approximates the cumulative distribution function of x-values by a piecewise linear function with
+ * @p Knots pieces of equal frequency.
+ *
+ * The knots are placed at the x-values of every (n-1)/@p Knots-th data point, hence each piece covers the same number
+ * of y-values and the estimate is monotone and continuous by construction. A knot is found by a branchless binary
+ * search over the knots, which fit into a few cache lines for small @p Knots.
+ *
+ * We assume that x-values are sorted in ascending order and y-values are handed implicitly where @p offset and @p
+ * offset + distance(first, last) are the first and last y-value, respectively. The y-values can be scaled by
+ * providing a @p compression_factor.
+ *
+ * @tparam Knots the number of pieces, a power of two
+ */
+template<std::size_t Knots = 64>
+class PiecewiseCdf
+{
+    static_assert(Knots > 0 and (Knots & (Knots - 1)) == 0, "number of knots must be a power of two");
+
+    private:
+    double x_[Knots + 1];  ///< The x-values of the knots.
+    double slope_[Knots];  ///< The slope of each piece.
+    double ymin_;          ///< The first y-value.
+    double step_;          ///< The number of y-values covered by each piece.
+
+    public:
+    /**
+     * Default constructor.
+     */
+    PiecewiseCdf() = default;
+
+    /**
+     * Builds a piecewise linear cumulative distribution function on the given data points.
+     * @param first, last iterators to the first and last x-value the function is fit on
+     * @param offset first y-value the function is fit on
+     * @param compression_factor by which the y-values are scaled
+     */
+    template<typename RandomIt>
+    PiecewiseCdf(RandomIt first, RandomIt last, std::size_t offset = 0, double compression_factor = 1.f)
+        : ymin_(static_cast<double>(offset) * compression_factor)
+    {
+        std::size_t n = std::distance(first, last);
+        step_ = n == 0 ? 0. : static_cast<double>(n - 1) / Knots * compression_factor;
+
+        for (std::size_t k = 0; k <= Knots; ++k)
+            x_[k] = n == 0 ? 0. : static_cast<double>(*(first + k * (n - 1) / Knots));
+        for (std::size_t k = 0; k != Knots; ++k) {
+            double width = x_[k + 1] - x_[k];
+            slope_[k] = width > 0. ? step_ / width : 0.; // pieces of duplicate x-values are never selected but the last
+        }
+    }
+
+    /**
+     * Returns the estimated y-value of @p x.
+     * @param x to estimate a y-value for
+     * @return the estimated y-value for @p x
+     */
+    template<typename X>
+    double predict(const X x) const {
+        double x_d = std::clamp(static_cast<double>(x), x_[0], x_[Knots]);
+        std::size_t k = 0;
+        for (std::size_t half = Knots / 2; half != 0; half /= 2)
+            k += x_[k + half] <= x_d ? half : 0;
+        return std::fma(x_d - x_[k], slope_[k], ymin_ + k * step_);
+    }
+
+    /**
+     * Returns the size of the piecewise linear cumulative distribution function in bytes.
+     * @return model size in bytes.
+     */
+    std::size_t size_in_bytes() const { return sizeof(x_) + sizeof(slope_) + sizeof(ymin_) + sizeof(step_); }
+
+    /**
+     * Writes a human readable representation of the piecewise linear cumulative distribution function to an output
+     * stream.
+     * @param out output stream to write the function to
+     * @param m the function
+     * @returns the output stream
+     */
+    friend std::ostream & operator<<(std::ostream &out, const PiecewiseCdf &m) {
+        return out << "cdf(x) with " << Knots << " knots in [" << m.x_[0] << ", " << m.x_[Knots] << "]";
+    }
+};
+
+
+/**
+ * A model that approximates the cumulative distribution function of x-values by the one of a normal distribution or,
+ * if @p Log is set, of a lognormal distribution.
+ *
+ * Mean and standard deviation are estimated on an evenly spaced sample of the x-values or, for lognormal
+ * distributions, of log2(1 + x - x_min), which shifts the distribution to the x-values. The cumulative distribution
+ * function of the standard normal distribution is approximated in closed form by the logistic function 1 / (1 +
+ * exp(-(1.5976 z + 0.070566 z^3))) of Bowling et al., which is strictly increasing and deviates by less than 1.4e-4.
+ * Logarithm and exponential function are evaluated by polynomials on the mantissa that are continuous and increasing
+ * across exponents, which is several times faster than `std::log` and `std::exp`. The estimate is scaled such that
+ * the first and last x-value are mapped exactly to the first and last y-value, hence it is monotone by construction.
+ *
+ * We assume that x-values are sorted in ascending order and y-values are handed implicitly where @p offset and @p
+ * offset + distance(first, last) are the first and last y-value, respectively. The y-values can be scaled by
+ * providing a @p compression_factor.
+ *
+ * @tparam Log whether the distribution is lognormal rather than normal
+ */
+template<bool Log = false>
+class GaussianCdf
+{
+    private:
+    double xmin_;      ///< The first x-value, which x-values are clamped to.
+    double mu_;        ///< The mean of the (logarithmized) x-values.
+    double inv_sigma_; ///< The inverse standard deviation of the (logarithmized) x-values.
+    double cmin_;      ///< The approximate cumulative distribution function at the first x-value.
+    double scale_;     ///< The factor mapping the cumulative distribution function to y-values.
+    double ymin_;      ///< The first y-value.
+
+    static constexpr std::size_t sample_size = 1UL << 16; ///< The maximum number of x-values parameters are fit on.
+
+    public:
+    /**
+     * Default constructor.
+     */
+    GaussianCdf() = default;
+
+    /**
+     * Builds a normal or lognormal cumulative distribution function on the given data points.
+     * @param first, last iterators to the first and last x-value the function is fit on
+     * @param offset first y-value the function is fit on
+     * @param compression_factor by which the y-values are scaled
+     */
+    template<typename RandomIt>
+    GaussianCdf(RandomIt first, RandomIt last, std::size_t offset = 0, double compression_factor = 1.f)
+        : xmin_(0.f)
+        , mu_(0.f)
+        , inv_sigma_(0.f)
+        , cmin_(0.f)
+        , scale_(0.f)
+        , ymin_(static_cast<double>(offset) * compression_factor)
+    {
+        std::size_t n = std::distance(first, last);
+        if (n < 2) return;
+        xmin_ = static_cast<double>(*first);
+
+        // Estimate mean and standard deviation on a sample.
+        std::size_t n_samples = std::min(n, sample_size);
+        auto sample = [&](std::size_t s) { return transform(static_cast<double>(*(first + s * (n - 1) / (n_samples - 1)))); };
+        double sum = 0.;
+        for (std::size_t s = 0; s != n_samples; ++s) sum += sample(s);
+        mu_ = sum / n_samples;
+        double m2 = 0.;
+        for (std::size_t s = 0; s != n_samples; ++s) m2 += (sample(s) - mu_) * (sample(s) - mu_);
+        if (m2 == 0.) return;
+        inv_sigma_ = 1. / std::sqrt(m2 / n_samples);
+
+        // Map the first and last x-value to the first and last y-value.
+        cmin_ = cdf(xmin_);
+        double cmax = cdf(static_cast<double>(*(last - 1)));
+        if (cmax > cmin_) scale_ = static_cast<double>(n - 1) * compression_factor / (cmax - cmin_);
+    }
+
+    /**
+     * Returns the estimated y-value of @p x.
+     * @param x to estimate a y-value for
+     * @return the estimated y-value for @p x
+     */
+    template<typename X>
+    double predict(const X x) const { return std::fma(cdf(static_cast<double>(x)) - cmin_, scale_, ymin_); }
+
+    /**
+     * Returns the mean of the (logarithmized) x-values.
+     * @return the mean
+     */
+    double mu() const { return mu_; }
+
+    /**
+     * Returns the standard deviation of the (logarithmized) x-values.
+     * @return the standard deviation
+     */
+    double sigma() const { return inv_sigma_ == 0. ? 0. : 1. / inv_sigma_; }
+
+    /**
+     * Returns the size of the cumulative distribution function in bytes.
+     * @return model size in bytes.
+     */
+    std::size_t size_in_bytes() const { return 6 * sizeof(double); }
+
+    /**
+     * Writes a human readable representation of the cumulative distribution function to an output stream.
+     * @param out output stream to write the function to
+     * @param m the function
+     * @returns the output stream
+     */
+    friend std::ostream & operator<<(std::ostream &out, const GaussianCdf &m) {
+        return out << (Log ? "lognormal(" : "normal(") << m.mu() << ", " << m.sigma() << ")";
+    }
+
+    private:
+    /**
+     * Maps @p x to the domain of the normal distribution, i.e. returns log2(1 + x - x_min) for lognormal distributions
+     * and @p x otherwise.
+     */
+    double transform(const double x) const {
+        if constexpr (Log) return log2(std::max(x - xmin_, 0.) + 1.);
+        else return x;
+    }
+
+    /**
+     * Returns the approximate cumulative distribution function at @p x.
+     */
+    double cdf(const double x) const {
+        constexpr double log2e = 1.4426950408889634;
+        double z = (transform(x) - mu_) * inv_sigma_;
+        return 1. / (1. + exp2(-z * std::fma(0.070566 * log2e * z, z, 1.5976 * log2e)));
+    }
+
+    /**
+     * Approximates the binary logarithm of @p v >= 1 with an absolute error below 2.2e-5.
+     */
+    static double log2(const double v) {
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(v));
+        double exponent = static_cast<double>(static_cast<int64_t>(bits >> 52) - 1023);
+        bits = (bits & ((1UL << 52) - 1)) | (1023UL << 52); // mantissa in [1, 2)
+        double f;
+        std::memcpy(&f, &bits, sizeof(f));
+        f -= 1.;
+        double p = std::fma(std::fma(std::fma(-0.044004689744956887, f, 0.14631433847444766), f, -0.2660298770632562),
+                            f, 0.4417403028781603);
+        return exponent + std::fma(f * (1. - f), p, f);
+    }
+
+    /**
+     * Approximates two to the power of @p t with a relative error below 5.1e-6.
+     */
+    static double exp2(const double t) {
+        double t_c = std::clamp(t, -1022., 1023.);
+        double i = std::floor(t_c);
+        double f = t_c - i;
+        double p = std::fma(std::fma(-0.013686471227456604, f, -0.065438747318828233), f, -0.30700434489950729);
+        uint64_t bits = static_cast<uint64_t>(static_cast<int64_t>(i) + 1023) << 52;
+        double scale;
+        std::memcpy(&scale, &bits, sizeof(scale));
+        return std::fma(f * (1. - f), p, 1. + f) * scale;
+    }
+};
+
+using NormalCdf = GaussianCdf<false>;   ///< A normal cumulative distribution function.
+using LogNormalCdf = GaussianCdf<true>; ///< A lognormal cumulative distribution function.
+
 } // namespace rmi
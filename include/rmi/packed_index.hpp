@@ -0,0 +1,106 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "rmi/rmi.hpp"
+#include "rmi/util/packed_keys.hpp"
+
+
+namespace rmi {
+
+/**
+ * Binds a recursive model index to a compressed copy of the sorted keys it was built on, see PackedKeys, and answers
+ * lower bound queries with positions. Unlike Index, the keys need not be kept once the index is built.
+ *
+ * The interval returned by the RMI is searched on the compressed keys, which decodes only the block containing the
+ * lower bound. Keys that are not part of the data may lie outside of the error bounds of an RMI. In that case, the
+ * remaining keys on the respective side are searched.
+ *
+ * @tparam Key the type of the keys to be indexed, must be unsigned
+ * @tparam Rmi the type of the recursive model index, e.g. `RmiLAbs<Key, LinearSpline, LinearRegression>`
+ */
+template<typename Key, typename Rmi>
+class PackedIndex
+{
+    public:
+    using key_type = Key;
+    using rmi_type = Rmi;
+
+    private:
+    using keys_type = PackedKeys<key_type, typename rmi_type::allocator_type>;
+
+    rmi_type rmi_;   ///< The recursive model index.
+    keys_type keys_; ///< The compressed keys.
+
+    public:
+    /**
+     * Builds the index with @p layer2_size models in layer2 on the sorted @p keys.
+     * @tparam KeyAllocator the allocator of the vector holding the keys
+     * @param keys vector of sorted keys to be indexed
+     * @param layer2_size the number of models in layer2
+     * @param compress whether runs of empty segments share a single model
+     * @param alloc allocator of the recursive model index and the compressed keys
+     */
+    template<typename KeyAllocator>
+    PackedIndex(const std::vector<key_type, KeyAllocator> &keys, const std::size_t layer2_size,
+                const bool compress = false,
+                const typename rmi_type::allocator_type &alloc = typename rmi_type::allocator_type())
+        : rmi_(keys, layer2_size, compress, alloc)
+        , keys_(keys.data(), keys.size(), alloc) { }
+
+    PackedIndex(const PackedIndex&) = delete;
+    PackedIndex &operator=(const PackedIndex&) = delete;
+
+    /**
+     * Returns the position of the first key that is not less than @p key.
+     * @param key to search for
+     * @return position of the first key that is not less than @p key, or size() if there is no such key
+     */
+    std::size_t lower_bound(const key_type key) const {
+        if (keys_.size() == 0) return 0;
+
+        auto approx = rmi_.search(key);
+        auto pos = keys_.lower_bound(approx.lo, approx.hi, key);
+
+        // The lower bound lies outside of the search bounds if the key is not part of the data.
+        if (pos == approx.hi and pos != keys_.size() and keys_[pos] < key)
+            pos = keys_.lower_bound(pos, keys_.size(), key);
+        else if (pos == approx.lo and pos != 0 and not (keys_[pos - 1] < key))
+            pos = keys_.lower_bound(0, pos, key);
+        return pos;
+    }
+
+    /**
+     * Returns the key at position @p i.
+     * @param i the position
+     * @return the key at position @p i
+     */
+    key_type operator[](const std::size_t i) const { return keys_[i]; }
+
+    /**
+     * Returns the number of keys.
+     * @return number of keys
+     */
+    std::size_t size() const { return keys_.size(); }
+
+    /**
+     * Returns the underlying recursive model index.
+     * @return the recursive model index
+     */
+    const rmi_type &rmi() const { return rmi_; }
+
+    /**
+     * Returns the compressed keys.
+     * @return the compressed keys
+     */
+    const keys_type &keys() const { return keys_; }
+
+    /**
+     * Returns the size of the index in bytes, excluding the compressed keys.
+     * @return index size in bytes
+     */
+    std::size_t size_in_bytes() const { return rmi_.size_in_bytes(); }
+};
+
+} // namespace rmi
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <sched.h>
+
+#include "rmi/index.hpp"
+#include "rmi/util/allocator.hpp"
+#include "rmi/util/fn.hpp"
+#include "rmi/util/numa.hpp"
+#include "rmi/util/search.hpp"
+
+
+namespace rmi {
+
+/**
+ * Keeps one replica of a recursive model index per NUMA node and routes each lookup to the replica of the node the
+ * calling thread runs on, so that accesses to layer2 models, error bounds, and optionally keys stay node-local.
+ *
+ * Replicas are built in parallel, one thread per node pinned to the CPUs of that node. Their memory is bound to the
+ * node via HugePageAllocator, hence @p Rmi must use `HugePageAllocator` as allocator. Keys are either replicated as
+ * well or kept once and interleaved across all nodes. Node ids must be smaller than 64.
+ *
+ * @tparam Key the type of the keys to be indexed
+ * @tparam Rmi the type of the recursive model index, e.g. `RmiLAbs<Key, LinearSpline, LinearRegression,
+ * HugePageAllocator<Key>>`
+ * @tparam Search the functor used for searching the interval returned by @p Rmi
+ */
+template<typename Key, typename Rmi, typename Search = BinarySearch>
+class ReplicatedIndex
+{
+    public:
+    using key_type = Key;
+    using rmi_type = Rmi;
+    using key_allocator_type = HugePageAllocator<key_type>;
+    using index_type = Index<key_type, rmi_type, Search, key_allocator_type>;
+
+    private:
+    std::vector<NumaNode> nodes_;                                     ///< The NUMA nodes holding a replica.
+    std::vector<std::vector<key_type, key_allocator_type>> keys_;     ///< The keys, one copy per node or a single one.
+    std::vector<std::unique_ptr<index_type>> replicas_;               ///< The replicas, one per node.
+    std::vector<std::size_t> cpu_to_replica_;                         ///< The replica local to each CPU.
+
+    public:
+    /**
+     * Builds one replica with @p layer2_size models in layer2 on the sorted @p keys per NUMA node.
+     * @param keys vector of sorted keys to be indexed
+     * @param layer2_size the number of models in layer2
+     * @param replicate_keys whether keys are replicated per node or interleaved across nodes
+     * @param page_size the page size backing replicas and keys
+     */
+    ReplicatedIndex(const std::vector<key_type> &keys,
+                    const std::size_t layer2_size,
+                    const bool replicate_keys = true,
+                    const PageSize page_size = PageSize::regular)
+        : nodes_(numa_nodes())
+        , replicas_(nodes_.size())
+    {
+        // Place a single copy of the keys on all nodes round-robin.
+        if (not replicate_keys) {
+            uint64_t all_nodes = 0;
+            for (auto &node : nodes_) all_nodes |= 1UL << node.id;
+            keys_.emplace_back(keys.begin(), keys.end(), key_allocator_type(page_size, NumaPolicy::interleave, all_nodes));
+        } else {
+            keys_.resize(nodes_.size(), std::vector<key_type, key_allocator_type>(key_allocator_type(page_size)));
+        }
+
+        // Build replicas in parallel, each on a thread running on its node.
+        parallel_for(nodes_.size(), nodes_.size(), [&](std::size_t, std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i != end; ++i) {
+                pin_thread(nodes_[i].cpus);
+                key_allocator_type alloc(page_size, NumaPolicy::bind, 1UL << nodes_[i].id);
+                if (replicate_keys) keys_[i] = std::vector<key_type, key_allocator_type>(keys.begin(), keys.end(), alloc);
+                replicas_[i] = std::make_unique<index_type>(keys_[replicate_keys ? i : 0], layer2_size, false, alloc);
+            }
+        });
+
+        // Map CPUs to their local replica.
+        for (std::size_t i = 0; i != nodes_.size(); ++i) {
+            for (int cpu : nodes_[i].cpus) {
+                if (static_cast<std::size_t>(cpu) >= cpu_to_replica_.size()) cpu_to_replica_.resize(cpu + 1, 0);
+                cpu_to_replica_[cpu] = i;
+            }
+        }
+    }
+
+    ReplicatedIndex(const ReplicatedIndex&) = delete;
+    ReplicatedIndex &operator=(const ReplicatedIndex&) = delete;
+
+    /**
+     * Returns the replica local to the CPU the calling thread currently runs on. Threads should be pinned to the CPUs
+     * of a node, otherwise they may migrate after the replica was chosen.
+     * @return the local replica
+     */
+    const index_type &local() const {
+        int cpu = sched_getcpu();
+        std::size_t i = cpu >= 0 and static_cast<std::size_t>(cpu) < cpu_to_replica_.size() ? cpu_to_replica_[cpu] : 0;
+        return *replicas_[i];
+    }
+
+    /**
+     * Returns the replica on the @p i-th NUMA node.
+     * @param i index of the node in nodes()
+     * @return the replica
+     */
+    const index_type &replica(const std::size_t i) const { return *replicas_[i]; }
+
+    /**
+     * Returns the position of the first key that is not less than @p key using the local replica.
+     * @param key to search for
+     * @return position of the first key that is not less than @p key, or size() if there is no such key
+     */
+    std::size_t lower_bound(const key_type key) const {
+        auto &index = local();
+        return std::distance(index.begin(), index.lower_bound(key));
+    }
+
+    /**
+     * Returns the NUMA nodes holding a replica.
+     * @return vector of NUMA nodes
+     */
+    const std::vector<NumaNode> &nodes() const { return nodes_; }
+
+    /**
+     * Returns the number of replicas.
+     * @return number of replicas
+     */
+    std::size_t n_replicas() const { return replicas_.size(); }
+
+    /**
+     * Returns the number of keys.
+     * @return number of keys
+     */
+    std::size_t size() const { return replicas_.front()->size(); }
+
+    /**
+     * Returns the size of all replicas in bytes, excluding the keys.
+     * @return size of all replicas in bytes
+     */
+    std::size_t size_in_bytes() const { return replicas_.size() * replicas_.front()->size_in_bytes(); }
+};
+
+} // namespace rmi
@@ -1,8 +1,12 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
+#include "rmi/storage.hpp"
+
 
 namespace rmi {
 
@@ -24,19 +28,32 @@ struct Approx {
  * @tparam Key the type of the keys to be indexed
  * @tparam Layer1 the type of the model used in layer1
  * @tparam Layer2 the type of the models used in layer2
+ * @tparam Allocator the allocator used for layer2 and error bounds, rebound to their types, e.g. HugePageAllocator
+ * @tparam Storage the layout of layer2, either AosStorage (array of models) or SoaStorage (array per parameter)
  */
-template<typename Key, typename Layer1, typename Layer2>
+template<typename Key, typename Layer1, typename Layer2, typename Allocator = std::allocator<Layer2>,
+         template<typename, typename> class Storage = AosStorage>
 class Rmi
 {
     using key_type = Key;
     using layer1_type = Layer1;
     using layer2_type = Layer2;
+    using storage_type = Storage<Layer2, Allocator>;
+
+    public:
+    using allocator_type = Allocator;
 
     protected:
-    std::size_t n_keys_;      ///< The number of keys the index was built on.
-    std::size_t layer2_size_; ///< The number of models in layer2.
-    layer1_type l1_;          ///< The layer1 model.
-    layer2_type *l2_;         ///< The array of layer2 models.
+    template<typename T>
+    using rebind_alloc = typename std::allocator_traits<allocator_type>::template rebind_alloc<T>;
+
+    std::size_t n_keys_ = 0;                 ///< The number of keys the index was built on.
+    std::size_t layer2_size_ = 0;            ///< The number of segments in layer2.
+    std::size_t n_models_ = 0;               ///< The number of distinct models in layer2.
+    layer1_type l1_;                         ///< The layer1 model.
+    storage_type l2_;                        ///< The layer2 models.
+    rebind_alloc<layer2_type> l2_allocator_; ///< The allocator of the layer2 models.
+    std::vector<uint32_t, rebind_alloc<uint32_t>> redirect_; ///< The model of each segment, empty if not compressed.
 
     public:
     /**
@@ -48,53 +65,63 @@ class Rmi
      * Builds the index with @p layer2_size models in layer2 on the sorted @p keys.
      * @param keys vector of sorted keys to be indexed
      * @param layer2_size the number of models in layer2
+     * @param compress whether runs of empty segments share a single model
+     * @param alloc allocator for layer2 and error bounds
      */
-    Rmi(const std::vector<key_type> &keys, const std::size_t layer2_size)
-        : Rmi(keys.begin(), keys.end(), layer2_size) { }
+    template<typename KeyAllocator>
+    Rmi(const std::vector<key_type, KeyAllocator> &keys, const std::size_t layer2_size, const bool compress = false,
+        const allocator_type &alloc = allocator_type())
+        : Rmi(keys.begin(), keys.end(), layer2_size, compress, alloc) { }
 
     /**
      * Builds the index with @p layer2_size models in layer2 on the sorted keys in the range [first, last).
+     *
+     * Segments that receive no keys are trained on the last key of the preceding segment, or on the first key if no
+     * segment precedes them. A run of empty segments is trained once and the model is copied to all of its segments.
+     * If @p compress is set, the segments of a run instead share the model via a redirect table that maps each segment
+     * to its model. This trades an additional lookup per search for fewer models on skewed data.
      * @param first, last iterators that define the range of sorted keys to be indexed
      * @param layer2_size the number of models in layer2
+     * @param compress whether runs of empty segments share a single model
+     * @param alloc allocator for layer2 and error bounds
      */
     template<typename RandomIt>
-    Rmi(RandomIt first, RandomIt last, const std::size_t layer2_size)
+    Rmi(RandomIt first, RandomIt last, const std::size_t layer2_size, const bool compress = false,
+        const allocator_type &alloc = allocator_type())
         : n_keys_(std::distance(first, last))
         , layer2_size_(layer2_size)
+        , l2_(alloc)
+        , l2_allocator_(alloc)
+        , redirect_(alloc)
     {
         // Train layer1.
         l1_ = layer1_type(first, last, 0, static_cast<double>(layer2_size) / n_keys_); // train with compression
 
         // Train layer2.
-        l2_ = new layer2_type[layer2_size];
-        std::size_t segment_start = 0;
-        std::size_t segment_id = 0;
-        // Assign each key to its segment.
-        for (std::size_t i = 0; i != n_keys_; ++i) {
-            auto pos = first + i;
-            std::size_t pred_segment_id = get_segment_id(*pos);
-            // If a key is assigned to a new segment, all models must be trained up to the new segment.
-            if (pred_segment_id > segment_id) {
-                new (&l2_[segment_id]) layer2_type(first + segment_start, pos, segment_start);
-                for (std::size_t j = segment_id + 1; j < pred_segment_id; ++j) {
-                    new (&l2_[j]) layer2_type(pos - 1, pos, i - 1); // train other models on last key in previous segment
-                }
-                segment_id = pred_segment_id;
-                segment_start = i;
+        if (not compress) {
+            n_models_ = layer2_size;
+            l2_.allocate(n_models_);
+            for_each_run(first, last, [&](std::size_t lo, std::size_t hi, RandomIt begin, RandomIt end) {
+                l2_.fill(lo, hi, layer2_type(begin, end, std::distance(first, begin)));
+            });
+        } else {
+            std::vector<layer2_type> models;
+            models.reserve(std::min(layer2_size, 2 * n_keys_ + 1)); // non-empty segments and empty runs alternate
+            redirect_.resize(layer2_size);
+            for_each_run(first, last, [&](std::size_t lo, std::size_t hi, RandomIt begin, RandomIt end) {
+                std::fill(redirect_.begin() + lo, redirect_.begin() + hi, models.size());
+                models.emplace_back(begin, end, std::distance(first, begin));
+            });
+            n_models_ = models.size();
+            l2_.allocate(n_models_);
+            for (std::size_t i = 0; i != n_models_; ++i) l2_.fill(i, i + 1, models[i]);
+            if (n_models_ == layer2_size) { // no empty runs, redirect table would be the identity
+                redirect_.clear();
+                redirect_.shrink_to_fit();
             }
         }
-        // Train remaining models.
-        new (&l2_[segment_id]) layer2_type(first + segment_start, last, segment_start);
-        for (std::size_t j = segment_id + 1; j < layer2_size; ++j) {
-            new (&l2_[j]) layer2_type(last - 1, last, n_keys_ - 1); // train remaining models on last key
-        }
     }
 
-    /**
-     * Destructor.
-     */
-    ~Rmi() { delete[] l2_; }
-
     /**
      * Returns the id of the segment @p key belongs to.
      * @param key to get segment id for
@@ -104,17 +131,41 @@ class Rmi
         return std::clamp<double>(l1_.predict(key), 0, layer2_size_ - 1);
     }
 
+    /**
+     * Returns the id of the layer2 model responsible for @p key. Equals the segment id unless the index is compressed.
+     * @param key to get model id for
+     * @return model id of the given key
+     */
+    std::size_t get_model_id(const key_type key) const {
+        std::size_t segment_id = get_segment_id(key);
+        return redirect_.empty() ? segment_id : redirect_[segment_id];
+    }
+
     /**
      * Returns a position estimate and search bounds for a given key.
      * @param key to search for
      * @return position estimate and search bounds
      */
     Approx search(const key_type key) const {
-        auto segment_id = get_segment_id(key);
-        std::size_t pred = std::clamp<double>(l2_[segment_id].predict(key), 0, n_keys_ - 1);
+        auto model_id = get_model_id(key);
+        std::size_t pred = std::clamp<double>(l2_.predict(model_id, key), 0, n_keys_ - 1);
         return {pred, 0, n_keys_};
     }
 
+    /**
+     * Returns position estimates and search bounds for the keys in the range [first, last) and writes them to the range
+     * beginning at @p d_first.
+     * @param first, last iterators that define the range of keys to search for
+     * @param d_first the beginning of the destination range
+     * @return output iterator to the element past the last element written
+     */
+    template<typename RandomIt, typename OutputIt>
+    OutputIt search(RandomIt first, RandomIt last, OutputIt d_first) const {
+        return search(first, last, d_first, [this](const std::size_t, const std::size_t pred) -> Approx {
+            return {pred, 0, n_keys_};
+        });
+    }
+
     /**
      * Returns the number of keys the index was built on.
      * @return the number of keys the index was built on
@@ -127,12 +178,100 @@ class Rmi
      */
     std::size_t layer2_size() const { return layer2_size_; }
 
+    /**
+     * Returns the number of distinct models in layer2, which is less than layer2_size() if the index is compressed.
+     * @return the number of distinct models in layer2
+     */
+    std::size_t n_models() const { return n_models_; }
+
+    /**
+     * Returns the layer1 model.
+     * @return the layer1 model
+     */
+    const layer1_type &layer1() const { return l1_; }
+
+    /**
+     * Returns the layer2 model with id @p model_id. Only available for AosStorage of models other than PiecewiseLinear.
+     * @param model_id id of the model, less than n_models()
+     * @return the layer2 model
+     */
+    const layer2_type &layer2(const std::size_t model_id) const { return l2_[model_id]; }
+
+    /**
+     * Returns the model of each segment, which is empty unless the index is compressed.
+     * @return the redirect table
+     */
+    const std::vector<uint32_t, rebind_alloc<uint32_t>> &redirect() const { return redirect_; }
+
     /**
      * Returns the size of the index in bytes.
      * @return index size in bytes
      */
-    std::size_t size_in_bytes() {
-        return l1_.size_in_bytes() + layer2_size_ * l2_[0].size_in_bytes() + sizeof(n_keys_) + sizeof(layer2_size_);
+    std::size_t size_in_bytes() const {
+        return l1_.size_in_bytes() + l2_.size_in_bytes() + redirect_.size() * sizeof(uint32_t) + sizeof(n_keys_)
+            + sizeof(layer2_size_);
+    }
+
+    protected:
+    /**
+     * Computes position estimates for the keys in the range [first, last), turns them into search bounds using @p
+     * bound, and writes them to the range beginning at @p d_first.
+     *
+     * Keys are processed in blocks. Layer1 is evaluated for the whole block first, which lets the compiler vectorize
+     * the root model, before layer2 is evaluated. The layer2 accesses of a block are independent of each other so that
+     * their cache misses overlap, and layer2 is evaluated separately from the bounds so that the compiler can gather
+     * the parameters of several models at once if they are stored as struct of arrays.
+     * @param first, last iterators that define the range of keys to search for
+     * @param d_first the beginning of the destination range
+     * @param bound function that computes search bounds from a model id and a position estimate
+     * @return output iterator to the element past the last element written
+     */
+    template<typename RandomIt, typename OutputIt, typename BoundFn>
+    OutputIt search(RandomIt first, RandomIt last, OutputIt d_first, BoundFn bound) const {
+        constexpr std::size_t block_size = 64;
+        std::size_t model_ids[block_size];
+        std::size_t preds[block_size];
+        while (first != last) {
+            std::size_t n = std::min<std::size_t>(block_size, std::distance(first, last));
+            for (std::size_t i = 0; i != n; ++i)
+                model_ids[i] = get_model_id(*(first + i));
+            for (std::size_t i = 0; i != n; ++i)
+                preds[i] = std::clamp<double>(l2_.predict(model_ids[i], *(first + i)), 0, n_keys_ - 1);
+            for (std::size_t i = 0; i != n; ++i)
+                *d_first++ = bound(model_ids[i], preds[i]);
+            first += n;
+        }
+        return d_first;
+    }
+
+    private:
+    /**
+     * Assigns the sorted keys in the range [first, last) to segments and calls @p train for each single segment holding
+     * keys and for each maximal run of empty segments in ascending order. @p train receives the segments [lo, hi) and
+     * the keys [begin, end) to train their model on, i.e. the keys of a non-empty segment or the single key preceding a
+     * run of empty segments.
+     * @param first, last iterators that define the range of sorted keys
+     * @param train function called with the segments [lo, hi) and the training keys [begin, end)
+     */
+    template<typename RandomIt, typename TrainFn>
+    void for_each_run(RandomIt first, RandomIt last, TrainFn train) const {
+        std::size_t segment_start = 0;
+        std::size_t segment_id = get_segment_id(*first);
+        if (segment_id > 0) train(0, segment_id, first, first + 1); // train leading empty segments on first key
+        for (std::size_t i = 1; i != n_keys_; ++i) {
+            std::size_t pred_segment_id = get_segment_id(*(first + i));
+            // If a key is assigned to a new segment, all segments up to the new one are complete.
+            if (pred_segment_id > segment_id) {
+                train(segment_id, segment_id + 1, first + segment_start, first + i);
+                if (pred_segment_id > segment_id + 1) // train empty segments on last key in previous segment
+                    train(segment_id + 1, pred_segment_id, first + i - 1, first + i);
+                segment_id = pred_segment_id;
+                segment_start = i;
+            }
+        }
+        // Train remaining segments.
+        train(segment_id, segment_id + 1, first + segment_start, last);
+        if (layer2_size_ > segment_id + 1) train(segment_id + 1, layer2_size_, last - 1, last); // train on last key
     }
 };
 
@@ -140,10 +279,11 @@ class Rmi
 /**
  * Recursive model index with global absolute bounds.
  */
-template<typename Key, typename Layer1, typename Layer2>
-class RmiGAbs : public Rmi<Key, Layer1, Layer2>
+template<typename Key, typename Layer1, typename Layer2, typename Allocator = std::allocator<Layer2>,
+         template<typename, typename> class Storage = AosStorage>
+class RmiGAbs : public Rmi<Key, Layer1, Layer2, Allocator, Storage>
 {
-    using base_type = Rmi<Key, Layer1, Layer2>;
+    using base_type = Rmi<Key, Layer1, Layer2, Allocator, Storage>;
     using key_type = Key;
     using layer1_type = Layer1;
     using layer2_type = Layer2;
@@ -161,23 +301,31 @@ class RmiGAbs : public Rmi<Key, Layer1, Layer2>
      * Builds the index with @p layer2_size models in layer2 on the sorted @p keys.
      * @param keys vector of sorted keys to be indexed
      * @param layer2_size the number of models in layer2
+     * @param compress whether runs of empty segments share a single model
+     * @param alloc allocator for layer2 and error bounds
      */
-    RmiGAbs(const std::vector<key_type> &keys, const std::size_t layer2_size)
-        : RmiGAbs(keys.begin(), keys.end(), layer2_size) { }
+    template<typename KeyAllocator>
+    RmiGAbs(const std::vector<key_type, KeyAllocator> &keys, const std::size_t layer2_size, const bool compress = false,
+            const Allocator &alloc = Allocator())
+        : RmiGAbs(keys.begin(), keys.end(), layer2_size, compress, alloc) { }
 
     /**
      * Builds the index with @p layer2_size models in layer2 on the sorted keys in the range [first, last).
      * @param first, last iterators that define the range of sorted keys to be indexed
      * @param layer2_size the number of models in layer2
+     * @param compress whether runs of empty segments share a single model
+     * @param alloc allocator for layer2 and error bounds
      */
     template<typename RandomIt>
-    RmiGAbs(RandomIt first, RandomIt last, const std::size_t layer2_size) : base_type(first, last, layer2_size) {
+    RmiGAbs(RandomIt first, RandomIt last, const std::size_t layer2_size, const bool compress = false,
+            const Allocator &alloc = Allocator())
+        : base_type(first, last, layer2_size, compress, alloc) {
         // Compute global absolute errror bounds.
         error_ = 0;
         for (std::size_t i = 0; i != base_type::n_keys_; ++i) {
             key_type key = *(first + i);
-            std::size_t segment_id = base_type::get_segment_id(key);
-            std::size_t pred = std::clamp<double>(base_type::l2_[segment_id].predict(key), 0, base_type::n_keys_ - 1);
+            std::size_t model_id = base_type::get_model_id(key);
+            std::size_t pred = std::clamp<double>(base_type::l2_.predict(model_id, key), 0, base_type::n_keys_ - 1);
             if (pred > i) { // overestimation
                 error_ = std::max(error_, pred - i);
             } else { // underestimation
@@ -192,28 +340,53 @@ class RmiGAbs : public Rmi<Key, Layer1, Layer2>
      * @return position estimate and search bounds
      */
     Approx search(const key_type key) const {
-        auto segment_id = base_type::get_segment_id(key);
-        std::size_t pred = std::clamp<double>(base_type::l2_[segment_id].predict(key), 0, base_type::n_keys_ - 1);
-        std::size_t lo = pred > error_ ? pred - error_ : 0;
-        std::size_t hi = std::min(pred + error_ + 1, base_type::n_keys_);
-        return {pred, lo, hi};
+        auto model_id = base_type::get_model_id(key);
+        std::size_t pred = std::clamp<double>(base_type::l2_.predict(model_id, key), 0, base_type::n_keys_ - 1);
+        return bound(model_id, pred);
+    }
+
+    /**
+     * Returns position estimates and search bounds for the keys in the range [first, last) and writes them to the range
+     * beginning at @p d_first.
+     * @param first, last iterators that define the range of keys to search for
+     * @param d_first the beginning of the destination range
+     * @return output iterator to the element past the last element written
+     */
+    template<typename RandomIt, typename OutputIt>
+    OutputIt search(RandomIt first, RandomIt last, OutputIt d_first) const {
+        return base_type::search(first, last, d_first, [this](const std::size_t model_id, const std::size_t pred) {
+            return bound(model_id, pred);
+        });
     }
 
     /**
      * Returns the size of the index in bytes.
      * @return index size in bytes
      */
-    std::size_t size_in_bytes() { return base_type::size_in_bytes() + sizeof(error_); }
+    std::size_t size_in_bytes() const { return base_type::size_in_bytes() + sizeof(error_); }
+
+    private:
+    /**
+     * Returns the search bounds around position estimate @p pred.
+     * @param pred position estimate
+     * @return position estimate and search bounds
+     */
+    Approx bound(const std::size_t /* model_id */, const std::size_t pred) const {
+        std::size_t lo = pred > error_ ? pred - error_ : 0;
+        std::size_t hi = std::min(pred + error_ + 1, base_type::n_keys_);
+        return {pred, lo, hi};
+    }
 };
 
 
 /**
  * Recursive model index with global individual bounds.
  */
-template<typename Key, typename Layer1, typename Layer2>
-class RmiGInd : public Rmi<Key, Layer1, Layer2>
+template<typename Key, typename Layer1, typename Layer2, typename Allocator = std::allocator<Layer2>,
+         template<typename, typename> class Storage = AosStorage>
+class RmiGInd : public Rmi<Key, Layer1, Layer2, Allocator, Storage>
 {
-    using base_type = Rmi<Key, Layer1, Layer2>;
+    using base_type = Rmi<Key, Layer1, Layer2, Allocator, Storage>;
     using key_type = Key;
     using layer1_type = Layer1;
     using layer2_type = Layer2;
@@ -232,24 +405,32 @@ class RmiGInd : public Rmi<Key, Layer1, Layer2>
      * Builds the index with @p layer2_size models in layer2 on the sorted @p keys.
      * @param keys vector of sorted keys to be indexed
      * @param layer2_size the number of models in layer2
+     * @param compress whether runs of empty segments share a single model
+     * @param alloc allocator for layer2 and error bounds
      */
-    RmiGInd(const std::vector<key_type> &keys, const std::size_t layer2_size)
-        : RmiGInd(keys.begin(), keys.end(), layer2_size) { }
+    template<typename KeyAllocator>
+    RmiGInd(const std::vector<key_type, KeyAllocator> &keys, const std::size_t layer2_size, const bool compress = false,
+            const Allocator &alloc = Allocator())
+        : RmiGInd(keys.begin(), keys.end(), layer2_size, compress, alloc) { }
 
     /**
      * Builds the index with @p layer2_size models in layer2 on the sorted keys in the range [first, last).
      * @param first, last iterators that define the range of sorted keys to be indexed
      * @param layer2_size the number of models in layer2
+     * @param compress whether runs of empty segments share a single model
+     * @param alloc allocator for layer2 and error bounds
      */
     template<typename RandomIt>
-    RmiGInd(RandomIt first, RandomIt last, const std::size_t layer2_size) : base_type(first, last, layer2_size) {
+    RmiGInd(RandomIt first, RandomIt last, const std::size_t layer2_size, const bool compress = false,
+            const Allocator &alloc = Allocator())
+        : base_type(first, last, layer2_size, compress, alloc) {
         // Compute global absolute errror bounds.
         error_lo_ = 0;
         error_hi_ = 0;
         for (std::size_t i = 0; i != base_type::n_keys_; ++i) {
             key_type key = *(first + i);
-            std::size_t segment_id = base_type::get_segment_id(key);
-            std::size_t pred = std::clamp<double>(base_type::l2_[segment_id].predict(key), 0, base_type::n_keys_ - 1);
+            std::size_t model_id = base_type::get_model_id(key);
+            std::size_t pred = std::clamp<double>(base_type::l2_.predict(model_id, key), 0, base_type::n_keys_ - 1);
             if (pred > i) { // overestimation
                 error_lo_ = std::max(error_lo_, pred - i);
             } else { // underestimation
@@ -264,34 +445,61 @@ class RmiGInd : public Rmi<Key, Layer1, Layer2>
      * @return position estimate and search bounds
      */
     Approx search(const key_type key) const {
-        auto segment_id = base_type::get_segment_id(key);
-        std::size_t pred = std::clamp<double>(base_type::l2_[segment_id].predict(key), 0, base_type::n_keys_ - 1);
-        std::size_t lo = pred > error_lo_ ? pred - error_lo_ : 0;
-        std::size_t hi = std::min(pred + error_hi_ + 1, base_type::n_keys_);
-        return {pred, lo, hi};
+        auto model_id = base_type::get_model_id(key);
+        std::size_t pred = std::clamp<double>(base_type::l2_.predict(model_id, key), 0, base_type::n_keys_ - 1);
+        return bound(model_id, pred);
+    }
+
+    /**
+     * Returns position estimates and search bounds for the keys in the range [first, last) and writes them to the range
+     * beginning at @p d_first.
+     * @param first, last iterators that define the range of keys to search for
+     * @param d_first the beginning of the destination range
+     * @return output iterator to the element past the last element written
+     */
+    template<typename RandomIt, typename OutputIt>
+    OutputIt search(RandomIt first, RandomIt last, OutputIt d_first) const {
+        return base_type::search(first, last, d_first, [this](const std::size_t model_id, const std::size_t pred) {
+            return bound(model_id, pred);
+        });
     }
 
     /**
      * Returns the size of the index in bytes.
      * @return index size in bytes
      */
-    std::size_t size_in_bytes() { return base_type::size_in_bytes() + sizeof(error_lo_) + sizeof(error_hi_); }
+    std::size_t size_in_bytes() const { return base_type::size_in_bytes() + sizeof(error_lo_) + sizeof(error_hi_); }
+
+    private:
+    /**
+     * Returns the search bounds around position estimate @p pred.
+     * @param pred position estimate
+     * @return position estimate and search bounds
+     */
+    Approx bound(const std::size_t /* model_id */, const std::size_t pred) const {
+        std::size_t lo = pred > error_lo_ ? pred - error_lo_ : 0;
+        std::size_t hi = std::min(pred + error_hi_ + 1, base_type::n_keys_);
+        return {pred, lo, hi};
+    }
 };
 
 
 /**
  * Recursive model index with local absolute bounds.
  */
-template<typename Key, typename Layer1, typename Layer2>
-class RmiLAbs : public Rmi<Key, Layer1, Layer2>
+template<typename Key, typename Layer1, typename Layer2, typename Allocator = std::allocator<Layer2>,
+         template<typename, typename> class Storage = AosStorage>
+class RmiLAbs : public Rmi<Key, Layer1, Layer2, Allocator, Storage>
 {
-    using base_type = Rmi<Key, Layer1, Layer2>;
+    using base_type = Rmi<Key, Layer1, Layer2, Allocator, Storage>;
     using key_type = Key;
     using layer1_type = Layer1;
     using layer2_type = Layer2;
 
+    using errors_type = std::vector<std::size_t, typename base_type::template rebind_alloc<std::size_t>>;
+
     protected:
-    std::vector<std::size_t> errors_; ///< The error bounds of the layer2 models.
+    errors_type errors_; ///< The error bounds of the layer2 models.
 
     public:
     /**
@@ -303,27 +511,35 @@ class RmiLAbs : public Rmi<Key, Layer1, Layer2>
      * Builds the index with @p layer2_size models in layer2 on the sorted @p keys.
      * @param keys vector of sorted keys to be indexed
      * @param layer2_size the number of models in layer2
+     * @param compress whether runs of empty segments share a single model
+     * @param alloc allocator for layer2 and error bounds
      */
-    RmiLAbs(const std::vector<key_type> &keys, const std::size_t layer2_size)
-        : RmiLAbs(keys.begin(), keys.end(), layer2_size) { }
+    template<typename KeyAllocator>
+    RmiLAbs(const std::vector<key_type, KeyAllocator> &keys, const std::size_t layer2_size, const bool compress = false,
+            const Allocator &alloc = Allocator())
+        : RmiLAbs(keys.begin(), keys.end(), layer2_size, compress, alloc) { }
 
     /**
      * Builds the index with @p layer2_size models in layer2 on the sorted keys in the range [first, last).
      * @param first, last iterators that define the range of sorted keys to be indexed
      * @param layer2_size the number of models in layer2
+     * @param compress whether runs of empty segments share a single model
+     * @param alloc allocator for layer2 and error bounds
      */
     template<typename RandomIt>
-    RmiLAbs(RandomIt first, RandomIt last, const std::size_t layer2_size) : base_type(first, last, layer2_size) {
+    RmiLAbs(RandomIt first, RandomIt last, const std::size_t layer2_size, const bool compress = false,
+            const Allocator &alloc = Allocator())
+        : base_type(first, last, layer2_size, compress, alloc) {
         // Compute local absolute errror bounds.
-        errors_ = std::vector<std::size_t>(layer2_size);
+        errors_ = errors_type(base_type::n_models_, base_type::l2_allocator_);
         for (std::size_t i = 0; i != base_type::n_keys_; ++i) {
             key_type key = *(first + i);
-            std::size_t segment_id = base_type::get_segment_id(key);
-            std::size_t pred = std::clamp<double>(base_type::l2_[segment_id].predict(key), 0, base_type::n_keys_ - 1);
+            std::size_t model_id = base_type::get_model_id(key);
+            std::size_t pred = std::clamp<double>(base_type::l2_.predict(model_id, key), 0, base_type::n_keys_ - 1);
             if (pred > i) { // overestimation
-                errors_[segment_id] = std::max(errors_[segment_id], pred - i);
+                errors_[model_id] = std::max(errors_[model_id], pred - i);
             } else { // underestimation
-                errors_[segment_id] = std::max(errors_[segment_id], i - pred);
+                errors_[model_id] = std::max(errors_[model_id], i - pred);
             }
         }
     }
@@ -334,29 +550,62 @@ class RmiLAbs : public Rmi<Key, Layer1, Layer2>
      * @return position estimate and search bounds
      */
     Approx search(const key_type key) const {
-        auto segment_id = base_type::get_segment_id(key);
-        std::size_t pred = std::clamp<double>(base_type::l2_[segment_id].predict(key), 0, base_type::n_keys_ - 1);
-        std::size_t err = errors_[segment_id];
-        std::size_t lo = pred > err ? pred - err : 0;
-        std::size_t hi = std::min(pred + err + 1, base_type::n_keys_);
-        return {pred, lo, hi};
+        auto model_id = base_type::get_model_id(key);
+        std::size_t pred = std::clamp<double>(base_type::l2_.predict(model_id, key), 0, base_type::n_keys_ - 1);
+        return bound(model_id, pred);
+    }
+
+    /**
+     * Returns position estimates and search bounds for the keys in the range [first, last) and writes them to the range
+     * beginning at @p d_first.
+     * @param first, last iterators that define the range of keys to search for
+     * @param d_first the beginning of the destination range
+     * @return output iterator to the element past the last element written
+     */
+    template<typename RandomIt, typename OutputIt>
+    OutputIt search(RandomIt first, RandomIt last, OutputIt d_first) const {
+        return base_type::search(first, last, d_first, [this](const std::size_t model_id, const std::size_t pred) {
+            return bound(model_id, pred);
+        });
     }
 
     /**
      * Returns the size of the index in bytes.
      * @return index size in bytes
      */
-    std::size_t size_in_bytes() { return base_type::size_in_bytes() + errors_.size() * sizeof(errors_.front()); }
+    std::size_t size_in_bytes() const { return base_type::size_in_bytes() + errors_.size() * sizeof(errors_.front()); }
+
+    /**
+     * Returns the error bound of the layer2 model with id @p model_id.
+     * @param model_id id of the model, less than n_models()
+     * @return the error bound of the model
+     */
+    std::size_t error(const std::size_t model_id) const { return errors_[model_id]; }
+
+    private:
+    /**
+     * Returns the search bounds of model @p model_id around position estimate @p pred.
+     * @param model_id model the position was estimated by
+     * @param pred position estimate
+     * @return position estimate and search bounds
+     */
+    Approx bound(const std::size_t model_id, const std::size_t pred) const {
+        std::size_t err = errors_[model_id];
+        std::size_t lo = pred > err ? pred - err : 0;
+        std::size_t hi = std::min(pred + err + 1, base_type::n_keys_);
+        return {pred, lo, hi};
+    }
 };
 
 
 /**
  * Recursive model index with local individual bounds.
  */
-template<typename Key, typename Layer1, typename Layer2>
-class RmiLInd : public Rmi<Key, Layer1, Layer2>
+template<typename Key, typename Layer1, typename Layer2, typename Allocator = std::allocator<Layer2>,
+         template<typename, typename> class Storage = AosStorage>
+class RmiLInd : public Rmi<Key, Layer1, Layer2, Allocator, Storage>
 {
-    using base_type = Rmi<Key, Layer1, Layer2>;
+    using base_type = Rmi<Key, Layer1, Layer2, Allocator, Storage>;
     using key_type = Key;
     using layer1_type = Layer1;
     using layer2_type = Layer2;
@@ -375,7 +624,9 @@ class RmiLInd : public Rmi<Key, Layer1, Layer2>
         bounds() : lo(0), hi(0) { }
     };
 
-    std::vector<bounds> errors_; ///< The error bounds of the layer2 models.
+    using errors_type = std::vector<bounds, typename base_type::template rebind_alloc<bounds>>;
+
+    errors_type errors_; ///< The error bounds of the layer2 models.
 
     public:
     /**
@@ -387,28 +638,36 @@ class RmiLInd : public Rmi<Key, Layer1, Layer2>
      * Builds the index with @p layer2_size models in layer2 on the sorted @p keys.
      * @param keys vector of sorted keys to be indexed
      * @param layer2_size the number of models in layer2
+     * @param compress whether runs of empty segments share a single model
+     * @param alloc allocator for layer2 and error bounds
      */
-    RmiLInd(const std::vector<key_type> &keys, const std::size_t layer2_size)
-        : RmiLInd(keys.begin(), keys.end(), layer2_size) { }
+    template<typename KeyAllocator>
+    RmiLInd(const std::vector<key_type, KeyAllocator> &keys, const std::size_t layer2_size, const bool compress = false,
+            const Allocator &alloc = Allocator())
+        : RmiLInd(keys.begin(), keys.end(), layer2_size, compress, alloc) { }
 
     /**
      * Builds the index with @p layer2_size models in layer2 on the sorted keys in the range [first, last).
      * @param first, last iterators that define the range of sorted keys to be indexed
      * @param layer2_size the number of models in layer2
+     * @param compress whether runs of empty segments share a single model
+     * @param alloc allocator for layer2 and error bounds
      */
     template<typename RandomIt>
-    RmiLInd(RandomIt first, RandomIt last, const std::size_t layer2_size) : base_type(first, last, layer2_size) {
+    RmiLInd(RandomIt first, RandomIt last, const std::size_t layer2_size, const bool compress = false,
+            const Allocator &alloc = Allocator())
+        : base_type(first, last, layer2_size, compress, alloc) {
         // Compute local individual errror bounds.
-        errors_ = std::vector<bounds>(layer2_size);
+        errors_ = errors_type(base_type::n_models_, base_type::l2_allocator_);
         for (std::size_t i = 0; i != base_type::n_keys_; ++i) {
             key_type key = *(first + i);
-            std::size_t segment_id = base_type::get_segment_id(key);
-            std::size_t pred = std::clamp<double>(base_type::l2_[segment_id].predict(key), 0, base_type::n_keys_ - 1);
+            std::size_t model_id = base_type::get_model_id(key);
+            std::size_t pred = std::clamp<double>(base_type::l2_.predict(model_id, key), 0, base_type::n_keys_ - 1);
             if (pred > i) { // overestimation
-                std::size_t &lo = errors_[segment_id].lo;
+                std::size_t &lo = errors_[model_id].lo;
                 lo = std::max(lo, pred - i);
             } else { // underestimation
-                std::size_t &hi = errors_[segment_id].hi;
+                std::size_t &hi = errors_[model_id].hi;
                 hi = std::max(hi, i - pred);
             }
         }
@@ -420,19 +679,44 @@ class RmiLInd : public Rmi<Key, Layer1, Layer2>
      * @return position estimate and search bounds
      */
     Approx search(const key_type key) const {
-        auto segment_id = base_type::get_segment_id(key);
-        std::size_t pred = std::clamp<double>(base_type::l2_[segment_id].predict(key), 0, base_type::n_keys_ - 1);
-        bounds err = errors_[segment_id];
-        std::size_t lo = pred > err.lo ? pred - err.lo : 0;
-        std::size_t hi = std::min(pred + err.hi + 1, base_type::n_keys_);
-        return {pred, lo, hi};
+        auto model_id = base_type::get_model_id(key);
+        std::size_t pred = std::clamp<double>(base_type::l2_.predict(model_id, key), 0, base_type::n_keys_ - 1);
+        return bound(model_id, pred);
+    }
+
+    /**
+     * Returns position estimates and search bounds for the keys in the range [first, last) and writes them to the range
+     * beginning at @p d_first.
+     * @param first, last iterators that define the range of keys to search for
+     * @param d_first the beginning of the destination range
+     * @return output iterator to the element past the last element written
+     */
+    template<typename RandomIt, typename OutputIt>
+    OutputIt search(RandomIt first, RandomIt last, OutputIt d_first) const {
+        return base_type::search(first, last, d_first, [this](const std::size_t model_id, const std::size_t pred) {
+            return bound(model_id, pred);
+        });
     }
 
     /**
      * Returns the size of the index in bytes.
      * @return index size in bytes
      */
-    std::size_t size_in_bytes() { return base_type::size_in_bytes() + errors_.size() * sizeof(errors_.front()); }
+    std::size_t size_in_bytes() const { return base_type::size_in_bytes() + errors_.size() * sizeof(errors_.front()); }
+
+    private:
+    /**
+     * Returns the search bounds of model @p model_id around position estimate @p pred.
+     * @param model_id model the position was estimated by
+     * @param pred position estimate
+     * @return position estimate and search bounds
+     */
+    Approx bound(const std::size_t model_id, const std::size_t pred) const {
+        bounds err = errors_[model_id];
+        std::size_t lo = pred > err.lo ? pred - err.lo : 0;
+        std::size_t hi = std::min(pred + err.hi + 1, base_type::n_keys_);
+        return {pred, lo, hi};
+    }
 };
 
 } // namespace rmi
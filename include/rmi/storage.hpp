@@ -0,0 +1,388 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+#include "rmi/models.hpp"
+#include "rmi/util/fn.hpp"
+
+
+namespace rmi {
+
+/**
+ * Stores layer2 models as an array of models (array of structs), i.e. the parameters of each model are adjacent.
+ *
+ * @tparam Model the type of the layer2 models
+ * @tparam Allocator the allocator, rebound to @p Model
+ */
+template<typename Model, typename Allocator>
+class AosStorage
+{
+    using model_type = Model;
+    using allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<model_type>;
+    using alloc_traits = std::allocator_traits<allocator_type>;
+
+    private:
+    model_type *models_ = nullptr; ///< The array of models.
+    std::size_t n_models_ = 0;     ///< The number of models.
+    allocator_type allocator_;     ///< The allocator of the models.
+
+    public:
+    /**
+     * Default constructor.
+     */
+    AosStorage() = default;
+
+    /**
+     * Creates an empty storage that allocates via @p alloc.
+     * @param alloc allocator for the models
+     */
+    explicit AosStorage(const Allocator &alloc) : allocator_(alloc) { }
+
+    AosStorage(const AosStorage&) = delete;
+    AosStorage &operator=(const AosStorage&) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~AosStorage() {
+        if (models_ == nullptr) return;
+        std::destroy_n(models_, n_models_);
+        alloc_traits::deallocate(allocator_, models_, n_models_);
+    }
+
+    /**
+     * Allocates uninitialized memory for @p n_models models, each of which must be set exactly once via fill().
+     * @param n_models the number of models
+     */
+    void allocate(const std::size_t n_models) {
+        n_models_ = n_models;
+        models_ = alloc_traits::allocate(allocator_, n_models_);
+    }
+
+    /**
+     * Sets the models [lo, hi) to copies of @p m.
+     * @param lo, hi the range of models to set
+     * @param m the model
+     */
+    void fill(const std::size_t lo, const std::size_t hi, const model_type &m) {
+        std::uninitialized_fill_n(models_ + lo, hi - lo, m);
+    }
+
+    /**
+     * Returns the estimated y-value of @p x by model @p i.
+     * @param i the model
+     * @param x to estimate a y-value for
+     * @return the estimated y-value for @p x
+     */
+    template<typename X>
+    double predict(const std::size_t i, const X x) const { return models_[i].predict(x); }
+
+    /**
+     * Returns model @p i.
+     * @param i the model
+     * @return the model
+     */
+    const model_type &operator[](const std::size_t i) const { return models_[i]; }
+
+    /**
+     * Returns the size of the models in bytes.
+     * @return size of the models in bytes
+     */
+    std::size_t size_in_bytes() const {
+        std::size_t size = 0;
+        for (std::size_t i = 0; i != n_models_; ++i) size += models_[i].size_in_bytes(); // models may differ in size
+        return size;
+    }
+};
+
+/**
+ * Stores piecewise linear layer2 models as an array of fixed-size entries. Each entry holds the first piece of its model
+ * and the offset and number of the remaining pieces, which all models keep in a single array. Both arrays are allocated
+ * via the allocator. Evaluating a model with k > 1 pieces beyond its first piece costs one additional memory access and
+ * O(log k) comparisons, single-piece models never touch the shared array.
+ *
+ * The shared array grows geometrically while models are set, so up to half of its capacity may remain unused.
+ *
+ * @tparam X the type of x-values of the models
+ * @tparam Epsilon the maximum error of the models
+ * @tparam Allocator the allocator, rebound to the entries and pieces
+ */
+template<typename X, std::size_t Epsilon, typename Allocator>
+class AosStorage<PiecewiseLinear<X, Epsilon>, Allocator>
+{
+    using model_type = PiecewiseLinear<X, Epsilon>;
+    using piece_type = typename model_type::piece;
+
+    /**
+     * The first piece of a model and the location of its remaining pieces in the shared array.
+     */
+    struct entry {
+        piece_type first; ///< The first piece.
+        uint32_t offset;  ///< The offset of the remaining pieces.
+        uint32_t n_rest;  ///< The number of remaining pieces.
+    };
+
+    using entry_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<entry>;
+    using entry_traits = std::allocator_traits<entry_allocator_type>;
+    using piece_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<piece_type>;
+    using piece_traits = std::allocator_traits<piece_allocator_type>;
+
+    private:
+    entry *entries_ = nullptr;             ///< The entry of each model.
+    std::size_t n_models_ = 0;             ///< The number of models.
+    piece_type *pieces_ = nullptr;         ///< The remaining pieces of all models.
+    std::size_t n_pieces_ = 0;             ///< The number of remaining pieces of all models.
+    std::size_t capacity_ = 0;             ///< The number of remaining pieces allocated.
+    entry_allocator_type entry_allocator_; ///< The allocator of the entries.
+    piece_allocator_type piece_allocator_; ///< The allocator of the remaining pieces.
+
+    public:
+    /**
+     * Default constructor.
+     */
+    AosStorage() = default;
+
+    /**
+     * Creates an empty storage that allocates via @p alloc.
+     * @param alloc allocator for the entries and pieces
+     */
+    explicit AosStorage(const Allocator &alloc) : entry_allocator_(alloc), piece_allocator_(alloc) { }
+
+    AosStorage(const AosStorage&) = delete;
+    AosStorage &operator=(const AosStorage&) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~AosStorage() {
+        if (entries_ != nullptr) entry_traits::deallocate(entry_allocator_, entries_, n_models_);
+        if (pieces_ != nullptr) piece_traits::deallocate(piece_allocator_, pieces_, capacity_);
+    }
+
+    /**
+     * Allocates uninitialized memory for @p n_models models, each of which must be set exactly once via fill().
+     * @param n_models the number of models
+     */
+    void allocate(const std::size_t n_models) {
+        n_models_ = n_models;
+        entries_ = entry_traits::allocate(entry_allocator_, n_models_);
+    }
+
+    /**
+     * Sets the models [lo, hi) to copies of @p m. The models share the remaining pieces of @p m.
+     * @param lo, hi the range of models to set
+     * @param m the model
+     */
+    void fill(const std::size_t lo, const std::size_t hi, const model_type &m) {
+        auto &rest = m.rest_pieces();
+        assert(n_pieces_ + rest.size() <= std::numeric_limits<uint32_t>::max() and "too many pieces");
+        if (n_pieces_ + rest.size() > capacity_) {
+            std::size_t capacity = std::max(2 * capacity_, n_pieces_ + rest.size());
+            piece_type *pieces = piece_traits::allocate(piece_allocator_, capacity);
+            std::uninitialized_copy_n(pieces_, n_pieces_, pieces);
+            if (pieces_ != nullptr) piece_traits::deallocate(piece_allocator_, pieces_, capacity_);
+            pieces_ = pieces;
+            capacity_ = capacity;
+        }
+        std::uninitialized_copy(rest.begin(), rest.end(), pieces_ + n_pieces_);
+        entry e{m.first_piece(), static_cast<uint32_t>(n_pieces_), static_cast<uint32_t>(rest.size())};
+        std::uninitialized_fill_n(entries_ + lo, hi - lo, e);
+        n_pieces_ += rest.size();
+    }
+
+    /**
+     * Returns the estimated y-value of @p x by model @p i.
+     * @param i the model
+     * @param x to estimate a y-value for
+     * @return the estimated y-value for @p x
+     */
+    double predict(const std::size_t i, const X x) const {
+        const entry &e = entries_[i];
+        return model_type::predict(e.first, pieces_ + e.offset, e.n_rest, x);
+    }
+
+    /**
+     * Returns the size of the models in bytes.
+     * @return size of the models in bytes
+     */
+    std::size_t size_in_bytes() const { return n_models_ * sizeof(entry) + n_pieces_ * sizeof(piece_type); }
+};
+
+
+/**
+ * Describes the parameters of a model type for SoaStorage. Specializations provide the number of parameters `size`,
+ * `get(m, p)`, which writes the parameters of model `m` to `p`, and `predict(p, i, x)`, which evaluates the `i`-th
+ * model on `x` given one array per parameter `p` and must match `Model::predict()` exactly.
+ * @tparam Model the type of the models
+ */
+template<typename Model>
+struct SoaParams
+{
+    static_assert(sizeof(Model) == 0, "model type does not support struct-of-arrays storage");
+};
+
+/**
+ * Parameters of linear models, i.e. slope and intercept.
+ */
+struct LinearSoaParams
+{
+    static constexpr std::size_t size = 2; ///< The number of parameters.
+
+    /**
+     * Writes the slope and intercept of @p m to @p p.
+     * @param m the model
+     * @param p the destination of the parameters
+     */
+    template<typename Model>
+    static void get(const Model &m, double *p) {
+        p[0] = m.slope();
+        p[1] = m.intercept();
+    }
+
+    /**
+     * Returns the estimated y-value of @p x by model @p i.
+     * @param p the array of each parameter
+     * @param i the model
+     * @param x to estimate a y-value for
+     * @return the estimated y-value for @p x
+     */
+    template<typename X>
+    static double predict(const double *const *p, const std::size_t i, const X x) {
+        return std::fma(p[0][i], static_cast<double>(x), p[1][i]);
+    }
+};
+
+template<> struct SoaParams<LinearSpline> : LinearSoaParams { };
+template<> struct SoaParams<LinearRegression> : LinearSoaParams { };
+template<> struct SoaParams<AutoLinear> : LinearSoaParams { };
+
+/**
+ * Parameters of cubic splines, i.e. the first x-value and the four coefficients.
+ */
+template<>
+struct SoaParams<CubicSpline>
+{
+    static constexpr std::size_t size = 5; ///< The number of parameters.
+
+    /**
+     * Writes the first x-value and the coefficients of @p m to @p p.
+     * @param m the model
+     * @param p the destination of the parameters
+     */
+    static void get(const CubicSpline &m, double *p) {
+        p[0] = m.xmin();
+        p[1] = m.a();
+        p[2] = m.b();
+        p[3] = m.c();
+        p[4] = m.d();
+    }
+
+    /**
+     * Returns the estimated y-value of @p x by model @p i.
+     * @param p the array of each parameter
+     * @param i the model
+     * @param x to estimate a y-value for
+     * @return the estimated y-value for @p x
+     */
+    template<typename X>
+    static double predict(const double *const *p, const std::size_t i, const X x) {
+        double x_ = CubicSpline::rebase(x, p[0][i]);
+        return std::fma(std::fma(std::fma(p[1][i], x_, p[2][i]), x_, p[3][i]), x_, p[4][i]);
+    }
+};
+
+
+/**
+ * Stores layer2 models as struct of arrays, i.e. each parameter of all models in a separate array aligned to a cache
+ * line, e.g. all slopes followed by all intercepts. Evaluating a model thus touches one cache line per parameter
+ * instead of one in total, but batched evaluation can load a parameter of several models with a single gather.
+ *
+ * @tparam Model the type of the layer2 models, which must specialize SoaParams
+ * @tparam Allocator the allocator, rebound to `double`
+ */
+template<typename Model, typename Allocator>
+class SoaStorage
+{
+    using model_type = Model;
+    using params_type = SoaParams<Model>;
+    using allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<double>;
+    using alloc_traits = std::allocator_traits<allocator_type>;
+
+    static constexpr std::size_t n_params = params_type::size;                ///< The number of parameters per model.
+    static constexpr std::size_t line_size = cache_line_size / sizeof(double); ///< The number of doubles per line.
+
+    private:
+    double *data_ = nullptr;          ///< The allocated memory holding all arrays.
+    std::size_t capacity_ = 0;        ///< The number of allocated doubles.
+    double *params_[n_params] = { };  ///< The array of each parameter.
+    std::size_t n_models_ = 0;        ///< The number of models.
+    allocator_type allocator_;        ///< The allocator of the arrays.
+
+    public:
+    /**
+     * Default constructor.
+     */
+    SoaStorage() = default;
+
+    /**
+     * Creates an empty storage that allocates via @p alloc.
+     * @param alloc allocator for the arrays
+     */
+    explicit SoaStorage(const Allocator &alloc) : allocator_(alloc) { }
+
+    SoaStorage(const SoaStorage&) = delete;
+    SoaStorage &operator=(const SoaStorage&) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~SoaStorage() {
+        if (data_ != nullptr) alloc_traits::deallocate(allocator_, data_, capacity_);
+    }
+
+    /**
+     * Allocates memory for @p n_models models, each of which must be set via fill().
+     * @param n_models the number of models
+     */
+    void allocate(const std::size_t n_models) {
+        n_models_ = n_models;
+        std::size_t stride = (n_models + line_size - 1) / line_size * line_size; // keep each array aligned
+        capacity_ = n_params * stride + line_size - 1;
+        data_ = alloc_traits::allocate(allocator_, capacity_);
+        auto aligned = (reinterpret_cast<uintptr_t>(data_) + cache_line_size - 1) & ~uintptr_t(cache_line_size - 1);
+        for (std::size_t p = 0; p != n_params; ++p) params_[p] = reinterpret_cast<double*>(aligned) + p * stride;
+    }
+
+    /**
+     * Sets the models [lo, hi) to the parameters of @p m.
+     * @param lo, hi the range of models to set
+     * @param m the model
+     */
+    void fill(const std::size_t lo, const std::size_t hi, const model_type &m) {
+        double p[n_params];
+        params_type::get(m, p);
+        for (std::size_t i = 0; i != n_params; ++i) std::fill(params_[i] + lo, params_[i] + hi, p[i]);
+    }
+
+    /**
+     * Returns the estimated y-value of @p x by model @p i.
+     * @param i the model
+     * @param x to estimate a y-value for
+     * @return the estimated y-value for @p x
+     */
+    template<typename X>
+    double predict(const std::size_t i, const X x) const { return params_type::predict(params_, i, x); }
+
+    /**
+     * Returns the size of the models in bytes.
+     * @return size of the models in bytes
+     */
+    std::size_t size_in_bytes() const { return n_params * n_models_ * sizeof(double); }
+};
+
+} // namespace rmi
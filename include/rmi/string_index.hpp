@@ -0,0 +1,280 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "rmi/index.hpp"
+#include "rmi/util/search.hpp"
+
+
+namespace rmi {
+
+/**
+ * Indexes sorted string keys with a recursive model index on order-preserving 64-bit prefixes.
+ *
+ * The common prefix of all keys is stripped and the following eight bytes of each key are interpreted as a big-endian
+ * integer, padded with zero bytes for shorter keys. This encoding is monotonic, i.e. a < b implies encode(a) <=
+ * encode(b), but keys may share an encoding. The RMI finds the first key whose encoding is not less than that of the
+ * lookup key, ties are then resolved by comparing the remaining bytes of the keys. The keys are stored in a single
+ * character array that is addressed by an offset array.
+ *
+ * @tparam Rmi the type of the recursive model index on `uint64_t` keys, e.g. `RmiLAbs<uint64_t, LinearSpline,
+ * LinearRegression>`
+ * @tparam Search the functor used for searching the interval returned by @p Rmi
+ */
+template<typename Rmi, typename Search = BinarySearch>
+class StringIndex
+{
+    public:
+    using rmi_type = Rmi;
+    using index_type = Index<uint64_t, rmi_type, Search>;
+
+    static constexpr std::size_t prefix_width = sizeof(uint64_t); ///< The number of bytes encoded per key.
+
+    private:
+    std::string data_;                  ///< The concatenated characters of all keys.
+    std::vector<std::size_t> offsets_;  ///< The offsets of the keys in data_, followed by the size of data_.
+    std::size_t skip_;                  ///< The length of the common prefix of all keys.
+    std::string common_;                ///< The common prefix of all keys.
+    std::vector<uint64_t> prefixes_;    ///< The encoded keys.
+    index_type index_;                  ///< The index on the encoded keys.
+
+    public:
+    /**
+     * Builds the index with @p layer2_size models in layer2 on the sorted, non-empty @p keys.
+     * @param keys vector of sorted keys to be indexed
+     * @param layer2_size the number of models in layer2
+     */
+    StringIndex(const std::vector<std::string> &keys, const std::size_t layer2_size)
+        : data_(concat(keys))
+        , offsets_(offsets(keys))
+        , skip_(common_prefix_length(keys.front(), keys.back()))
+        , common_(keys.front().substr(0, skip_))
+        , prefixes_(encode_all(keys))
+        , index_(prefixes_, layer2_size) { }
+
+    StringIndex(const StringIndex&) = delete;
+    StringIndex &operator=(const StringIndex&) = delete;
+
+    /**
+     * Returns the position of the first key that is not less than @p key.
+     * @param key to search for
+     * @return position of the first key that is not less than @p key, or size() if there is no such key
+     */
+    std::size_t lower_bound(std::string_view key) const {
+        auto prefix = encode(key);
+        auto first = std::distance(index_.begin(), index_.lower_bound(prefix));
+        return resolve(key, prefix, first).first;
+    }
+
+    /**
+     * Returns the position of the first key that is not less than @p key given the position @p first of the first key
+     * whose encoding is not less than that of @p key, e.g. as determined by another index on prefixes().
+     * @param key to search for
+     * @param first position of the first key whose encoding is not less than encode(@p key)
+     * @return position of the first key that is not less than @p key, or size() if there is no such key
+     */
+    std::size_t lower_bound(std::string_view key, const std::size_t first) const {
+        return resolve(key, encode(key), first).first;
+    }
+
+    /**
+     * Returns the position of the first key that is greater than @p key.
+     * @param key to search for
+     * @return position of the first key that is greater than @p key, or size() if there is no such key
+     */
+    std::size_t upper_bound(std::string_view key) const { return equal_range(key).second; }
+
+    /**
+     * Returns the range of positions of keys equal to @p key.
+     * @param key to search for
+     * @return pair of the position of the first key not less than and the first key greater than @p key
+     */
+    std::pair<std::size_t, std::size_t> equal_range(std::string_view key) const {
+        auto prefix = encode(key);
+        auto first = std::distance(index_.begin(), index_.lower_bound(prefix));
+        auto [lo, last] = resolve(key, prefix, first);
+        auto offset = tie_offset(key);
+        auto hi = partition_point(lo, last, [&](const std::size_t i) {
+            return not less(key, i, offset);
+        });
+        return {lo, hi};
+    }
+
+    /**
+     * Returns the key at position @p i.
+     * @param i position of the key
+     * @return the key
+     */
+    std::string_view key(const std::size_t i) const {
+        return std::string_view(data_.data() + offsets_[i], offsets_[i + 1] - offsets_[i]);
+    }
+
+    /**
+     * Returns the number of keys.
+     * @return number of keys
+     */
+    std::size_t size() const { return prefixes_.size(); }
+
+    /**
+     * Returns the order-preserving 64-bit encoding of @p key. Keys that are smaller or larger than the common prefix of
+     * all keys are mapped to the smallest or largest encoding, respectively.
+     * @param key to encode
+     * @return the encoding of @p key
+     */
+    uint64_t encode(std::string_view key) const {
+        int cmp = key.substr(0, skip_).compare(common_);
+        if (cmp < 0) return 0;
+        if (cmp > 0) return std::numeric_limits<uint64_t>::max();
+
+        unsigned char bytes[prefix_width] = { 0 };
+        std::memcpy(bytes, key.data() + skip_, std::min(prefix_width, key.size() - skip_));
+        uint64_t prefix;
+        std::memcpy(&prefix, bytes, prefix_width);
+        return __builtin_bswap64(prefix);
+    }
+
+    /**
+     * Returns the encoded keys.
+     * @return vector of encoded keys
+     */
+    const std::vector<uint64_t> &prefixes() const { return prefixes_; }
+
+    /**
+     * Returns the length of the common prefix of all keys.
+     * @return common prefix length
+     */
+    std::size_t common_prefix_length() const { return skip_; }
+
+    /**
+     * Returns the size of the index in bytes, excluding the keys but including the encoded keys and the offset array.
+     * @return index size in bytes
+     */
+    std::size_t size_in_bytes() const {
+        return index_.size_in_bytes() + prefixes_.size() * sizeof(uint64_t) + offsets_.size() * sizeof(std::size_t)
+            + common_.size() + sizeof(skip_);
+    }
+
+    private:
+    /**
+     * Resolves ties among the keys whose encoding equals @p prefix, starting at position @p first.
+     * @param key to search for
+     * @param prefix the encoding of @p key
+     * @param first position of the first key whose encoding is not less than @p prefix
+     * @return pair of the position of the first key not less than @p key and the end of the run of keys whose encoding
+     * equals @p prefix
+     */
+    std::pair<std::size_t, std::size_t> resolve(std::string_view key, const uint64_t prefix,
+                                                const std::size_t first) const {
+        if (first == size() or prefixes_[first] != prefix) return {first, first};
+
+        // Find the end of the run of ties by galloping since runs are typically short.
+        auto begin = prefixes_.begin();
+        std::size_t last = prefix == std::numeric_limits<uint64_t>::max()
+            ? size() : std::distance(begin, ExponentialSearch()(begin + first, prefixes_.end(), begin + first, prefix + 1));
+
+        // Compare remaining bytes only.
+        auto offset = tie_offset(key);
+        auto lo = partition_point(first, last, [&](const std::size_t i) {
+            return less(i, key, offset);
+        });
+        return {lo, last};
+    }
+
+    /**
+     * Returns the number of leading bytes that @p key shares with all keys of the same encoding.
+     * @param key the lookup key
+     * @return the number of bytes that can be skipped when comparing ties
+     */
+    std::size_t tie_offset(std::string_view key) const {
+        return key.substr(0, skip_) == common_ ? skip_ + prefix_width : 0;
+    }
+
+    /**
+     * Returns whether the key at position @p i is less than @p key, skipping the first @p offset bytes.
+     */
+    bool less(const std::size_t i, std::string_view key, const std::size_t offset) const {
+        auto k = this->key(i);
+        auto off = std::min({offset, k.size(), key.size()});
+        return k.substr(off) < key.substr(off);
+    }
+
+    /**
+     * Returns whether @p key is less than the key at position @p i, skipping the first @p offset bytes.
+     */
+    bool less(std::string_view key, const std::size_t i, const std::size_t offset) const {
+        auto k = this->key(i);
+        auto off = std::min({offset, k.size(), key.size()});
+        return key.substr(off) < k.substr(off);
+    }
+
+    /**
+     * Returns the first position in [@p first, @p last) for which @p pred returns false using binary search.
+     * @tparam Pred unary predicate type
+     * @param first, last positions defining the range partitioned by @p pred
+     * @param pred predicate on positions
+     * @return first position for which @p pred returns false, or @p last if there is no such position
+     */
+    template<typename Pred>
+    static std::size_t partition_point(std::size_t first, const std::size_t last, Pred pred) {
+        std::size_t count = last - first;
+        while (count > 0) {
+            std::size_t step = count / 2;
+            if (pred(first + step)) {
+                first += step + 1;
+                count -= step + 1;
+            } else {
+                count = step;
+            }
+        }
+        return first;
+    }
+
+    /**
+     * Returns the length of the common prefix of @p a and @p b.
+     */
+    static std::size_t common_prefix_length(const std::string &a, const std::string &b) {
+        return std::distance(a.begin(), std::mismatch(a.begin(), a.end(), b.begin(), b.end()).first);
+    }
+
+    /**
+     * Returns the concatenation of @p keys.
+     */
+    static std::string concat(const std::vector<std::string> &keys) {
+        std::string data;
+        for (auto &key : keys) data += key;
+        return data;
+    }
+
+    /**
+     * Returns the offsets of @p keys in their concatenation, followed by the length of the concatenation.
+     */
+    static std::vector<std::size_t> offsets(const std::vector<std::string> &keys) {
+        std::vector<std::size_t> offsets;
+        offsets.reserve(keys.size() + 1);
+        std::size_t offset = 0;
+        for (auto &key : keys) {
+            offsets.push_back(offset);
+            offset += key.size();
+        }
+        offsets.push_back(offset);
+        return offsets;
+    }
+
+    /**
+     * Returns the encodings of @p keys.
+     */
+    std::vector<uint64_t> encode_all(const std::vector<std::string> &keys) const {
+        std::vector<uint64_t> prefixes;
+        prefixes.reserve(keys.size());
+        for (auto &key : keys) prefixes.push_back(encode(key));
+        return prefixes;
+    }
+};
+
+} // namespace rmi
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+
+
+/**
+ * Page sizes backing the memory returned by HugePageAllocator.
+ */
+enum class PageSize : std::size_t {
+    regular = 0,          ///< The regular page size of the system.
+    huge_2mb = 1UL << 21, ///< 2 MiB huge pages.
+    huge_1gb = 1UL << 30, ///< 1 GiB huge pages.
+};
+
+/**
+ * NUMA policies applied to the memory returned by HugePageAllocator.
+ */
+enum class NumaPolicy {
+    none,       ///< Pages are placed by the default policy of the system, usually on the node of the first access.
+    bind,       ///< Pages are placed on the nodes of the node mask.
+    interleave, ///< Pages are placed round-robin on the nodes of the node mask.
+};
+
+
+/**
+ * Allocator that backs allocations with huge pages and optionally binds them to or interleaves them across NUMA nodes.
+ *
+ * Allocations are first requested from the reserved huge page pool via `mmap` with `MAP_HUGETLB`. If the pool cannot
+ * serve the request, the allocator maps memory aligned to the huge page size and advises the kernel to back it with
+ * transparent huge pages via `madvise`. Transparent huge pages are 2 MiB on x86-64, so 1 GiB pages require a reserved
+ * pool. The NUMA policy is applied via `mbind` before the memory is touched. Failures to apply the NUMA policy, e.g.
+ * on systems without NUMA support, are ignored.
+ *
+ * With regular pages and without NUMA policy, the allocator behaves like `std::allocator`.
+ *
+ * @tparam T the type of the allocated objects
+ */
+template<typename T>
+class HugePageAllocator
+{
+    template<typename U> friend class HugePageAllocator;
+
+    public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    private:
+    PageSize page_size_;     ///< The page size backing allocations.
+    NumaPolicy numa_policy_; ///< The NUMA policy applied to allocations.
+    uint64_t node_mask_;     ///< The NUMA nodes the policy refers to, one bit per node.
+
+    public:
+    /**
+     * Creates an allocator that allocates on @p page_size pages placed according to @p numa_policy.
+     * @param page_size the page size backing allocations
+     * @param numa_policy the NUMA policy applied to allocations
+     * @param node_mask the NUMA nodes @p numa_policy refers to, one bit per node
+     */
+    HugePageAllocator(const PageSize page_size = PageSize::huge_2mb,
+                      const NumaPolicy numa_policy = NumaPolicy::none,
+                      const uint64_t node_mask = 1)
+        : page_size_(page_size)
+        , numa_policy_(numa_policy)
+        , node_mask_(node_mask) { }
+
+    /**
+     * Creates an allocator with the same configuration as @p other.
+     * @param other allocator to copy the configuration from
+     */
+    template<typename U>
+    HugePageAllocator(const HugePageAllocator<U> &other)
+        : page_size_(other.page_size_)
+        , numa_policy_(other.numa_policy_)
+        , node_mask_(other.node_mask_) { }
+
+    /**
+     * Allocates uninitialized memory for @p n objects.
+     * @param n number of objects
+     * @return pointer to the allocated memory
+     * @throws std::bad_alloc if the memory cannot be allocated
+     */
+    T *allocate(const std::size_t n) {
+        if (plain()) return static_cast<T*>(::operator new(n * sizeof(T)));
+
+        std::size_t length = mapping_length(n);
+        void *p = MAP_FAILED;
+        if (page_size_ != PageSize::regular) {
+            int log_page_size = __builtin_ctzl(static_cast<std::size_t>(page_size_));
+            p = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (log_page_size << MAP_HUGE_SHIFT), -1, 0);
+        }
+        if (p == MAP_FAILED) { // fall back to transparent huge pages
+            p = map_aligned(length, page_length());
+            if (page_size_ != PageSize::regular) madvise(p, length, MADV_HUGEPAGE);
+        }
+
+        if (numa_policy_ != NumaPolicy::none) {
+            const int mode = numa_policy_ == NumaPolicy::bind ? 2 /* MPOL_BIND */ : 3 /* MPOL_INTERLEAVE */;
+            syscall(SYS_mbind, p, length, mode, &node_mask_, 8 * sizeof(node_mask_) + 1, 0);
+        }
+        return static_cast<T*>(p);
+    }
+
+    /**
+     * Deallocates the memory for @p n objects at @p p previously returned by allocate().
+     * @param p pointer to the memory
+     * @param n number of objects
+     */
+    void deallocate(T *p, const std::size_t n) {
+        if (plain()) ::operator delete(p);
+        else munmap(p, mapping_length(n));
+    }
+
+    template<typename U>
+    bool operator==(const HugePageAllocator<U> &other) const {
+        return page_size_ == other.page_size_ and numa_policy_ == other.numa_policy_ and node_mask_ == other.node_mask_;
+    }
+
+    template<typename U>
+    bool operator!=(const HugePageAllocator<U> &other) const { return not (*this == other); }
+
+    private:
+    /**
+     * Returns whether allocations are served by `operator new`.
+     */
+    bool plain() const { return page_size_ == PageSize::regular and numa_policy_ == NumaPolicy::none; }
+
+    /**
+     * Returns the length of the pages backing allocations in bytes.
+     */
+    std::size_t page_length() const {
+        return page_size_ == PageSize::regular ? sysconf(_SC_PAGESIZE) : static_cast<std::size_t>(page_size_);
+    }
+
+    /**
+     * Returns the length of the mapping for @p n objects, i.e. their size rounded up to a multiple of the page length.
+     */
+    std::size_t mapping_length(const std::size_t n) const {
+        std::size_t page = page_length();
+        return (n * sizeof(T) + page - 1) / page * page;
+    }
+
+    /**
+     * Maps @p length bytes of anonymous memory aligned to @p alignment by over-allocating and unmapping the excess.
+     * @param length number of bytes to map, a multiple of @p alignment
+     * @param alignment the alignment, a power of two
+     * @return pointer to the mapped memory
+     * @throws std::bad_alloc if the memory cannot be mapped
+     */
+    static void *map_aligned(const std::size_t length, const std::size_t alignment) {
+        void *p = mmap(nullptr, length + alignment, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) throw std::bad_alloc();
+        auto begin = reinterpret_cast<uintptr_t>(p);
+        auto aligned = (begin + alignment - 1) & ~(alignment - 1);
+        if (aligned != begin) munmap(p, aligned - begin);
+        munmap(reinterpret_cast<void*>(aligned + length), begin + alignment - aligned);
+        return reinterpret_cast<void*>(aligned);
+    }
+};
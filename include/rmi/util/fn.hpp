@@ -1,15 +1,29 @@
 #pragma once
 
 #include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <limits>
 #include <numeric>
 #include <sstream>
+#include <thread>
 #include <type_traits>
 #include <vector>
 
 
+/*======================================================================================================================
+ * Hardware Constants
+ *====================================================================================================================*/
+
+#ifdef LEVEL1_DCACHE_LINESIZE
+constexpr std::size_t cache_line_size = LEVEL1_DCACHE_LINESIZE; ///< The size of a cache line in bytes.
+#else
+constexpr std::size_t cache_line_size = 64; ///< The size of a cache line in bytes.
+#endif
+
+
 /*======================================================================================================================
  * Bit Functions
  *====================================================================================================================*/
@@ -24,6 +38,7 @@ template<typename Numeric>
 uint8_t bit_width(Numeric n)
 {
     static_assert(std::is_unsigned<Numeric>::value, "not defined for signed integral types");
+    if (n == 0) return 0; // leading zeros of 0 are undefined
 
     // Count leading zeros.
     int lz;
@@ -50,7 +65,10 @@ uint8_t bit_width(Numeric n)
 template<typename Numeric>
 uint8_t common_prefix_width(Numeric v1, Numeric v2)
 {
+    static_assert(std::is_unsigned<Numeric>::value, "not defined for signed integral types");
+
     Numeric Xor = v1 ^ v2; // bit-wise xor
+    if (Xor == 0) return sizeof(Numeric) * 8; // leading zeros of 0 are undefined
 
     if constexpr (sizeof(Numeric) <= sizeof(unsigned)) {
         return __builtin_clz(Xor);
@@ -64,6 +82,47 @@ uint8_t common_prefix_width(Numeric v1, Numeric v2)
 }
 
 
+/*======================================================================================================================
+ * Key Functions
+ *====================================================================================================================*/
+
+/**
+ * Maps @p key to an unsigned integer of the same width such that the order of keys is preserved, i.e. x < y implies
+ * radix_key(x) <= radix_key(y). Unsigned keys are returned as is. Signed keys get their sign bit flipped. Floating-point
+ * keys get their sign bit flipped if they are positive and all their bits flipped if they are negative. NaNs are not
+ * supported.
+ * @tparam Key the type of the key
+ * @param key the key
+ * @return the order-preserving unsigned representation of the key
+ */
+template<typename Key>
+auto radix_key(const Key key)
+{
+    if constexpr (std::is_floating_point_v<Key>) {
+        using bits_type = std::conditional_t<sizeof(Key) == sizeof(uint32_t), uint32_t, uint64_t>;
+        static_assert(sizeof(Key) == sizeof(bits_type), "unsupported width of floating-point type");
+        constexpr bits_type sign = bits_type(1) << (sizeof(bits_type) * 8 - 1);
+        bits_type bits;
+        std::memcpy(&bits, &key, sizeof(Key));
+        return bits & sign ? bits_type(~bits) : bits_type(bits | sign);
+    } else if constexpr (std::is_signed_v<Key>) {
+        using bits_type = std::make_unsigned_t<Key>;
+        constexpr bits_type sign = bits_type(1) << (sizeof(bits_type) * 8 - 1);
+        return bits_type(static_cast<bits_type>(key) ^ sign);
+    } else {
+        static_assert(std::is_unsigned_v<Key>, "not defined for non-arithmetic types");
+        return key;
+    }
+}
+
+/**
+ * The unsigned integer type returned by radix_key() for keys of type @p Key.
+ * @tparam Key the type of the key
+ */
+template<typename Key>
+using radix_key_t = decltype(radix_key(std::declval<Key>()));
+
+
 /*======================================================================================================================
  * String Functions
  *====================================================================================================================*/
@@ -74,7 +133,7 @@ uint8_t common_prefix_width(Numeric v1, Numeric v2)
  * @param delimiter the delimiter to split the string at
  * @return vector of substrings
  */
-std::vector<std::string> split(const std::string &str, char delimiter)
+inline std::vector<std::string> split(const std::string &str, char delimiter)
 {
     std::vector<std::string> tokens;
     std::string token;
@@ -150,6 +209,33 @@ Numeric max(std::vector<Numeric> &v)
 }
 
 
+/*======================================================================================================================
+ * Parallel Functions
+ *====================================================================================================================*/
+
+/**
+ * Splits the range [0, @p n) into @p n_threads contiguous chunks of (almost) equal size and calls @p fn(thread_id,
+ * begin, end) for each chunk [begin, end) on a separate thread. Returns after all threads have finished.
+ * @tparam Fn the type of the function
+ * @param n the size of the range
+ * @param n_threads number of threads, must be positive
+ * @param fn function to be called for each chunk
+ */
+template<typename Fn>
+void parallel_for(const std::size_t n, const std::size_t n_threads, Fn fn)
+{
+    std::size_t chunk_size = (n + n_threads - 1) / n_threads;
+    std::vector<std::thread> threads;
+    threads.reserve(n_threads);
+    for (std::size_t t = 0; t != n_threads; ++t) {
+        std::size_t begin = std::min(n, t * chunk_size);
+        std::size_t end = std::min(n, begin + chunk_size);
+        threads.emplace_back(fn, t, begin, end);
+    }
+    for (auto &thread : threads) thread.join();
+}
+
+
 /*======================================================================================================================
  * Dataset Functions
  *====================================================================================================================*/
@@ -185,3 +271,30 @@ std::vector<Key> load_data(const std::string &filename) {
 
     return data;
 }
+
+/**
+ * Writes the keys in vector @p data to dataset file @p filename in binary format, i.e., the number of keys as uint64_t
+ * followed by the keys. The file can be read with load_data().
+ * @tparam Key the type of the key
+ * @param data vector of keys
+ * @param filename name of the dataset file
+ */
+template<typename Key>
+void save_data(const std::vector<Key> &data, const std::string &filename) {
+    using key_type = Key;
+
+    // Open file.
+    std::ofstream out(filename, std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "Could not write " << filename << '.' << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // Write number of keys.
+    uint64_t n_keys = data.size();
+    out.write(reinterpret_cast<const char*>(&n_keys), sizeof(uint64_t));
+
+    // Write keys.
+    out.write(reinterpret_cast<const char*>(data.data()), n_keys * sizeof(key_type));
+    out.close();
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "rmi/util/fn.hpp"
+
+
+/**
+ * A NUMA node and the CPUs attached to it.
+ */
+struct NumaNode {
+    unsigned id;           ///< The id of the node.
+    std::vector<int> cpus; ///< The CPUs of the node.
+};
+
+
+/**
+ * Parses a CPU list such as `0-3,8,10-11` as used by sysfs.
+ * @param list the CPU list
+ * @return vector of CPUs
+ */
+inline std::vector<int> parse_cpu_list(const std::string &list)
+{
+    std::vector<int> cpus;
+    for (auto &range : split(list, ',')) {
+        auto bounds = split(range, '-');
+        if (bounds.empty() or bounds.front().empty()) continue;
+        int lo = std::stoi(bounds.front());
+        int hi = bounds.size() > 1 ? std::stoi(bounds.back()) : lo;
+        for (int cpu = lo; cpu <= hi; ++cpu) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+/**
+ * Returns the NUMA nodes of the system that have CPUs attached, read from `/sys/devices/system/node`. If NUMA
+ * information is not available, all CPUs are reported as a single node 0.
+ * @return vector of NUMA nodes sorted by id
+ */
+inline std::vector<NumaNode> numa_nodes()
+{
+    std::vector<NumaNode> nodes;
+    std::ifstream online("/sys/devices/system/node/has_cpu");
+    std::string list;
+    if (online and std::getline(online, list)) {
+        for (int id : parse_cpu_list(list)) {
+            std::ifstream cpulist("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist");
+            std::string cpus;
+            if (cpulist and std::getline(cpulist, cpus)) nodes.push_back({static_cast<unsigned>(id), parse_cpu_list(cpus)});
+        }
+    }
+    if (nodes.empty()) {
+        NumaNode node{0, {}};
+        for (unsigned cpu = 0; cpu != std::max(1U, std::thread::hardware_concurrency()); ++cpu) node.cpus.push_back(cpu);
+        nodes.push_back(node);
+    }
+    return nodes;
+}
+
+/**
+ * Restricts the calling thread to the CPUs @p cpus.
+ * @param cpus the CPUs the thread may run on
+ * @return whether the affinity was set
+ */
+inline bool pin_thread(const std::vector<int> &cpus)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "rmi/util/fn.hpp"
+
+
+/**
+ * Compressed, read-only storage of sorted unsigned integer keys.
+ *
+ * The keys are split into blocks of `block_size` keys. Each block is encoded relative to a linear function of the
+ * position within the block, i.e. key `j` of a block is `base + j * step + r_j`, where the residuals `r_j` are
+ * bit-packed at the minimal bit width of the block. The step is either the mean gap between the keys of the block,
+ * rounded down, or zero, i.e. frame-of-reference encoding, whichever yields the smaller width. Since a block of 64
+ * residuals of width w takes exactly w words, blocks stay word-aligned.
+ *
+ * A key is decoded without branches from the block header and the at most two words holding its residual.
+ * lower_bound() first narrows an interval down to a single block by binary search over the first key of each block,
+ * which is stored in the block header, and then performs branchless binary search on the decoded keys of that block.
+ *
+ * @tparam Key the type of the keys, must be unsigned and at most 64 bits wide
+ * @tparam Allocator the allocator of block headers and residuals, rebound to their types
+ */
+template<typename Key, typename Allocator = std::allocator<Key>>
+class PackedKeys
+{
+    static_assert(std::is_unsigned<Key>::value and sizeof(Key) <= sizeof(uint64_t), "keys must be unsigned integers");
+
+    public:
+    using key_type = Key;
+
+    static constexpr std::size_t block_size = 64; ///< The number of keys per block.
+
+    private:
+    /**
+     * Header of a block.
+     */
+    struct Block {
+        key_type first;       ///< The first key of the block.
+        uint64_t base;        ///< The value of the linear function at the first position, plus the minimal residual.
+        uint64_t step;        ///< The slope of the linear function.
+        uint64_t offset : 56; ///< The first word of the residuals.
+        uint64_t width : 8;   ///< The bit width of the residuals.
+    };
+
+    using block_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<Block>;
+    using word_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<uint64_t>;
+
+    std::size_t n_keys_ = 0;                             ///< The number of keys.
+    std::vector<Block, block_allocator_type> blocks_;    ///< The header of each block.
+    std::vector<uint64_t, word_allocator_type> words_;   ///< The bit-packed residuals, followed by two padding words.
+
+    public:
+    /**
+     * Default constructor.
+     */
+    PackedKeys() = default;
+
+    /**
+     * Encodes the sorted keys [@p first, @p first + @p n_keys).
+     * @param first pointer to the first of the sorted keys
+     * @param n_keys the number of keys
+     * @param alloc allocator of block headers and residuals
+     */
+    PackedKeys(const key_type *first, const std::size_t n_keys, const Allocator &alloc = Allocator())
+        : n_keys_(n_keys)
+        , blocks_(alloc)
+        , words_(alloc)
+    {
+        const std::size_t n_blocks = (n_keys_ + block_size - 1) / block_size;
+        blocks_.reserve(n_blocks);
+
+        // Encode the block headers.
+        uint64_t residuals[block_size];
+        std::size_t n_words = 0;
+        for (std::size_t b = 0; b != n_blocks; ++b) {
+            const key_type *keys = first + b * block_size;
+            const std::size_t n = std::min(block_size, n_keys_ - b * block_size);
+
+            // Choose the step, i.e. the mean gap or zero, that minimizes the width of the residuals.
+            uint64_t steps[2] = { 0, n > 1 ? (uint64_t(keys[n - 1]) - keys[0]) / (n - 1) : 0 };
+            Block block{keys[0], 0, 0, n_words, 65};
+            for (uint64_t step : steps) {
+                // Residuals are computed modulo 2^64 and shifted so that the smallest one, read as signed, is zero.
+                int64_t min_r = 0;
+                for (std::size_t j = 0; j != n; ++j) {
+                    residuals[j] = uint64_t(keys[j]) - uint64_t(keys[0]) - j * step;
+                    min_r = std::min(min_r, static_cast<int64_t>(residuals[j]));
+                }
+                uint64_t max_u = 0;
+                for (std::size_t j = 0; j != n; ++j) max_u = std::max(max_u, residuals[j] - uint64_t(min_r));
+                uint64_t width = bit_width<uint64_t>(max_u);
+                if (width < block.width) {
+                    block.base = uint64_t(keys[0]) + uint64_t(min_r);
+                    block.step = step;
+                    block.width = width;
+                }
+            }
+
+            n_words += block.width;
+            blocks_.push_back(block);
+        }
+
+        // Pack the residuals.
+        words_.assign(n_words + 2, 0); // decoding reads two words, even for residuals of width zero
+        for (std::size_t b = 0; b != n_blocks; ++b) {
+            const key_type *keys = first + b * block_size;
+            const std::size_t n = std::min(block_size, n_keys_ - b * block_size);
+            const Block &block = blocks_[b];
+            for (std::size_t j = 0; j != n and block.width != 0; ++j) {
+                uint64_t u = uint64_t(keys[j]) - block.base - j * block.step;
+                std::size_t bit = j * block.width;
+                std::size_t word = block.offset + bit / 64;
+                std::size_t shift = bit % 64;
+                words_[word] |= u << shift;
+                if (shift != 0 and shift + block.width > 64) words_[word + 1] |= u >> (64 - shift);
+            }
+        }
+    }
+
+    /**
+     * Returns the key at position @p i.
+     * @param i the position
+     * @return the key at position @p i
+     */
+    key_type operator[](const std::size_t i) const { return decode(blocks_[i / block_size], i % block_size); }
+
+    /**
+     * Returns the position of the first key in the interval [@p lo, @p hi) that is not less than @p value.
+     * @param lo, hi the interval of positions to examine
+     * @param value value to compare the keys to
+     * @return position of the first key in [@p lo, @p hi) that is not less than @p value, or @p hi if there is none
+     */
+    std::size_t lower_bound(const std::size_t lo, const std::size_t hi, const key_type &value) const {
+        if (lo >= hi) return lo;
+
+        // Find the last block whose first key is less than value, or the first block of the interval.
+        std::size_t l = lo / block_size;
+        std::size_t n = (hi - 1) / block_size - l + 1;
+        while (n > 1) {
+            std::size_t half = n / 2;
+            l = blocks_[l + half].first < value ? l + half : l;
+            n -= half;
+        }
+
+        // Search the keys of the block within the interval.
+        const Block &block = blocks_[l];
+        std::size_t first = std::max(lo, l * block_size) - l * block_size;
+        n = std::min(hi, (l + 1) * block_size) - l * block_size - first;
+        while (n > 1) {
+            std::size_t half = n / 2;
+            first = decode(block, first + half) < value ? first + half : first;
+            n -= half;
+        }
+        return l * block_size + first + (decode(block, first) < value);
+    }
+
+    /**
+     * Returns the number of keys.
+     * @return number of keys
+     */
+    std::size_t size() const { return n_keys_; }
+
+    /**
+     * Returns the size of the encoded keys in bytes.
+     * @return size of the encoded keys in bytes
+     */
+    std::size_t size_in_bytes() const { return blocks_.size() * sizeof(Block) + words_.size() * sizeof(uint64_t); }
+
+    private:
+    /**
+     * Decodes key @p j of @p block.
+     * @param block the block
+     * @param j the position within the block
+     * @return the key
+     */
+    key_type decode(const Block &block, const std::size_t j) const {
+        const uint64_t width = block.width;
+        std::size_t bit = j * width;
+        const uint64_t *w = words_.data() + block.offset + bit / 64;
+        std::size_t shift = bit % 64;
+        uint64_t u = (w[0] >> shift) | ((w[1] << 1) << (63 - shift)); // second part is 0 if shift is 0
+        uint64_t mask = width == 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+        return static_cast<key_type>(block.base + j * block.step + (u & mask));
+    }
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+
+/**
+ * Counts a hardware event of the calling thread via `perf_event_open`. Counting is not available on systems that do
+ * not expose the event, e.g. virtual machines without PMU access, or that forbid access via
+ * `/proc/sys/kernel/perf_event_paranoid`. In that case, the counter reports -1.
+ */
+class PerfCounter
+{
+    int fd_; ///< The file descriptor of the perf event, negative if counting is not available.
+
+    public:
+    /**
+     * Opens a counter for the event @p config of type @p type, see `man perf_event_open`.
+     * @param type the type of the event, e.g. PERF_TYPE_HW_CACHE
+     * @param config the event of the given type
+     */
+    PerfCounter(const uint32_t type, const uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+
+    PerfCounter(const PerfCounter&) = delete;
+    PerfCounter &operator=(const PerfCounter&) = delete;
+
+    ~PerfCounter() { if (fd_ >= 0) close(fd_); }
+
+    /**
+     * Returns a counter of data TLB misses on loads.
+     * @return counter of data TLB load misses
+     */
+    static PerfCounter dtlb_load_misses() {
+        return PerfCounter(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB
+                                               | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                                               | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    }
+
+    /**
+     * Returns whether the event can be counted.
+     * @return whether the event can be counted
+     */
+    bool available() const { return fd_ >= 0; }
+
+    /**
+     * Resets the counter and starts counting.
+     */
+    void start() {
+        if (not available()) return;
+        ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+    }
+
+    /**
+     * Stops counting and returns the number of events since start().
+     * @return number of events, or -1 if counting is not available
+     */
+    int64_t stop() {
+        if (not available()) return -1;
+        ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        int64_t count;
+        if (read(fd_, &count, sizeof(count)) != sizeof(count)) return -1;
+        return count;
+    }
+};
@@ -1,8 +1,12 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
+#include <iterator>
 #include <vector>
 
+#include "rmi/util/fn.hpp"
+
 
 /**
  * Functor for performing linear search.
@@ -18,7 +22,7 @@ struct LinearSearch {
      * @return iterator to the first element that is not less than @p value
      */
     template<typename InputIt, typename T>
-    InputIt operator()(InputIt first, InputIt last, InputIt /* pred */, const T &value) {
+    InputIt operator()(InputIt first, InputIt last, InputIt /* pred */, const T &value) const {
         InputIt runner = first;
         for (; runner != last; ++runner)
             if (*runner >= value) return runner;
@@ -42,7 +46,7 @@ struct ModelBiasedLinearSearch {
      * @return iterator to the first element that is not less than @p value
      */
     template<typename InputIt, typename T>
-    InputIt operator()(InputIt first, InputIt last, InputIt pred, const T &value) {
+    InputIt operator()(InputIt first, InputIt last, InputIt pred, const T &value) const {
         InputIt runner = pred;
         if (*runner < value) {
             for (; runner < last; ++runner) // search right side
@@ -71,7 +75,7 @@ struct BinarySearch {
      * @return iterator to the first element that is not less than @p value
      */
     template<typename InputIt, typename T>
-    InputIt operator()(InputIt first, InputIt last, InputIt /* pred */, const T &value) {
+    InputIt operator()(InputIt first, InputIt last, InputIt /* pred */, const T &value) const {
         return std::lower_bound(first, last, value);
     }
 };
@@ -92,7 +96,7 @@ struct ModelBiasedBinarySearch {
      * @return iterator to the first element that is not less than @p value
      */
     template<typename InputIt, typename T>
-    InputIt operator()(InputIt first, InputIt last, InputIt pred, const T &value) {
+    InputIt operator()(InputIt first, InputIt last, InputIt pred, const T &value) const {
         if (*pred < value) return std::lower_bound(pred, last, value); // search right side
         else return std::lower_bound(first, pred, value); // search left side
     }
@@ -114,7 +118,7 @@ struct ExponentialSearch {
      * @return iterator to the first element that is not less than @p value
      */
     template<typename InputIt, typename T>
-    InputIt operator()(InputIt first, InputIt last, InputIt /* pred */, const T &value) {
+    InputIt operator()(InputIt first, InputIt last, InputIt /* pred */, const T &value) const {
         if (*first >= value) return first;
         std::size_t bound = 1;
         InputIt prev = first;
@@ -144,7 +148,7 @@ struct ModelBiasedExponentialSearch {
      * @return iterator to the first element that is not less than @p value
      */
     template<typename InputIt, typename T>
-    InputIt operator()(InputIt first, InputIt last, InputIt pred, const T &value) {
+    InputIt operator()(InputIt first, InputIt last, InputIt pred, const T &value) const {
         if (*pred < value) { // search right side
             std::size_t bound = 1;
             InputIt prev = pred;
@@ -168,3 +172,122 @@ struct ModelBiasedExponentialSearch {
         }
     }
 };
+
+
+/**
+ * Functor for searching the bounds of RmiExact. Intervals holding a single key are resolved with a single comparison
+ * and without branching on its result, all others are searched with @p Search.
+ *
+ * @tparam Search the functor used for searching intervals holding more than one key
+ */
+template<typename Search = BinarySearch>
+struct ExactSearch {
+    Search search; ///< The functor searching intervals holding more than one key.
+
+    /**
+     * Returns the first element in the interval [first,last) that is not less than @p value, or @p last if there is
+     * none.
+     * @tparam InputIt input iterator type
+     * @tparam T type of searched value
+     * @param first, last iterators defining the partially-ordered range to examine
+     * @param pred iterator to the predicted position
+     * @param value value to compare the elements to
+     * @return iterator to the first element that is not less than @p value
+     */
+    template<typename InputIt, typename T>
+    InputIt operator()(InputIt first, InputIt last, InputIt pred, const T &value) const {
+        if (std::distance(first, last) == 1) return first + (*first < value);
+        return search(first, last, pred, value);
+    }
+};
+
+
+/**
+ * Functor for performing linear search on whole cache lines.
+ *
+ * The interval is widened to the cache lines of the keys it overlaps, clipped to the keys. The keys of each line are
+ * compared to the searched value with a fixed number of aligned vector loads and the keys less than the value are
+ * counted without branching on the result. Intervals spanning more than `max_lines` lines are first narrowed down to a
+ * single line by binary search over the first key of each line. The functor keeps a pointer to the keys, which must
+ * outlive the functor.
+ *
+ * @tparam Key the type of the keys
+ */
+template<typename Key>
+class CacheLineSearch
+{
+    static constexpr std::ptrdiff_t line_keys = cache_line_size / sizeof(Key); ///< The number of keys per cache line.
+    static_assert(line_keys > 0 and cache_line_size % sizeof(Key) == 0, "keys must tile a cache line");
+
+    const Key *begin_;      ///< Pointer to the first key.
+    const Key *end_;        ///< Pointer past the last key.
+    std::size_t max_lines_; ///< Intervals spanning more lines are narrowed down by binary search.
+
+    /**
+     * Returns the address of the cache line @p p lies in.
+     */
+    static const Key *line_of(const Key *p) {
+        return reinterpret_cast<const Key*>(reinterpret_cast<uintptr_t>(p) & ~uintptr_t(cache_line_size - 1));
+    }
+
+    public:
+    /**
+     * Creates the functor for the sorted keys [@p first, @p first + @p n_keys).
+     * @param first pointer to the first of the sorted keys
+     * @param n_keys the number of keys
+     * @param max_lines intervals spanning more cache lines are narrowed down to one line by binary search first
+     */
+    CacheLineSearch(const Key *first, const std::size_t n_keys, const std::size_t max_lines = 8)
+        : begin_(first)
+        , end_(first + n_keys)
+        , max_lines_(max_lines) { }
+
+    /**
+     * Performs linear search on the cache lines overlapping the interval [first,last) to find the first element that
+     * is not less than @t value.
+     * @tparam InputIt input iterator type
+     * @tparam T type of searched value
+     * @param first, last iterators defining the interval of the keys to examine
+     * @param pred iterator to the predicted position (ignored)
+     * @param value value to compare the elements to
+     * @return iterator to the first element that is not less than @p value
+     */
+    template<typename InputIt, typename T>
+    InputIt operator()(InputIt first, InputIt last, InputIt /* pred */, const T &value) const {
+        if (first == last) return first;
+
+        // Widen the interval to whole cache lines and clip it to the keys, in positions relative to first.
+        const Key *ptr = &*first;
+        const std::ptrdiff_t base = line_of(ptr) - ptr; // position of the first line
+        std::ptrdiff_t min_line = 0;
+        std::ptrdiff_t max_line = (line_of(ptr + (std::distance(first, last) - 1)) - line_of(ptr)) / line_keys + 1;
+        const std::ptrdiff_t lo = std::max(base, begin_ - ptr);
+        const std::ptrdiff_t hi = std::min(base + max_line * line_keys, end_ - ptr);
+
+        // Narrow down to the last line whose first key is less than value.
+        if (max_line > std::ptrdiff_t(max_lines_)) {
+            std::ptrdiff_t l = 0, r = max_line;
+            while (r - l > 1) {
+                std::ptrdiff_t m = (l + r) / 2;
+                if (*(first + (base + m * line_keys)) < value) l = m;
+                else r = m;
+            }
+            min_line = l;
+            max_line = l + 1;
+        }
+
+        // Count the keys less than value, which precede all others.
+        std::ptrdiff_t pos = std::max(lo, base + min_line * line_keys);
+        for (std::ptrdiff_t line = min_line; line != max_line; ++line) {
+            std::ptrdiff_t line_begin = std::max(lo, base + line * line_keys);
+            std::ptrdiff_t line_end = std::min(hi, base + (line + 1) * line_keys);
+            if (line_end - line_begin == line_keys) { // whole line
+                auto it = first + line_begin;
+                for (std::ptrdiff_t i = 0; i != line_keys; ++i) pos += *(it + i) < value;
+            } else { // line clipped at the ends of the keys
+                for (auto i = line_begin; i != line_end; ++i) pos += *(first + i) < value;
+            }
+        }
+        return first + std::clamp<std::ptrdiff_t>(pos, 0, std::distance(first, last));
+    }
+};
@@ -0,0 +1,340 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "rmi/util/fn.hpp"
+
+
+/**
+ * Selects the value at a given rank among a stream of non-negative integral values in bounded memory by scanning the
+ * values repeatedly.
+ *
+ * A selection covers a range of values known to contain the value at the rank. Each scan counts the values within the
+ * range in at most 2^Bits equally sized buckets, after which narrow() restricts the range to the bucket containing the
+ * rank. A range of 2^k values is thus resolved in ceil(k / Bits) scans. Selections are obtained from
+ * StatsAccumulator::select(), which already narrows the range to the bit width of the value.
+ *
+ * Selections can be copied before a scan, filled independently, e.g., one per thread, and combined with merge().
+ *
+ * @tparam Numeric the type of the values
+ * @tparam Bits the number of bits resolved per scan
+ */
+template<typename Numeric, unsigned Bits = 16>
+class QuantileSelection
+{
+    static_assert(Bits > 0 and Bits < 64, "unsupported number of buckets");
+
+    using value_type = Numeric;
+
+    private:
+    uint64_t lo_;                      ///< The smallest value of the range.
+    uint8_t width_;                    ///< The range holds 2^width_ values.
+    uint8_t shift_;                    ///< Each bucket holds 2^shift_ values.
+    std::size_t rank_;                 ///< The rank of the selected value among the values within the range.
+    std::vector<std::size_t> counts_;  ///< The number of values per bucket of the current scan.
+
+    public:
+    /**
+     * Creates a selection of the value at @p rank among the values in the range [@p lo, @p lo + 2^@p width).
+     * @param lo the smallest value of the range
+     * @param width the logarithm of the size of the range
+     * @param rank the rank of the selected value among the values within the range
+     */
+    QuantileSelection(const uint64_t lo, const uint8_t width, const std::size_t rank)
+        : lo_(lo)
+        , width_(width)
+        , shift_(width > Bits ? width - Bits : 0)
+        , rank_(rank) { }
+
+    /**
+     * Returns whether the selected value is known, i.e. no further scan is required.
+     * @return whether the selected value is known
+     */
+    bool done() const { return width_ == 0; }
+
+    /**
+     * Returns the selected value.
+     * @return the selected value if done(), otherwise the smallest value of the range
+     */
+    value_type value() const { return static_cast<value_type>(lo_); }
+
+    /**
+     * Counts value @p v in the current scan if it lies within the range.
+     * @param v the value
+     */
+    void add(const value_type v) {
+        auto d = static_cast<uint64_t>(v) - lo_; // values below the range wrap around
+        if (done() or d >> width_ != 0) return;
+        if (counts_.empty()) counts_.resize(1UL << (width_ - shift_));
+        counts_[d >> shift_]++;
+    }
+
+    /**
+     * Merges the values counted by @p other in the current scan into this selection.
+     * @param other the selection to be merged, must cover the same range
+     */
+    void merge(const QuantileSelection &other) {
+        assert(lo_ == other.lo_ and width_ == other.width_);
+        if (other.counts_.empty()) return;
+        if (counts_.empty()) counts_.resize(other.counts_.size());
+        std::transform(counts_.begin(), counts_.end(), other.counts_.begin(), counts_.begin(),
+                       std::plus<std::size_t>());
+    }
+
+    /**
+     * Restricts the range to the bucket that contains the selected value after a complete scan.
+     */
+    void narrow() {
+        if (done()) return;
+        assert(not counts_.empty() and "narrowing requires a scan");
+        std::size_t seen = 0;
+        std::size_t bucket = 0;
+        while (seen + counts_[bucket] <= rank_) seen += counts_[bucket++];
+        lo_ += uint64_t(bucket) << shift_;
+        rank_ -= seen;
+        width_ = shift_;
+        shift_ = width_ > Bits ? width_ - Bits : 0;
+        counts_.clear();
+    }
+};
+
+
+/**
+ * Accumulates count, mean, and variance of a stream of values with Welford's algorithm. Moments are merged with Chan et
+ * al.'s parallel variant, hence results depend on the order in which moments are merged but not on the magnitude of the
+ * mean relative to the standard deviation.
+ */
+class Moments
+{
+    private:
+    std::size_t n_ = 0; ///< The number of values.
+    double mean_ = 0.0; ///< The running mean.
+    double m2_ = 0.0;   ///< The running sum of squared deviations from the mean.
+
+    public:
+    /**
+     * Adds value @p v to the moments.
+     * @param v the value
+     */
+    void add(const double v) {
+        ++n_;
+        double delta = v - mean_;
+        mean_ += delta / n_;
+        m2_ += delta * (v - mean_);
+    }
+
+    /**
+     * Merges the values accumulated by @p other into these moments.
+     * @param other the moments to be merged
+     */
+    void merge(const Moments &other) {
+        if (other.n_ == 0) return;
+        double n = n_ + other.n_;
+        double delta = other.mean_ - mean_;
+        mean_ += delta * other.n_ / n;
+        m2_ += other.m2_ + delta * delta * n_ * other.n_ / n;
+        n_ += other.n_;
+    }
+
+    /**
+     * Adds @p delta to all accumulated values.
+     * @param delta the offset
+     */
+    void shift(const double delta) { mean_ += delta; }
+
+    /**
+     * Returns the number of accumulated values.
+     * @return the number of values
+     */
+    std::size_t count() const { return n_; }
+
+    /**
+     * Returns the arithmetic mean of the accumulated values.
+     * @return arithmetic mean
+     */
+    double mean() const { return mean_; }
+
+    /**
+     * Returns the (population) standard deviation of the accumulated values.
+     * @return standard deviation
+     */
+    double stdev() const { return std::sqrt(m2_ / n_); }
+};
+
+
+/**
+ * Accumulates statistical properties of a stream of numeric values.
+ *
+ * Mean and standard deviation are computed with Welford's algorithm, see Moments. For integral values, we also keep an
+ * exact 128-bit sum so that their mean does not depend on the order in which values are added or accumulators are
+ * merged, and feed Welford's algorithm with their exact difference from the first value so that large values do not
+ * lose precision when converted to double. Quantiles of non-negative integral values are exact and take constant
+ * memory: values below 2^QuantileBits are counted in a dense array and larger values per bit width. A quantile that is
+ * a larger value is resolved by scanning the values again, see select() and QuantileSelection.
+ *
+ * Accumulators can be filled independently, e.g., one per thread, and combined with merge().
+ *
+ * @tparam Numeric the type of the values
+ * @tparam QuantileBits the number of bits of values counted in the dense array
+ */
+template<typename Numeric, unsigned QuantileBits = 16>
+class StatsAccumulator
+{
+    static_assert(QuantileBits < 64, "unsupported size of the dense array");
+
+    using value_type = Numeric;
+    __extension__ typedef __int128 int128_type;
+
+    static constexpr bool is_integral = std::is_integral<value_type>::value;
+    static constexpr std::size_t n_dense = 1UL << QuantileBits;  ///< Number of values counted in the dense array.
+
+    private:
+    std::size_t n_ = 0;                                            ///< The number of values.
+    value_type min_ = std::numeric_limits<value_type>::max();      ///< The minimum value.
+    value_type max_ = std::numeric_limits<value_type>::lowest();   ///< The maximum value.
+    Moments moments_;                                              ///< The running mean and variance.
+    int128_type sum_ = 0;                                          ///< The exact sum (integral values).
+    int128_type ref_ = 0;                                          ///< The first value (integral values).
+    std::vector<std::size_t> counts_;                              ///< The counts of small values (integral values).
+    std::array<std::size_t, 64> widths_{};                         ///< The counts of larger values per bit width - 1.
+
+    public:
+    /**
+     * Default constructor.
+     */
+    StatsAccumulator() = default;
+
+    /**
+     * Adds value @p v to the accumulator.
+     * @param v the value
+     */
+    void add(const value_type v) {
+        ++n_;
+        min_ = std::min(min_, v);
+        max_ = std::max(max_, v);
+        if constexpr (is_integral) {
+            if (n_ == 1) ref_ = v;
+            moments_.add(static_cast<double>(v - ref_));
+            sum_ += v;
+            assert(v >= 0 and "quantiles are only defined for non-negative values");
+            auto u = static_cast<uint64_t>(v);
+            if (u < n_dense) {
+                if (counts_.empty()) counts_.resize(n_dense);
+                counts_[u]++;
+            } else {
+                widths_[bit_width(u) - 1]++;
+            }
+        } else {
+            moments_.add(v);
+        }
+    }
+
+    /**
+     * Merges the values accumulated by @p other into this accumulator.
+     * @param other the accumulator to be merged
+     */
+    void merge(const StatsAccumulator &other) {
+        if (other.n_ == 0) return;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+        if constexpr (is_integral) {
+            if (n_ == 0) ref_ = other.ref_;
+            Moments moments = other.moments_;
+            moments.shift(static_cast<double>(other.ref_ - ref_));
+            moments_.merge(moments);
+            sum_ += other.sum_;
+            if (not other.counts_.empty()) {
+                if (counts_.empty()) counts_.resize(n_dense);
+                std::transform(counts_.begin(), counts_.end(), other.counts_.begin(), counts_.begin(),
+                               std::plus<std::size_t>());
+            }
+            std::transform(widths_.begin(), widths_.end(), other.widths_.begin(), widths_.begin(),
+                           std::plus<std::size_t>());
+        } else {
+            moments_.merge(other.moments_);
+        }
+        n_ += other.n_;
+    }
+
+    /**
+     * Merges the values accumulated by @p other into this accumulator, taking over its storage if this accumulator has
+     * none yet.
+     * @param other the accumulator to be merged, left in a valid but unspecified state
+     */
+    void merge(StatsAccumulator &&other) {
+        if (counts_.empty()) counts_.swap(other.counts_);
+        merge(static_cast<const StatsAccumulator&>(other));
+    }
+
+    /**
+     * Returns the number of accumulated values.
+     * @return the number of values
+     */
+    std::size_t count() const { return n_; }
+
+    /**
+     * Returns the arithmetic mean of the accumulated values.
+     * @return arithmetic mean
+     */
+    double mean() const {
+        if constexpr (is_integral) return static_cast<double>(sum_) / n_;
+        else return moments_.mean();
+    }
+
+    /**
+     * Returns the (population) standard deviation of the accumulated values.
+     * @return standard deviation
+     */
+    double stdev() const { return moments_.stdev(); }
+
+    /**
+     * Returns the minimum of the accumulated values.
+     * @return minimum
+     */
+    value_type min() const { return min_; }
+
+    /**
+     * Returns the maximum of the accumulated values.
+     * @return maximum
+     */
+    value_type max() const { return max_; }
+
+    /**
+     * Returns a selection of the @p q-quantile of the accumulated values, i.e., the value at rank floor(@p q * count())
+     * in sorted order. The selection is done() if the quantile is less than 2^QuantileBits or the maximum. Otherwise,
+     * all values must be scanned again until it is done(), for example:
+     *
+     *     auto median = accumulator.select(0.5);
+     *     while (not median.done()) {
+     *         for (auto v : values) median.add(v);
+     *         median.narrow();
+     *     }
+     *
+     * @param q the quantile in [0, 1]
+     * @return selection of the q-quantile
+     */
+    QuantileSelection<value_type, QuantileBits> select(const double q) const {
+        static_assert(is_integral, "quantiles are only supported for integral types");
+        if (n_ == 0) return {0, 0, 0};
+        std::size_t rank = std::min<std::size_t>(q * n_, n_ - 1);
+        std::size_t seen = 0;
+        for (std::size_t v = 0; v != counts_.size(); ++v) {
+            seen += counts_[v];
+            if (seen > rank) return {v, 0, 0};
+        }
+        if (rank == n_ - 1) return {static_cast<uint64_t>(max_), 0, 0};
+
+        // Values of bit width w + 1 lie in [2^w, 2^(w + 1)).
+        uint8_t w = 0;
+        while (seen + widths_[w] <= rank) seen += widths_[w++];
+        return {uint64_t(1) << w, w, rank - seen};
+    }
+};
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "rmi/util/fn.hpp"
+
+
+/**
+ * Static implicit B-tree (S-tree) of cache-line-sized nodes over a sample of sorted keys, used as an auxiliary layout
+ * for searching large intervals of the keys.
+ *
+ * Every `stride`-th key is sampled into the leaf level, which is grouped into nodes of
+ * `B = cache_line_size / sizeof(Key)` samples. Each level above holds the first entry of every node of the level below.
+ * Levels are padded with the largest key so that each node fills exactly one cache line and is searched by counting
+ * its entries that are less than the searched value. An interval [lo, hi) of the keys is searched by descending from
+ * the lowest node whose subtree covers the samples enclosing the interval and finishing with counting the at most
+ * `stride - 1` keys between two consecutive samples that are less than the searched value. Compared to binary search
+ * over the interval, which loads a new cache line at every step until less than a cache line remains, each level costs
+ * one cache line and the upper levels are shared among all intervals.
+ *
+ * The stride is the smallest one for which the tree takes at most a given fraction of the size of the keys. The tree
+ * keeps a pointer to the keys, which must outlive the tree and must not be modified.
+ *
+ * @tparam Key the type of the keys
+ */
+template<typename Key>
+class STree
+{
+    static_assert(sizeof(Key) <= cache_line_size, "keys must fit in a cache line");
+
+    public:
+    using key_type = Key;
+
+    static constexpr std::size_t node_size = cache_line_size / sizeof(key_type); ///< The number of entries per node.
+
+    private:
+    const key_type *keys_ = nullptr;    ///< The sorted keys.
+    std::size_t n_keys_ = 0;            ///< The number of keys.
+    std::size_t stride_ = 1;            ///< The distance between two sampled keys.
+    std::size_t min_window_ = 0;        ///< Intervals of at most this many keys are searched directly.
+    std::vector<key_type> data_;        ///< The memory holding all levels.
+    key_type *nodes_ = nullptr;         ///< The cache-line aligned start of the levels within data_.
+    std::vector<std::size_t> offsets_;  ///< The offset of each level in nodes_, leaf level first.
+
+    /**
+     * Returns the base-2 logarithm of @p x, which must be a power of two.
+     */
+    static constexpr unsigned log2(std::size_t x) {
+        unsigned l = 0;
+        while (x >>= 1) ++l;
+        return l;
+    }
+
+    static constexpr unsigned log_node_size = log2(node_size); ///< Shift that divides by node_size.
+    static_assert((std::size_t(1) << log_node_size) == node_size, "node size must be a power of two");
+
+    public:
+    /**
+     * Default constructor.
+     */
+    STree() = default;
+
+    /**
+     * Builds an S-tree over the sorted keys [@p first, @p first + @p n_keys) that takes at most @p overhead times the
+     * size of the keys.
+     * @param first pointer to the first of the sorted keys
+     * @param n_keys the number of keys
+     * @param overhead the size of the tree as fraction of the size of the keys, must be positive
+     * @param min_window intervals of at most this many keys are searched with binary search on the keys only
+     */
+    STree(const key_type *first, const std::size_t n_keys, const double overhead = 0.125,
+          const std::size_t min_window = 256)
+        : keys_(first)
+        , n_keys_(n_keys)
+        , min_window_(min_window)
+    {
+        if (n_keys_ == 0) return;
+
+        // A leaf level of m samples takes about m * B / (B - 1) entries in total.
+        double stride = node_size / ((node_size - 1) * overhead);
+        stride_ = std::max<std::size_t>(1, std::ceil(stride));
+
+        // Determine the size of each level.
+        std::vector<std::size_t> sizes;
+        sizes.push_back((n_keys_ + stride_ - 1) / stride_);
+        while (sizes.back() > node_size) sizes.push_back((sizes.back() + node_size - 1) / node_size);
+
+        std::size_t total = 0;
+        for (auto size : sizes) {
+            offsets_.push_back(total);
+            total += (size + node_size - 1) / node_size * node_size;
+        }
+
+        // Allocate levels padded with the largest key, aligned to a cache line.
+        data_.assign(total + node_size - 1, std::numeric_limits<key_type>::max());
+        auto aligned = (reinterpret_cast<uintptr_t>(data_.data()) + cache_line_size - 1)
+                       & ~uintptr_t(cache_line_size - 1);
+        nodes_ = reinterpret_cast<key_type*>(aligned);
+
+        // Fill leaf level with samples, and each level above with the first entry of each node below.
+        for (std::size_t i = 0; i != sizes[0]; ++i) nodes_[i] = keys_[i * stride_];
+        for (std::size_t l = 1; l != sizes.size(); ++l) {
+            for (std::size_t i = 0; i != sizes[l]; ++i)
+                nodes_[offsets_[l] + i] = nodes_[offsets_[l - 1] + i * node_size];
+        }
+    }
+
+    STree(const STree&) = delete;
+    STree &operator=(const STree&) = delete;
+
+    /**
+     * Returns the position of the first key in the interval [@p lo, @p hi) that is not less than @p value.
+     * @param lo, hi the interval of positions to examine
+     * @param value value to compare the keys to
+     * @return position of the first key in [@p lo, @p hi) that is not less than @p value, or @p hi if there is none
+     */
+    std::size_t lower_bound(const std::size_t lo, const std::size_t hi, const key_type &value) const {
+        if (hi - lo <= min_window_ or offsets_.empty())
+            return std::distance(keys_, std::lower_bound(keys_ + lo, keys_ + hi, value));
+
+        // Find the lowest node whose subtree covers the samples at or before lo up to the sample at or after hi.
+        const std::size_t first_sample = lo / stride_;
+        const std::size_t last_sample = (hi - 1) / stride_;
+        const std::size_t height = offsets_.size();
+        std::size_t level = 0;
+        std::size_t node = first_sample >> log_node_size;
+        while (level + 1 < height and node != (last_sample >> (log_node_size * (level + 1)))) {
+            ++level;
+            node = first_sample >> (log_node_size * (level + 1));
+        }
+
+        // Descend to the first sample that is not less than value.
+        std::size_t sample;
+        for (;;) {
+            const key_type *entries = nodes_ + offsets_[level] + node * node_size;
+            std::size_t count = 0;
+            for (std::size_t i = 0; i != node_size; ++i) count += entries[i] < value;
+            std::size_t idx = node * node_size + count;
+            if (level == 0) {
+                sample = idx;
+                break;
+            }
+            node = idx - (count != 0); // the child whose first entry is the last one less than value
+            --level;
+        }
+
+        // Count the keys between the previous sample and this one that are less than value.
+        std::size_t first = sample == 0 ? 0 : (sample - 1) * stride_ + 1;
+        std::size_t last = std::min(sample * stride_, n_keys_);
+        std::size_t pos = first;
+        for (std::size_t i = first; i < last; ++i) pos += keys_[i] < value;
+        return std::clamp(pos, lo, hi);
+    }
+
+    /**
+     * Returns a pointer to the first of the keys the tree was built on.
+     * @return pointer to the first key
+     */
+    const key_type *keys() const { return keys_; }
+
+    /**
+     * Returns the distance between two sampled keys.
+     * @return the stride
+     */
+    std::size_t stride() const { return stride_; }
+
+    /**
+     * Returns the number of levels.
+     * @return the height of the tree
+     */
+    std::size_t height() const { return offsets_.size(); }
+
+    /**
+     * Returns the size of the tree in bytes.
+     * @return size of the tree in bytes
+     */
+    std::size_t size_in_bytes() const {
+        return data_.size() * sizeof(key_type) + offsets_.size() * sizeof(std::size_t);
+    }
+};
+
+
+/**
+ * Functor for performing search on an S-tree over the keys.
+ *
+ * @tparam Key the type of the keys
+ */
+template<typename Key>
+class STreeSearch
+{
+    std::shared_ptr<const STree<Key>> tree_; ///< The S-tree over the keys.
+
+    public:
+    /**
+     * Builds an S-tree over the sorted keys [@p first, @p first + @p n_keys). See STree.
+     * @param first pointer to the first of the sorted keys
+     * @param n_keys the number of keys
+     * @param overhead the size of the tree as fraction of the size of the keys, must be positive
+     * @param min_window intervals of at most this many keys are searched with binary search on the keys only
+     */
+    STreeSearch(const Key *first, const std::size_t n_keys, const double overhead = 0.125,
+                const std::size_t min_window = 256)
+        : tree_(std::make_shared<const STree<Key>>(first, n_keys, overhead, min_window)) { }
+
+    /**
+     * Searches the interval [first,last) of the keys the S-tree was built on to find the first element that is not
+     * less than @t value.
+     * @tparam InputIt input iterator type
+     * @tparam T type of searched value
+     * @param first, last iterators defining the interval of the keys to examine
+     * @param pred iterator to the predicted position (ignored)
+     * @param value value to compare the elements to
+     * @return iterator to the first element that is not less than @p value
+     */
+    template<typename InputIt, typename T>
+    InputIt operator()(InputIt first, InputIt last, InputIt /* pred */, const T &value) const {
+        if (first == last) return first;
+        std::size_t lo = &*first - tree_->keys();
+        std::size_t hi = lo + std::distance(first, last);
+        return first + (tree_->lower_bound(lo, hi, value) - lo);
+    }
+
+    /**
+     * Returns the S-tree over the keys.
+     * @return the S-tree
+     */
+    const STree<Key> &tree() const { return *tree_; }
+};
@@ -0,0 +1,407 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+/**
+ * Samples integers in [1, n] following a Zipf distribution with exponent @p s using rejection-inversion sampling by
+ * Hörmann and Derflinger (https://dl.acm.org/doi/10.1145/235025.235029). Setup and sampling take constant time and
+ * memory regardless of n.
+ */
+class ZipfDistribution
+{
+    private:
+    double n_;                 ///< The number of elements.
+    double s_;                 ///< The exponent.
+    double h_integral_x1_;     ///< H(1.5) - 1.
+    double h_integral_n_;      ///< H(n + 0.5).
+    double threshold_;         ///< The squeeze threshold.
+
+    public:
+    /**
+     * Creates a Zipf distribution over [1, @p n] with exponent @p s.
+     * @param n the number of elements
+     * @param s the exponent
+     */
+    ZipfDistribution(const std::size_t n, const double s) : n_(n), s_(s) {
+        h_integral_x1_ = h_integral(1.5) - 1.0;
+        h_integral_n_ = h_integral(n_ + 0.5);
+        threshold_ = 2.0 - h_integral_inv(h_integral(2.5) - h(2.0));
+    }
+
+    /**
+     * Draws a sample.
+     * @param gen uniform random bit generator
+     * @return integer in [1, n]
+     */
+    template<typename Generator>
+    std::size_t operator()(Generator &gen) const {
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        while (true) {
+            double u = h_integral_n_ + unit(gen) * (h_integral_x1_ - h_integral_n_);
+            double x = h_integral_inv(u);
+            double k = std::clamp(std::floor(x + 0.5), 1.0, n_);
+            if (k - x <= threshold_ or u >= h_integral(k + 0.5) - h(k))
+                return static_cast<std::size_t>(k);
+        }
+    }
+
+    private:
+    /**
+     * Returns the unnormalized density h(x) = x^-s.
+     */
+    double h(const double x) const { return std::exp(-s_ * std::log(x)); }
+
+    /**
+     * Returns H(x), an antiderivative of h.
+     */
+    double h_integral(const double x) const {
+        double log_x = std::log(x);
+        return helper2((1.0 - s_) * log_x) * log_x;
+    }
+
+    /**
+     * Returns the inverse of H.
+     */
+    double h_integral_inv(const double x) const {
+        double t = std::max(-1.0, x * (1.0 - s_));
+        return std::exp(helper1(t) * x);
+    }
+
+    /**
+     * Returns log(1 + x) / x, which is numerically stable for x close to 0.
+     */
+    static double helper1(const double x) { return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1.0 - x * (0.5 - x / 3.0); }
+
+    /**
+     * Returns (exp(x) - 1) / x, which is numerically stable for x close to 0.
+     */
+    static double helper2(const double x) { return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1.0 + x * (0.5 + x / 6.0); }
+};
+
+
+/**
+ * Returns the smallest key greater than @p key.
+ * @tparam Key the type of the key
+ * @param key the key
+ * @return the successor of the key
+ */
+template<typename Key>
+Key next_key(const Key key)
+{
+    if constexpr (std::is_floating_point_v<Key>) return std::nextafter(key, std::numeric_limits<Key>::infinity());
+    else return key + 1;
+}
+
+/**
+ * Returns the largest key less than @p key.
+ * @tparam Key the type of the key
+ * @param key the key
+ * @return the predecessor of the key
+ */
+template<typename Key>
+Key prev_key(const Key key)
+{
+    if constexpr (std::is_floating_point_v<Key>) return std::nextafter(key, -std::numeric_limits<Key>::infinity());
+    else return key - 1;
+}
+
+/**
+ * Draws a key uniformly at random from the closed interval [@p lo, @p hi].
+ * @tparam Key the type of the key
+ * @tparam Generator the type of the uniform random bit generator
+ * @param lo, hi bounds of the interval
+ * @param gen uniform random bit generator
+ * @return key in [lo, hi]
+ */
+template<typename Key, typename Generator>
+Key uniform_key(const Key lo, const Key hi, Generator &gen)
+{
+    if constexpr (std::is_floating_point_v<Key>) {
+        std::uniform_real_distribution<Key> distrib(lo, hi);
+        return std::clamp(distrib(gen), lo, hi);
+    } else {
+        std::uniform_int_distribution<Key> distrib(lo, hi);
+        return distrib(gen);
+    }
+}
+
+
+/*======================================================================================================================
+ * Point Lookup Workloads
+ *====================================================================================================================*/
+
+/**
+ * Samples @p n_samples lookup keys uniformly at random from @p keys.
+ * @tparam Key the type of the key
+ * @param keys sorted keys to sample from
+ * @param n_samples number of lookup keys
+ * @param seed seed of the random number generator
+ * @return vector of lookup keys
+ */
+template<typename Key>
+std::vector<Key> uniform_workload(const std::vector<Key> &keys, const std::size_t n_samples, const uint64_t seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<std::size_t> distrib(0, keys.size() - 1);
+    std::vector<Key> samples;
+    samples.reserve(n_samples);
+    for (std::size_t i = 0; i != n_samples; ++i)
+        samples.push_back(keys[distrib(gen)]);
+    return samples;
+}
+
+/**
+ * Samples @p n_samples lookup keys from @p keys such that the positions follow a Zipf distribution with exponent @p s.
+ * Popular positions are scattered across the key array by a fixed permutation of the ranks.
+ * @tparam Key the type of the key
+ * @param keys sorted keys to sample from
+ * @param n_samples number of lookup keys
+ * @param seed seed of the random number generator
+ * @param s exponent of the Zipf distribution
+ * @return vector of lookup keys
+ */
+template<typename Key>
+std::vector<Key> zipf_workload(const std::vector<Key> &keys, const std::size_t n_samples, const uint64_t seed,
+                               const double s = 0.99)
+{
+    __extension__ typedef unsigned __int128 uint128_type;
+
+    std::size_t n_keys = keys.size();
+    std::mt19937 gen(seed);
+    ZipfDistribution distrib(n_keys, s);
+
+    // Permute ranks by p(r) = (a * r + b) mod n which is a bijection if a and n are coprime.
+    std::size_t a = 0x9e3779b97f4a7c15UL % n_keys;
+    while (std::gcd(a, n_keys) != 1) ++a;
+    std::size_t b = gen() % n_keys;
+
+    std::vector<Key> samples;
+    samples.reserve(n_samples);
+    for (std::size_t i = 0; i != n_samples; ++i) {
+        std::size_t rank = distrib(gen) - 1;
+        samples.push_back(keys[(static_cast<uint128_type>(a) * rank + b) % n_keys]);
+    }
+    return samples;
+}
+
+/**
+ * Samples @p n_samples lookup keys from @p keys such that a fraction @p hot_lookups of lookups target a hot set of
+ * randomly chosen keys that make up a fraction @p hot_keys of all keys. The remaining lookups are uniform.
+ * @tparam Key the type of the key
+ * @param keys sorted keys to sample from
+ * @param n_samples number of lookup keys
+ * @param seed seed of the random number generator
+ * @param hot_lookups fraction of lookups that target the hot set
+ * @param hot_keys fraction of keys in the hot set
+ * @return vector of lookup keys
+ */
+template<typename Key>
+std::vector<Key> hotset_workload(const std::vector<Key> &keys, const std::size_t n_samples, const uint64_t seed,
+                                 const double hot_lookups = 0.9, const double hot_keys = 0.01)
+{
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<std::size_t> distrib(0, keys.size() - 1);
+
+    // Choose hot set.
+    std::size_t n_hot = std::max<std::size_t>(1, keys.size() * hot_keys);
+    std::vector<Key> hot;
+    hot.reserve(n_hot);
+    for (std::size_t i = 0; i != n_hot; ++i)
+        hot.push_back(keys[distrib(gen)]);
+
+    std::bernoulli_distribution is_hot(hot_lookups);
+    std::uniform_int_distribution<std::size_t> hot_distrib(0, n_hot - 1);
+    std::vector<Key> samples;
+    samples.reserve(n_samples);
+    for (std::size_t i = 0; i != n_samples; ++i)
+        samples.push_back(is_hot(gen) ? hot[hot_distrib(gen)] : keys[distrib(gen)]);
+    return samples;
+}
+
+/**
+ * Samples @p n_samples lookup keys that are absent from @p keys but lie between two of its keys.
+ * @tparam Key the type of the key
+ * @param keys sorted keys to sample from
+ * @param n_samples number of lookup keys
+ * @param seed seed of the random number generator
+ * @return vector of lookup keys
+ */
+template<typename Key>
+std::vector<Key> absent_workload(const std::vector<Key> &keys, const std::size_t n_samples, const uint64_t seed)
+{
+    std::mt19937 gen(seed);
+
+    // Collect gaps between consecutive keys. Repeated keys are skipped first since the maximum key has no successor.
+    std::vector<std::size_t> gaps;
+    for (std::size_t i = 0; i + 1 < keys.size(); ++i)
+        if (keys[i] < keys[i + 1] and next_key(keys[i]) < keys[i + 1]) gaps.push_back(i);
+    if (gaps.empty()) {
+        std::cerr << "Keys are dense, cannot sample absent keys." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    std::uniform_int_distribution<std::size_t> distrib(0, gaps.size() - 1);
+    std::vector<Key> samples;
+    samples.reserve(n_samples);
+    for (std::size_t i = 0; i != n_samples; ++i) {
+        std::size_t pos = gaps[distrib(gen)];
+        samples.push_back(uniform_key(next_key(keys[pos]), prev_key(keys[pos + 1]), gen));
+    }
+    return samples;
+}
+
+/**
+ * Samples @p n_samples lookup keys that are smaller than the smallest or larger than the largest key in @p keys.
+ * Integral keys are drawn from the whole domain. Floating-point keys are drawn from intervals as wide as the key range
+ * next to it since the whole domain would be dominated by huge magnitudes.
+ * @tparam Key the type of the key
+ * @param keys sorted keys to sample from
+ * @param n_samples number of lookup keys
+ * @param seed seed of the random number generator
+ * @return vector of lookup keys
+ */
+template<typename Key>
+std::vector<Key> out_of_range_workload(const std::vector<Key> &keys, const std::size_t n_samples, const uint64_t seed)
+{
+    std::mt19937 gen(seed);
+    Key lowest = std::numeric_limits<Key>::lowest();
+    Key max = std::numeric_limits<Key>::max();
+    if constexpr (std::is_floating_point_v<Key>) {
+        Key width = std::max<Key>(keys.back() - keys.front(), 1);
+        lowest = std::max(lowest + width, keys.front()) - width;
+        max = std::min(max - width, keys.back()) + width;
+    }
+    bool has_below = keys.front() > lowest;
+    bool has_above = keys.back() < max;
+    if (not has_below and not has_above) {
+        std::cerr << "Keys span the whole domain, cannot sample out-of-range keys." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    std::bernoulli_distribution is_below(has_below and has_above ? 0.5 : has_below);
+    std::vector<Key> samples;
+    samples.reserve(n_samples);
+    for (std::size_t i = 0; i != n_samples; ++i) {
+        if (is_below(gen)) samples.push_back(uniform_key(lowest, prev_key(keys.front()), gen));
+        else samples.push_back(uniform_key(next_key(keys.back()), max, gen));
+    }
+    return samples;
+}
+
+/**
+ * Samples @p n_samples lookup keys uniformly at random from @p keys and sorts them in ascending order.
+ * @tparam Key the type of the key
+ * @param keys sorted keys to sample from
+ * @param n_samples number of lookup keys
+ * @param seed seed of the random number generator
+ * @return vector of lookup keys
+ */
+template<typename Key>
+std::vector<Key> sorted_workload(const std::vector<Key> &keys, const std::size_t n_samples, const uint64_t seed)
+{
+    auto samples = uniform_workload(keys, n_samples, seed);
+    std::sort(samples.begin(), samples.end());
+    return samples;
+}
+
+/**
+ * Samples @p n_samples lookup keys from @p keys in clusters: each cluster of @p cluster_size lookups targets random
+ * keys within a window of @p cluster_width consecutive keys starting at a uniformly chosen position.
+ * @tparam Key the type of the key
+ * @param keys sorted keys to sample from
+ * @param n_samples number of lookup keys
+ * @param seed seed of the random number generator
+ * @param cluster_size number of lookups per cluster
+ * @param cluster_width number of keys a cluster spans
+ * @return vector of lookup keys
+ */
+template<typename Key>
+std::vector<Key> clustered_workload(const std::vector<Key> &keys, const std::size_t n_samples, const uint64_t seed,
+                                    const std::size_t cluster_size = 32, const std::size_t cluster_width = 1024)
+{
+    std::mt19937 gen(seed);
+    std::size_t width = std::min(cluster_width, keys.size());
+    std::uniform_int_distribution<std::size_t> start_distrib(0, keys.size() - width);
+    std::uniform_int_distribution<std::size_t> offset_distrib(0, width - 1);
+
+    std::vector<Key> samples;
+    samples.reserve(n_samples);
+    std::size_t start = 0;
+    for (std::size_t i = 0; i != n_samples; ++i) {
+        if (i % cluster_size == 0) start = start_distrib(gen);
+        samples.push_back(keys[start + offset_distrib(gen)]);
+    }
+    return samples;
+}
+
+/**
+ * Generates @p n_samples lookup keys on @p keys according to the workload called @p workload, either uniform, zipf,
+ * hotset, absent, out_of_range, sorted, or clustered. Exits if the workload is unknown.
+ * @tparam Key the type of the key
+ * @param keys sorted keys to sample from
+ * @param workload name of the workload
+ * @param n_samples number of lookup keys
+ * @param seed seed of the random number generator
+ * @return vector of lookup keys
+ */
+template<typename Key>
+std::vector<Key> generate_workload(const std::vector<Key> &keys,
+                                   const std::string &workload,
+                                   const std::size_t n_samples,
+                                   const uint64_t seed)
+{
+    if (workload == "uniform") return uniform_workload(keys, n_samples, seed);
+    if (workload == "zipf") return zipf_workload(keys, n_samples, seed);
+    if (workload == "hotset") return hotset_workload(keys, n_samples, seed);
+    if (workload == "absent") return absent_workload(keys, n_samples, seed);
+    if (workload == "out_of_range") return out_of_range_workload(keys, n_samples, seed);
+    if (workload == "sorted") return sorted_workload(keys, n_samples, seed);
+    if (workload == "clustered") return clustered_workload(keys, n_samples, seed);
+    std::cerr << "Error: " << workload << " is not a valid workload." << std::endl;
+    exit(EXIT_FAILURE);
+}
+
+
+/*======================================================================================================================
+ * Range Lookup Workloads
+ *====================================================================================================================*/
+
+/**
+ * Samples @p n_samples range queries [lo, hi) on @p keys that each select a fraction @p selectivity of the keys. Lower
+ * bounds are drawn uniformly from @p keys.
+ * @tparam Key the type of the key
+ * @param keys sorted keys to sample from
+ * @param n_samples number of range queries
+ * @param selectivity fraction of keys selected by each query
+ * @param seed seed of the random number generator
+ * @return vector of lower and upper bounds
+ */
+template<typename Key>
+std::vector<std::pair<Key, Key>> range_workload(const std::vector<Key> &keys,
+                                                const std::size_t n_samples,
+                                                const double selectivity,
+                                                const uint64_t seed)
+{
+    std::mt19937 gen(seed);
+    std::size_t n_keys = keys.size();
+    std::size_t width = std::clamp<std::size_t>(std::llround(selectivity * n_keys), 1, n_keys - 1);
+    std::uniform_int_distribution<std::size_t> distrib(0, n_keys - 1 - width);
+
+    std::vector<std::pair<Key, Key>> samples;
+    samples.reserve(n_samples);
+    for (std::size_t i = 0; i != n_samples; ++i) {
+        std::size_t pos = distrib(gen);
+        samples.emplace_back(keys[pos], keys[pos + width]);
+    }
+    return samples;
+}
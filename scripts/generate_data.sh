@@ -0,0 +1,44 @@
+#!bash
+# set -x
+trap "exit" SIGINT
+
+DIR_DATA="data"
+
+BIN="build/bin/generate_data"
+
+# Set dataset size, duplicate ratio, and seed
+N_KEYS="200000000"
+DUPLICATES="0"
+SEED="42"
+
+DISTRIBUTIONS="uniform normal lognormal zipf_clustered piecewise_linear step timestamp"
+KEY_TYPES="uint32 uint64"
+
+generate() {
+    DISTRIBUTION=$1
+    KEY_TYPE=$2
+    DATASET="${DISTRIBUTION}_$((${N_KEYS} / 1000000))M_${KEY_TYPE}"
+    FILE_BIN="${DIR_DATA}/${DATASET}"
+    if [ -f ${FILE_BIN} ];
+    then
+        echo "File '${FILE_BIN}' already exists."
+        return 0
+    fi
+    echo "Generating '${DATASET}'..."
+    ${BIN} ${FILE_BIN} ${DISTRIBUTION} ${N_KEYS} --key_type ${KEY_TYPE} --duplicates ${DUPLICATES} --seed ${SEED}
+}
+
+# Create data directory
+if [ ! -d "${DIR_DATA}" ];
+then
+    mkdir -p "${DIR_DATA}";
+fi
+
+# Generate datasets
+for distribution in ${DISTRIBUTIONS};
+do
+    for key_type in ${KEY_TYPES};
+    do
+        generate ${distribution} ${key_type}
+    done
+done
@@ -219,6 +219,7 @@ if __name__ == "__main__":
     index_dict = {
         'RMI-ours': 'RMI (ours)',
         'RMI-ref': 'RMI (ref)',
+        'RMI-gen': 'RMI (gen)',
         'ALEX': 'ALEX',
         'PGM-index': 'PGM-index',
         'RadixSpline': 'RadixSpline',
@@ -240,7 +240,10 @@ if __name__ == "__main__":
         "cubic_spline": "CS",
         "linear_spline": "LS",
         "linear_regression": "LR",
-        "radix": "RX"
+        "radix": "RX",
+        "radix_table": "RT",
+        "pla": "PLA",
+        "auto": "Auto"
     }
     bounds_dict = {
         "labs": "LAbs",
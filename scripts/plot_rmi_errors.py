@@ -119,7 +119,13 @@ if __name__ == "__main__":
         "linear_regression": "LR",
         "linear_spline": "LS",
         "cubic_spline": "CS",
-        "radix": "RX"
+        "radix": "RX",
+        "radix_table": "RT",
+        "piecewise_cdf": "PCDF",
+        "normal": "N",
+        "lognormal": "LN",
+        "pla": "PLA",
+        "auto": "Auto"
     }
     df.replace({**dataset_dict, **model_dict}, inplace=True)
 
@@ -155,3 +161,9 @@ if __name__ == "__main__":
         filename = 'rmi_errors-max_absolute_error.pdf'
         print(f'Plotting max absolute error to \'{filename}\'...')
         plot('n_models', 'max_ae', '# of segments', 'Maximum absolute error', filename)
+
+        # Plot mean log2 error, which results of earlier runs lack
+        if 'mean_log2_ae' in df.columns:
+            filename = 'rmi_errors-mean_log2_error.pdf'
+            print(f'Plotting mean log2 error to \'{filename}\'...')
+            plot('n_models', 'mean_log2_ae', '# of segments', 'Mean log2 error', filename)
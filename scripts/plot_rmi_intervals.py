@@ -118,7 +118,8 @@ if __name__ == "__main__":
         "cubic_spline": "CS",
         "linear_spline": "LS",
         "linear_regression": "LR",
-        "radix": "RX"
+        "radix": "RX",
+        "radix_table": "RT"
     }
     bounds_dict = {
         "labs": "LAbs",
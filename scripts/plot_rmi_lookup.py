@@ -167,6 +167,53 @@ def plot_correction(filename='rmi_lookup-error_correction.pdf'):
     fig.savefig(os.path.join(path, filename), bbox_inches='tight')
 
 
+def plot_layouts(filename='rmi_lookup-layouts.pdf'):
+    configs = [('LAbs','Bin'),('NB','MExp')]
+    layout_configs = list(itertools.product(['aos','soa'], ['scalar','batched']))
+
+    n_rows = len(datasets)
+    n_cols = len(configs)
+
+    fig, axs = plt.subplots(n_rows, n_cols, figsize=(4*n_cols, 2.7*n_rows), sharey='row', sharex=True, squeeze=False)
+    fig.tight_layout()
+
+    cmap = cm.get_cmap('tab10')
+    for row, dataset in enumerate(datasets):
+        for col, (bound, search) in enumerate(configs):
+            ax = axs[row,col]
+            for i, (layout, mode) in enumerate(layout_configs):
+                data = layouts[
+                    (layouts['dataset']==dataset) &
+                    (layouts['layer1']=='LS') &
+                    (layouts['layer2']=='LR') &
+                    (layouts['bounds']==bound) &
+                    (layouts['search']==search) &
+                    (layouts['layout']==layout) &
+                    (layouts['lookup_mode']==mode)
+                ]
+                if not data.empty:
+                    ax.plot(data['size_in_MiB'], data['lookup_in_ns'], label=f'{layout.upper()} {mode}', c=cmap(i/10))
+
+            # Title
+            ax.set_title(f'{dataset} (LS$\mapsto$LR, {bound}+{search})')
+
+            # Labels
+            if col==0:
+                ax.set_ylabel('Lookup time [ns]')
+            if row==n_rows - 1:
+                ax.set_xlabel('Index size [MiB]')
+
+            # Visuals
+            ax.set_ylim(bottom=0)
+            ax.set_xscale('log')
+
+            # Legend
+            if row==0 and col==0:
+                fig.legend(ncol=len(layout_configs), bbox_to_anchor=(0.5, 1), loc='lower center', frameon=False)
+
+    fig.savefig(os.path.join(path, filename), bbox_inches='tight')
+
+
 if __name__ == "__main__":
     path = 'results'
 
@@ -174,8 +221,25 @@ if __name__ == "__main__":
     file = os.path.join(path, 'rmi_lookup.csv')
     df = pd.read_csv(file, delimiter=',', header=0, comment='#')
 
+    # Fill in defaults for columns that results of earlier runs lack
+    defaults = {
+        "page_size": "regular",
+        "numa": "none",
+        "layout": "aos",
+        "lookup_mode": "scalar",
+    }
+    for column, default in defaults.items():
+        if column not in df.columns:
+            df[column] = default
+
+    # Only consider runs on regular pages without NUMA policy, and scalar lookups on array-of-structs layer2 except for
+    # the layout comparison
+    df = df[(df['page_size'] == 'regular') & (df['numa'] == 'none')]
+    layouts = df.groupby(['dataset','layer1','layer2','n_models','bounds','search','layout','lookup_mode']).median(numeric_only=True).reset_index()
+    df = df[(df['layout'] == 'aos') & (df['lookup_mode'] == 'scalar')]
+
     # Compute median of lookup times
-    df = df.groupby(['dataset','layer1','layer2','n_models','bounds','search']).median().reset_index()
+    df = df.groupby(['dataset','layer1','layer2','n_models','bounds','search']).median(numeric_only=True).reset_index()
 
     # Replace datasets, model names, bounds, and searches
     dataset_dict = {
@@ -188,26 +252,39 @@ if __name__ == "__main__":
         "cubic_spline": "CS",
         "linear_spline": "LS",
         "linear_regression": "LR",
-        "radix": "RX"
+        "radix": "RX",
+        "radix_table": "RT",
+        "piecewise_cdf": "PCDF",
+        "normal": "N",
+        "lognormal": "LN",
+        "pla": "PLA",
+        "auto": "Auto"
     }
     bounds_dict = {
         "labs": "LAbs",
         "lind": "LInd",
         "gabs": "GAbs",
         "gind": "GInd",
+        "adaptive": "Adapt",
+        "exact": "Exact",
         "none": "NB"
     }
     search_dict = {
         "binary": "Bin",
         "model_biased_binary": "MBin",
         "model_biased_exponential": "MExp",
-        "model_biased_linear": "MLin"
+        "model_biased_linear": "MLin",
+        "stree": "STree",
+        "cache_line": "CL",
+        "exact": "Exact"
     }
     df.replace({**dataset_dict, **model_dict, **bounds_dict, **search_dict}, inplace=True)
+    layouts.replace({**dataset_dict, **model_dict, **bounds_dict, **search_dict}, inplace=True)
 
     # Compute metrics
-    df['size_in_MiB'] = df['size_in_bytes'] / (1024 * 1024)
-    df['lookup_in_ns'] = df['lookup_time'] / df['n_samples']
+    for d in [df, layouts]:
+        d['size_in_MiB'] = d['size_in_bytes'] / (1024 * 1024)
+        d['lookup_in_ns'] = d['lookup_time'] / d['n_samples']
 
     # Define variable lists
     datasets = sorted(df['dataset'].unique())
@@ -221,6 +298,10 @@ if __name__ == "__main__":
         ('LAbs','Bin'),
         ('LInd','Bin'),('LInd','MBin'),
         ('NB','MExp'),('NB','MLin'),
+        ('Adapt','Bin'),('Adapt','MBin'),
+        ('GAbs','STree'),('GInd','STree'),('NB','STree'),
+        ('LAbs','CL'),('LInd','CL'),
+        ('Exact','Bin'),('Exact','Exact'),
     ]
 
     # Set colors
@@ -250,3 +331,8 @@ if __name__ == "__main__":
         filename = 'rmi_lookup-full.pdf'
         print(f'Plotting full lookup time results to \'{filename}\'...')
         plot_full(filename)
+
+        # Plot layer2 layouts
+        filename = 'rmi_lookup-layouts.pdf'
+        print(f'Plotting lookup time by layer2 layout to \'{filename}\'...')
+        plot_layouts(filename)
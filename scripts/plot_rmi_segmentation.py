@@ -110,7 +110,11 @@ if __name__ == "__main__":
         "linear_regression": "LR",
         "linear_spline": "LS",
         "cubic_spline": "CS",
-        "radix": "RX"
+        "radix": "RX",
+        "radix_table": "RT",
+        "piecewise_cdf": "PCDF",
+        "normal": "N",
+        "lognormal": "LN"
     }
     df.replace({**dataset_dict, **model_dict}, inplace=True)
 
@@ -123,7 +127,7 @@ if __name__ == "__main__":
 
     # Set colors
     cmap = cm.get_cmap('tab20b')
-    n_colors = 5
+    n_colors = len(models)
     colors = {}
     for i, model in enumerate(models):
         colors[model] = cmap(i/n_colors+0.1)
@@ -0,0 +1,54 @@
+#!bash
+# set -x
+trap "exit" SIGINT
+
+DIR_DATA="data"
+BIN="build/bin/rmi_codegen"
+INCLUDE_PATH="build/include/rmi_gen"
+FILE_ENTRIES="${INCLUDE_PATH}/rmi_gen.hpp"
+
+DATASETS="books_200M_uint64 fb_200M_uint64 osm_cellids_200M_uint64 wiki_ts_200M_uint64"
+
+# Generate LS->LR LAbs RMIs with the layer2 sizes benchmark_rmi() in index_comparison uses for budgets of 2^k KiB
+BUDGETS_KIB="4 32 256 2048 16384"
+
+generate_rmis() {
+    DATASET=$1
+    DATA_FILE="${DIR_DATA}/${DATASET}"
+
+    echo "Generating RMIs on ${DATASET}..."
+    i=0
+    for budget in ${BUDGETS_KIB};
+    do
+        NAMESPACE="${DATASET}_${i}"
+        N_MODELS=$(( (budget * 1024 - 32) / 24 ))
+        ${BIN} ${DATA_FILE} linear_spline linear_regression ${N_MODELS} labs ${NAMESPACE} -o "${INCLUDE_PATH}/${NAMESPACE}.hpp"
+        echo "#include \"rmi_gen/${NAMESPACE}.hpp\"" >> ${FILE_ENTRIES}.tmp
+        ENTRIES="${ENTRIES}    RUN(${DATASET}, ${NAMESPACE}) \\"$'\n'
+        i=$((i+1))
+    done
+}
+
+# Check binary built
+if [ ! -x "${BIN}" ];
+then
+    >&2 echo "Please build rmi_codegen first."
+    return 1
+fi
+
+# Create include dir
+mkdir -p "${INCLUDE_PATH}"
+echo "#pragma once" > ${FILE_ENTRIES}.tmp
+echo "" >> ${FILE_ENTRIES}.tmp
+
+for dataset in ${DATASETS};
+do
+    generate_rmis "$dataset"
+done
+
+# Write list of generated RMIs, which index_comparison includes
+echo "" >> ${FILE_ENTRIES}.tmp
+echo "#define RMI_GEN_FOR_EACH(RUN) \\" >> ${FILE_ENTRIES}.tmp
+echo -n "${ENTRIES}" >> ${FILE_ENTRIES}.tmp
+echo "" >> ${FILE_ENTRIES}.tmp
+mv ${FILE_ENTRIES}.tmp ${FILE_ENTRIES}
@@ -17,10 +17,10 @@ PARAMS="--n_reps ${N_REPS} --n_samples ${N_SAMPLES}"
 
 # Set which indexes to run on datasets
 declare -A flags
-flags['books_200M_uint64']="--rmi --alex --pgm --rs --cht --art --tlx --ref --bin"
-flags['fb_200M_uint64']="--rmi --alex --pgm --rs --cht --art --tlx --ref --bin"
-flags['osm_cellids_200M_uint64']="--rmi --alex --pgm --rs --cht --art --tlx --ref --bin"
-flags['wiki_ts_200M_uint64']="--rmi --alex --pgm --rs --tlx --ref --bin" # ART and CHT do not support duplicates
+flags['books_200M_uint64']="--rmi --alex --pgm --rs --cht --art --tlx --ref --gen --bin"
+flags['fb_200M_uint64']="--rmi --alex --pgm --rs --cht --art --tlx --ref --gen --bin"
+flags['osm_cellids_200M_uint64']="--rmi --alex --pgm --rs --cht --art --tlx --ref --gen --bin"
+flags['wiki_ts_200M_uint64']="--rmi --alex --pgm --rs --tlx --ref --gen --bin" # ART and CHT do not support duplicates
 
 run() {
     DATASET=$1
@@ -42,7 +42,7 @@ then
 fi
 
 # Run experiments
-echo "dataset,n_keys,index,config,size_in_bytes,rep,n_samples,build_time,eval_time,lookup_time,eval_accu,lookup_accu" > ${FILE_RESULTS} # Write csv header
+echo "dataset,n_keys,index,config,size_in_bytes,rep,n_samples,workload,build_time,eval_time,lookup_time,eval_accu,lookup_accu" > ${FILE_RESULTS} # Write csv header
 for dataset in ${!flags[@]};
 do
     echo "Performing ${EXPERIMENT} on '${dataset}'..."
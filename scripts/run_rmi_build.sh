@@ -16,7 +16,7 @@ PARAMS="--n_reps ${N_REPS}"
 TIMEOUT="60s"
 
 DATASETS="books_200M_uint64 fb_200M_uint64 osm_cellids_200M_uint64 wiki_ts_200M_uint64"
-LAYER1="cubic_spline linear_spline linear_regression radix"
+LAYER1="cubic_spline linear_spline linear_regression radix radix_table"
 LAYER2="linear_spline linear_regression"
 BOUNDS="none gabs gind labs lind"
 
@@ -27,7 +27,7 @@ run() {
     N_MODELS=$4
     BOUND=$5
     DATA_FILE="${DIR_DATA}/${DATASET}"
-    timeout ${TIMEOUT} ${BIN} ${DATA_FILE} ${L1} ${L2} ${N_MODELS} ${BOUND} ${PARAMS} >> ${FILE_RESULTS}
+    timeout ${TIMEOUT} ${BIN} ${DATA_FILE} ${L1} ${L2} ${N_MODELS} ${BOUND} ${PARAMS} "${@:6}" >> ${FILE_RESULTS}
 }
 
 # Create results directory
@@ -66,6 +66,26 @@ do
     done
 done
 
+# Run compressed layer2 experiment
+for dataset in ${DATASETS};
+do
+    echo "Performing ${EXPERIMENT} (ours, compressed) on '${dataset}'..."
+    for ((i=6; i<=25; i += 1));
+    do
+        n_models=$((2**$i))
+        for l1 in ${LAYER1};
+        do
+            for l2 in ${LAYER2};
+            do
+                for bound in none labs;
+                do
+                    run ${dataset} ${l1} ${l2} ${n_models} ${bound} --compress
+                done
+            done
+        done
+    done
+done
+
 
 # Prepare reference implementation experiment
 CWD=$(pwd)
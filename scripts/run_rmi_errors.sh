@@ -33,11 +33,11 @@ then
 fi
 
 DATASETS="books_200M_uint64 fb_200M_uint64 osm_cellids_200M_uint64 wiki_ts_200M_uint64"
-LAYER1_MODELS="linear_spline cubic_spline linear_regression radix"
-LAYER2_MODELS="linear_spline linear_regression"
+LAYER1_MODELS="linear_spline cubic_spline linear_regression radix radix_table piecewise_cdf normal lognormal"
+LAYER2_MODELS="linear_spline linear_regression pla auto"
 
 # Run experiments
-echo "dataset,n_keys,layer1,layer2,n_models,mean_ae,median_ae,stdev_ae,min_ae,max_ae" > ${FILE_RESULTS} # Write csv header
+echo "dataset,n_keys,layer1,layer2,n_models,mean_ae,median_ae,stdev_ae,min_ae,max_ae,mean_log2_ae" > ${FILE_RESULTS} # Write csv header
 for dataset in ${DATASETS};
 do
     echo "Performing ${EXPERIMENT} on '${dataset}'..."
@@ -38,7 +38,7 @@ fi
 DATASETS="books_200M_uint64 osm_cellids_200M_uint64 wiki_ts_200M_uint64"
 
 # Run experiments
-echo "dataset,n_keys,layer1,layer2,n_models,bounds,search,size_in_bytes,rep,n_samples,budget_in_bytes,is_guideline,lookup_time,lookup_accu" > ${FILE_RESULTS} # Write csv header
+echo "dataset,n_keys,layer1,layer2,n_models,bounds,search,size_in_bytes,rep,n_samples,workload,budget_in_bytes,is_guideline,lookup_time,lookup_accu" > ${FILE_RESULTS} # Write csv header
 for dataset in ${DATASETS};
 do
     echo "Performing ${EXPERIMENT} on '${dataset}'..."
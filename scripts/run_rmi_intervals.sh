@@ -34,7 +34,7 @@ then
 fi
 
 DATASETS="books_200M_uint64 fb_200M_uint64 osm_cellids_200M_uint64 wiki_ts_200M_uint64"
-LAYERS1="linear_spline cubic_spline linear_regression radix"
+LAYERS1="linear_spline cubic_spline linear_regression radix radix_table"
 LAYERS2="linear_spline linear_regression"
 BOUNDS="gabs gind labs lind"
 
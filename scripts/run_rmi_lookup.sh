@@ -17,8 +17,8 @@ PARAMS="--n_reps ${N_REPS} --n_samples ${N_SAMPLES}"
 TIMEOUT="90s"
 
 DATASETS="books_200M_uint64 fb_200M_uint64 osm_cellids_200M_uint64 wiki_ts_200M_uint64"
-LAYER1="cubic_spline linear_spline linear_regression radix"
-LAYER2="linear_spline linear_regression"
+LAYER1="cubic_spline linear_spline linear_regression radix radix_table piecewise_cdf normal lognormal"
+LAYER2="linear_spline linear_regression pla auto"
 
 run() {
     DATASET=$1
@@ -28,7 +28,7 @@ run() {
     BOUND=$5
     SEARCH=$6
     DATA_FILE="${DIR_DATA}/${DATASET}"
-    timeout ${TIMEOUT} ${BIN} ${DATA_FILE} ${L1} ${L2} ${N_MODELS} ${BOUND} ${SEARCH} ${PARAMS} >> ${FILE_RESULTS}
+    timeout ${TIMEOUT} ${BIN} ${DATA_FILE} ${L1} ${L2} ${N_MODELS} ${BOUND} ${SEARCH} ${PARAMS} "${@:7}" >> ${FILE_RESULTS}
 }
 
 # Create results directory
@@ -45,7 +45,7 @@ then
 fi
 
 # Write csv header
-echo "dataset,n_keys,layer1,layer2,n_models,bounds,search,size_in_bytes,rep,n_samples,lookup_time,lookup_accu" > ${FILE_RESULTS} # Write csv header
+echo "dataset,n_keys,layer1,layer2,n_models,bounds,search,size_in_bytes,rep,n_samples,workload,page_size,numa,layout,lookup_mode,lookup_time,dtlb_misses,lookup_accu" > ${FILE_RESULTS} # Write csv header
 
 # Run model type experiment
 for dataset in ${DATASETS};
@@ -70,7 +70,61 @@ do
 
                 run ${dataset} ${l1} ${l2} ${n_models} lind model_biased_binary
                 run ${dataset} ${l1} ${l2} ${n_models} lind binary
+
+                run ${dataset} ${l1} ${l2} ${n_models} adaptive model_biased_binary
+                run ${dataset} ${l1} ${l2} ${n_models} adaptive binary
             done
         done
     done
+
+    # Repeat large configurations on huge pages to quantify TLB misses
+    for ((i=18; i<=25; i += 1));
+    do
+        n_models=$((2**$i))
+        for page_size in regular 2mb;
+        do
+            run ${dataset} linear_spline linear_regression ${n_models} labs binary --page_size ${page_size}
+        done
+    done
+
+    # Compare array-of-structs and struct-of-arrays layer2 under scalar and batched lookups
+    for ((i=6; i<=25; i += 1));
+    do
+        n_models=$((2**$i))
+        for layout in aos soa;
+        do
+            run ${dataset} linear_spline linear_regression ${n_models} labs binary --layout ${layout}
+            run ${dataset} linear_spline linear_regression ${n_models} labs binary --layout ${layout} --batched
+            run ${dataset} linear_spline linear_regression ${n_models} none model_biased_exponential --layout ${layout}
+            run ${dataset} linear_spline linear_regression ${n_models} none model_biased_exponential --layout ${layout} --batched
+        done
+    done
+
+    # Search the intervals of local error bounds on whole cache lines
+    for ((i=6; i<=25; i += 1));
+    do
+        n_models=$((2**$i))
+        for bound in labs lind;
+        do
+            run ${dataset} linear_spline linear_regression ${n_models} ${bound} cache_line
+        done
+    done
+
+    # Search the large intervals of global and missing error bounds on an S-tree over the keys
+    for ((i=6; i<=25; i += 1));
+    do
+        n_models=$((2**$i))
+        for bound in none gabs gind;
+        do
+            run ${dataset} linear_spline linear_regression ${n_models} ${bound} stree
+        done
+    done
+
+    # Replace the search within error bounds by exact positions of the keys of each position estimate
+    for ((i=6; i<=25; i += 1));
+    do
+        n_models=$((2**$i))
+        run ${dataset} linear_spline linear_regression ${n_models} exact binary
+        run ${dataset} linear_spline linear_regression ${n_models} exact exact
+    done
 done
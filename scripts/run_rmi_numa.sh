@@ -0,0 +1,57 @@
+#!bash
+# set -x
+trap "exit" SIGINT
+
+EXPERIMENT="rmi numa"
+
+DIR_DATA="data"
+DIR_RESULTS="results"
+FILE_RESULTS="${DIR_RESULTS}/rmi_numa.csv"
+
+BIN="build/bin/rmi_numa"
+
+# Set number of repetitions and samples
+N_REPS="3"
+N_SAMPLES="100000000"
+PARAMS="--n_reps ${N_REPS} --n_samples ${N_SAMPLES}"
+
+DATASETS="books_200M_uint64 fb_200M_uint64 osm_cellids_200M_uint64 wiki_ts_200M_uint64"
+N_THREADS=$(nproc)
+
+run() {
+    DATASET=$1
+    N_MODELS=$2
+    THREADS=$3
+    DATA_FILE="${DIR_DATA}/${DATASET}"
+    ${BIN} ${DATA_FILE} ${N_MODELS} --n_threads ${THREADS} ${PARAMS} >> ${FILE_RESULTS}
+}
+
+# Create results directory
+if [ ! -d "${DIR_RESULTS}" ];
+then
+    mkdir -p "${DIR_RESULTS}";
+fi
+
+# Check data downloaded
+if [ ! -d "${DIR_DATA}" ];
+then
+    >&2 echo "Please download datasets first."
+    return 1
+fi
+
+# Write csv header
+echo "dataset,n_keys,n_models,mode,size_in_bytes,n_nodes,n_threads,rep,n_samples,workload,lookup_time,lookup_accu" > ${FILE_RESULTS}
+
+# Run numa experiment
+for dataset in ${DATASETS};
+do
+    echo "Performing ${EXPERIMENT} on '${dataset}'..."
+    for ((i=16; i<=24; i += 4));
+    do
+        n_models=$((2**$i))
+        for ((t=1; t<=${N_THREADS}; t *= 2));
+        do
+            run ${dataset} ${n_models} ${t}
+        done
+    done
+done
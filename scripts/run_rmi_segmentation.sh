@@ -32,7 +32,7 @@ then
 fi
 
 DATASETS="books_200M_uint64 fb_200M_uint64 osm_cellids_200M_uint64 wiki_ts_200M_uint64"
-MODELS="linear_spline cubic_spline linear_regression radix"
+MODELS="linear_spline cubic_spline linear_regression radix radix_table piecewise_cdf normal lognormal"
 
 # Run experiments
 echo "dataset,n_keys,model,n_segments,mean,stdev,median,min,max,n_empty" > ${FILE_RESULTS} # Write csv header
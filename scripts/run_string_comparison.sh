@@ -0,0 +1,42 @@
+#!bash
+# set -x
+trap "exit" SIGINT
+
+EXPERIMENT="string comparison"
+
+DIR_RESULTS="results"
+FILE_RESULTS="${DIR_RESULTS}/string_comparison.csv"
+
+BIN="build/bin/string_comparison"
+
+# Set number of keys, repetitions, and samples
+N_KEYS="50000000"
+N_REPS="3"
+N_SAMPLES="20000000"
+PARAMS="--n_keys ${N_KEYS} --n_reps ${N_REPS} --n_samples ${N_SAMPLES}"
+
+DATASETS="urls emails"
+WORKLOADS="uniform absent"
+
+run() {
+    DATASET=$1
+    WORKLOAD=$2
+    ${BIN} ${PARAMS} --workload ${WORKLOAD} --rmi --art --tlx --bin ${DATASET} >> ${FILE_RESULTS}
+}
+
+# Create results directory
+if [ ! -d "${DIR_RESULTS}" ];
+then
+    mkdir -p "${DIR_RESULTS}";
+fi
+
+# Run experiments
+echo "dataset,n_keys,index,config,size_in_bytes,rep,n_samples,workload,build_time,lookup_time,lookup_accu" > ${FILE_RESULTS} # Write csv header
+for dataset in ${DATASETS};
+do
+    for workload in ${WORKLOADS};
+    do
+        echo "Performing ${EXPERIMENT} on '${dataset}' with '${workload}' lookups..."
+        run ${dataset} ${workload}
+    done
+done